@@ -0,0 +1,60 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_ALLOCATOR_H
+#define JSOP_ALLOCATOR_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include "JsopDefines.h"
+
+//! Functions that allocate the memory of the memory pools, stacks and buffers, which can be replaced to allocate the memory from an
+//! arena, a NUMA node or huge pages
+//! The memory must be aligned for any type like the memory from malloc(), and the allocator must outlive the objects that use it
+struct JsopAllocator {
+	//! Allocates n bytes, and returns nullptr if the memory cannot be allocated
+	void *(*Allocate)(void *context, size_t n);
+	//! Resizes the memory of n bytes at p to new_n bytes and keeps its contents, or returns nullptr and keeps the memory if it cannot be
+	//! resized
+	//! Can be nullptr, in which case new memory is allocated and the contents are copied
+	void *(*Reallocate)(void *context, void *p, size_t n, size_t new_n);
+	//! Releases the memory of n bytes at p
+	//! Can be nullptr if the memory is released all at once by the owner of the allocator (such as an arena that is reset after each
+	//! request), in which case the memory pools are not walked to release them
+	void (*Release)(void *context, void *p, size_t n);
+	//! Passed to the functions
+	void *Context;
+};
+
+//! The allocator that uses malloc(), realloc() and free(), which is used by default
+extern const JsopAllocator jsop_malloc_allocator;
+
+JSOP_INLINE void *jsop_allocate(const JsopAllocator *allocator, size_t n) noexcept {
+	return allocator->Allocate(allocator->Context, n);
+}
+
+JSOP_INLINE void jsop_release(const JsopAllocator *allocator, void *p, size_t n) noexcept {
+	if (p != nullptr && allocator->Release != nullptr) {
+		allocator->Release(allocator->Context, p, n);
+	}
+}
+
+//! Resizes the memory of n bytes at p, or allocates new_n bytes if p is nullptr
+JSOP_INLINE void *jsop_reallocate(const JsopAllocator *allocator, void *p, size_t n, size_t new_n) noexcept {
+	if (p == nullptr) {
+		return jsop_allocate(allocator, new_n);
+	} else if (allocator->Reallocate != nullptr) {
+		return allocator->Reallocate(allocator->Context, p, n, new_n);
+	}
+
+	auto new_p = jsop_allocate(allocator, new_n);
+	if (new_p != nullptr) {
+		memcpy(new_p, p, n < new_n ? n : new_n);
+		jsop_release(allocator, p, n);
+	}
+	return new_p;
+}
+
+#endif
@@ -6,6 +6,7 @@
 #define JSOP_CODE_POINT_H
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "JsopDefines.h"
@@ -37,4 +38,31 @@ JSOP_INLINE bool jsop_code_point_is_normal_ascii_string_char(unsigned char codep
 	return JsopCodePointASCIIBitset[codepoint];
 }
 
+//! Gets the length of the valid UTF-8 sequence (which is not a single ASCII char) at the start of the given string, or 0 if it is not valid
+JSOP_INLINE size_t jsop_code_point_utf8_sequence_length(const unsigned char *start, const unsigned char *end) noexcept {
+	size_t n = end - start;
+	unsigned ch = start[0];
+
+	if (ch >= 0xC2 && ch <= 0xDF) {
+		if (n >= 2 && (start[1] & 0xC0) == 0x80) {
+			return 2;
+		}
+	} else if (ch >= 0xE0 && ch <= 0xEF) {
+		//Reject overlong sequences and surrogates
+		unsigned min_trail = ch == 0xE0 ? 0xA0 : 0x80;
+		unsigned max_trail = ch == 0xED ? 0x9F : 0xBF;
+		if (n >= 3 && start[1] >= min_trail && start[1] <= max_trail && (start[2] & 0xC0) == 0x80) {
+			return 3;
+		}
+	} else if (ch >= 0xF0 && ch <= 0xF4) {
+		//Reject overlong sequences and code points above 0x10FFFF
+		unsigned min_trail = ch == 0xF0 ? 0x90 : 0x80;
+		unsigned max_trail = ch == 0xF4 ? 0x8F : 0xBF;
+		if (n >= 4 && start[1] >= min_trail && start[1] <= max_trail && (start[2] & 0xC0) == 0x80 && (start[3] & 0xC0) == 0x80) {
+			return 4;
+		}
+	}
+	return 0;
+}
+
 #endif
@@ -5,11 +5,54 @@
 #ifndef JSOP_DECIMAL_H
 #define JSOP_DECIMAL_H
 
+#include <stddef.h>
 #include <stdint.h>
+#include <string.h>
+
+#include "JsopDefines.h"
+
+//! Largest integer that can be multiplied by 10^8 and added to an 8 digit number without overflowing 64 bits
+#define JSOP_DECIMAL_EIGHT_DIGITS_MAX_INTEGER UINT64_C(184467440736)
+
+//! Converts the 8 characters at the given pointer to an integer if they are all decimal digits, and returns false otherwise
+JSOP_INLINE bool jsop_decimal_parse_eight_digits(const char *start, uint32_t *value) noexcept {
+	uint64_t chars;
+
+	memcpy(&chars, start, sizeof(chars));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	chars = __builtin_bswap64(chars);
+#endif
+
+	//Every byte is a digit if its upper half is 3, and adding 6 to its lower half does not carry into the upper half
+	if (((chars & UINT64_C(0xF0F0F0F0F0F0F0F0)) | (((chars + UINT64_C(0x0606060606060606)) & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4)) != UINT64_C(0x3333333333333333)) {
+		return false;
+	}
+
+	//Combine adjacent digits into 2 digit numbers, then 4 digit numbers and finally the 8 digit number, where the first character is in
+	//the lowest byte and is the most significant digit
+	chars -= UINT64_C(0x3030303030303030);
+	chars = chars * 10 + (chars >> 8);
+	chars = (((chars & UINT64_C(0x000000FF000000FF)) * (100 + (UINT64_C(1000000) << 32))) +
+		(((chars >> 16) & UINT64_C(0x000000FF000000FF)) * (1 + (UINT64_C(10000) << 32)))) >> 32;
+	*value = static_cast<uint32_t>(chars);
+	return true;
+}
 
 //! Converts the specified integer significand and exponent (of 10) to a double precision number
 double jsop_decimal_to_double(uint64_t significand, int exponent, bool negative) noexcept;
 
+//! Maximum number of digits after the significand that jsop_long_decimal_to_double() computes exactly, where any further digits are only
+//! checked for being non-zero (which is enough as the halfway points between double precision numbers have fewer significant digits)
+#define JSOP_LONG_DECIMAL_MAX_DIGITS 800
+
+//! Converts a number with more significant digits than fit in the integer significand to the correctly rounded double precision number
+//! The value is (significand + 0.d1 d2 ... dn) * 10^exponent, where the n digits are the characters '0' to '9'
+double jsop_long_decimal_to_double(uint64_t significand, const char *digits, size_t n, int exponent, bool negative) noexcept;
+
+//! Converts the given finite double precision number (ignoring its sign) to the shortest integer significand and exponent (of 10) that
+//! jsop_decimal_to_double() converts back to the same number, where the significand has at most 17 digits and is 0 for zero
+uint64_t jsop_double_to_decimal(double value, int *exponent) noexcept;
+
 //! Converts the specified integer significand and exponent (of 2) to a double precision number
 double jsop_hexadecimal_to_double(uint64_t significand, int exponent, bool negative) noexcept;
 
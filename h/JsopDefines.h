@@ -5,6 +5,12 @@
 #ifndef JSOP_DEFINES_H
 #define JSOP_DEFINES_H
 
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 #ifndef JSOP_WORD_SIZE
 	#if defined(__LP64__) || defined(_WIN64)
 		#define JSOP_WORD_SIZE 64
@@ -29,6 +35,62 @@
 #define JSOP_EVENT_HANDLER_STACK_MIN_SIZE 256
 #endif
 
+#ifndef JSOP_STRUCTURAL_INDEX_MIN_SIZE
+#define JSOP_STRUCTURAL_INDEX_MIN_SIZE 65536
+#endif
+
+#ifndef JSOP_WRITER_BUFFER_MIN_SIZE
+#define JSOP_WRITER_BUFFER_MIN_SIZE 65536
+#endif
+
+#ifndef JSOP_WRITER_STACK_MIN_SIZE
+#define JSOP_WRITER_STACK_MIN_SIZE 64
+#endif
+
+#ifndef JSOP_VALIDATOR_STACK_MIN_SIZE
+#define JSOP_VALIDATOR_STACK_MIN_SIZE 64
+#endif
+
+//Number of buffers filled in turn by JsopPackedFile while a separate thread writes the full ones (see setAsyncWrites(), which is only
+//available when JSOP_PACKED_FILE_ASYNC_WRITES is defined)
+#ifndef JSOP_PACKED_FILE_ASYNC_BUFFERS
+#define JSOP_PACKED_FILE_ASYNC_BUFFERS 4
+#endif
+
+//Initial number of slots (a power of 2) and maximum number of strings of the tables of repeated strings
+#ifndef JSOP_STRING_TABLE_MIN_SIZE
+#define JSOP_STRING_TABLE_MIN_SIZE 256
+#endif
+
+#ifndef JSOP_STRING_TABLE_MAX_SIZE
+#define JSOP_STRING_TABLE_MAX_SIZE 16384
+#endif
+
+//Objects with at least this number of keys are stored with a hash index of their keys, which is used by JsopObjectView::find()
+#ifndef JSOP_OBJECT_INDEX_MIN_SIZE
+#define JSOP_OBJECT_INDEX_MIN_SIZE 32
+#endif
+
+//Initial number of slots (a power of 2) of the table of the arrays and objects that have grown in a JsopMutableDocument, and the minimum
+//number of values (or pairs) of those arrays and objects
+#ifndef JSOP_MUTABLE_DOCUMENT_TABLE_MIN_SIZE
+#define JSOP_MUTABLE_DOCUMENT_TABLE_MIN_SIZE 64
+#endif
+
+#ifndef JSOP_MUTABLE_DOCUMENT_BLOCK_MIN_SIZE
+#define JSOP_MUTABLE_DOCUMENT_BLOCK_MIN_SIZE 4
+#endif
+
+#ifndef JSOP_MUTABLE_DOCUMENT_STACK_MIN_SIZE
+#define JSOP_MUTABLE_DOCUMENT_STACK_MIN_SIZE 64
+#endif
+
+//Number of readable bytes that must follow the input passed to parsePadded(), which allows the scanning functions to load whole vectors
+//without checking for the end of the input
+#ifndef JSOP_INPUT_PADDING
+#define JSOP_INPUT_PADDING 64
+#endif
+
 #define JSOP_PARSE_COMMENT
 #define JSOP_PARSE_UTF8_BYTE_ORDER_MARK
 #define JSOP_PARSE_TRAILING_COMMA
@@ -43,6 +105,18 @@
 #define JSOP_PARSE_VERTICAL_TAB_ESCAPE
 
 #define JSOP_PARSE_STRING_MULTI_BYTE_COPY
+
+//Number of bytes scanned at a time when copying strings, which can be 64 (AVX-512BW), 32 (AVX2), 16 (SSE2) or 0 (word sized scan)
+//64 must be defined explicitly, since AVX-512BW is slower than AVX2 on short strings and barely faster on long ones
+#ifndef JSOP_PARSE_STRING_SIMD_WIDTH
+	#if defined(__AVX2__)
+		#define JSOP_PARSE_STRING_SIMD_WIDTH 32
+	#elif defined(__SSE2__)
+		#define JSOP_PARSE_STRING_SIMD_WIDTH 16
+	#else
+		#define JSOP_PARSE_STRING_SIMD_WIDTH 0
+	#endif
+#endif
 #define JSOP_PARSE_UNQUOTED_KEY_MULTI_BYTE_COPY
 
 #define JSOP_USE_FP_MATH
@@ -63,4 +137,22 @@
 #define JSOP_UNLIKELY(x) __builtin_expect(static_cast<bool>(x), false)
 #endif
 
+//! Counts the number of zero bits below the lowest set bit of the given value (which cannot be zero)
+JSOP_INLINE unsigned jsop_count_trailing_zeros(uint64_t value) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+	unsigned long index;
+	#if defined(_M_X64) || defined(_M_ARM64)
+		_BitScanForward64(&index, value);
+	#else
+		if (!_BitScanForward(&index, static_cast<uint32_t>(value))) {
+			_BitScanForward(&index, static_cast<uint32_t>(value >> 32));
+			index += 32;
+		}
+	#endif
+	return static_cast<unsigned>(index);
+#else
+	return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
 #endif
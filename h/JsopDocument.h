@@ -5,8 +5,10 @@
 #ifndef JSOP_DOCUMENT_H
 #define JSOP_DOCUMENT_H
 
+#include <stddef.h>
 #include <stdlib.h>
 
+#include "JsopAllocator.h"
 #include "JsopMemoryPools.h"
 
 class JsopValue;
@@ -14,14 +16,22 @@ class JsopValue;
 //! Represents a hierarchy of values with a single top level value
 class JsopDocument final {
 	friend class JsopDocumentHandler;
+	friend class JsopMutableDocument;
 
 	JsopMemoryPools Pools;
 	JsopValue *Value = nullptr;
+	//! Number of bytes of the memory of the top level value, which may be reused by JsopDocumentHandler::finish()
+	size_t Capacity = 0;
+	void *Input = nullptr;
+	void (*ReleaseInput)(void *) = nullptr;
 
 public:
 	JsopDocument() = default;
 	~JsopDocument() noexcept {
-		free(Value);
+		jsop_release(Pools.getAllocator(), Value, Capacity);
+		if (ReleaseInput != nullptr) {
+			ReleaseInput(Input);
+		}
 	}
 
 	JsopDocument(const JsopDocument &) = delete;
@@ -31,6 +41,16 @@ public:
 	const JsopValue &get() const noexcept {
 		return *Value;
 	}
+
+	//! Takes the ownership of the input that strings are borrowed from (see JsopDocumentHandler::setBorrowInput()), which is released
+	//! with the given function when the document is destroyed or another input is adopted
+	void adoptInput(void *input, void (*release_input)(void *) = free) noexcept {
+		if (ReleaseInput != nullptr) {
+			ReleaseInput(Input);
+		}
+		Input = input;
+		ReleaseInput = release_input;
+	}
 };
 
 #endif
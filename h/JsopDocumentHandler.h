@@ -10,8 +10,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "JsopAllocator.h"
 #include "JsopDefines.h"
 #include "JsopMemoryPools.h"
+#include "JsopStringTable.h"
 #include "JsopValue.h"
 
 class JsopDocument;
@@ -19,13 +21,34 @@ class JsopDocument;
 //! Parser handler to generate the results as a document
 class JsopDocumentHandler {
 	JsopMemoryPools Pools;
+	JsopStringTable<JsopValue> Strings;
 	JsopValue *StackStart = nullptr;
 	JsopValue *StackEnd = nullptr;
 	JsopValue *StackAllocEnd = nullptr;
 	size_t PrevStackSize = 0;
+	uint32_t *SortStart = nullptr;
+	size_t SortCapacity = 0;
+	size_t InternValueMaxSize = 0;
+	bool BorrowInput = false;
+	bool LazyNumbers = false;
+	bool SortKeys = false;
+	bool IndexObjects = false;
+	bool InternKeys = false;
+	bool ReuseDocument = false;
 
 	JsopValue *resizeStack() noexcept;
 
+	//! Copies the key value pairs of an object to a new memory block followed by the hash index of their keys, and returns the copy or
+	//! nullptr on error
+	JsopValue *makeIndexedObject(const JsopValue *values, size_t n) noexcept;
+
+	//! Copies the key value pairs of an object to a new memory block in the order of their keys followed by their insertion order, and
+	//! returns the copy or nullptr on error
+	JsopValue *makeSortedObject(const JsopValue *values, size_t n) noexcept;
+
+	//! Makes a string that shares the copy of an identical string made earlier, or makes a copy and adds it to the table of strings
+	bool makeInternedString(JsopValue *new_value, const char *start, size_t n) noexcept;
+
 	//! Creates a value and push it to the stack
 	//! The caller must initialize the value returned
 	JSOP_INLINE JsopValue *makeValue() noexcept {
@@ -47,7 +70,8 @@ public:
 
 	JsopDocumentHandler() = default;
 	JSOP_INLINE ~JsopDocumentHandler() noexcept {
-		free(StackStart);
+		jsop_release(Pools.getAllocator(), StackStart, (StackAllocEnd - StackStart) * sizeof(JsopValue));
+		jsop_release(Pools.getAllocator(), SortStart, SortCapacity * sizeof(uint32_t));
 	}
 
 	JsopDocumentHandler(const JsopDocumentHandler &) = delete;
@@ -59,6 +83,66 @@ public:
 		return false;
 	}
 
+	//! Check if strings can be passed to makeInputString() and makeInSituString() as pointers to the input
+	bool useInputStrings() const noexcept {
+		return true;
+	}
+
+	//! Sets whether long strings without escape sequences refer to the input instead of being copied, in which case the input must stay
+	//! valid until the document is destroyed (see JsopDocument::adoptInput())
+	void setBorrowInput(bool value) noexcept {
+		BorrowInput = value;
+	}
+
+	//! Check if numbers with a fractional part or an exponent are passed to makeDecimal() instead of being converted for makeDouble()
+	bool useLazyNumbers() const noexcept {
+		return LazyNumbers;
+	}
+
+	//! Sets whether numbers with a fractional part or an exponent are stored as their significand and exponent, and only converted to
+	//! double precision numbers when JsopValue::getDouble() or JsopValue::toDouble() is called
+	void setLazyNumbers(bool value) noexcept {
+		LazyNumbers = value;
+	}
+
+	//! Sets whether the pairs of each object are sorted by the bytes of their keys, so JsopObjectView::find() uses a binary search instead
+	//! of a hash index, and objects can be merged in a single pass
+	//! The order that the pairs were parsed in is available from JsopObjectView::getInsertionOrder()
+	void setSortKeys(bool value) noexcept {
+		SortKeys = value;
+	}
+
+	//! Sets whether objects with at least JSOP_OBJECT_INDEX_MIN_SIZE keys are followed by a hash index of their keys, so
+	//! JsopObjectView::find() does not compare the key with every key of the object
+	//! Every object then has the type JsopValue::IndexedObjectType, and smaller objects get an index if they grow in a JsopMutableDocument
+	//! The index is built when the object is parsed, which takes more time and memory, and is not used if the keys are sorted
+	void setIndexObjects(bool value) noexcept {
+		IndexObjects = value;
+	}
+
+	//! Sets whether keys that are copied share a single copy with the identical keys before them in the same document, so repeated
+	//! keys are only allocated once and have the same c_str()
+	void setInternKeys(bool value) noexcept {
+		InternKeys = value;
+	}
+
+	//! Sets the maximum size of the strings other than keys that share a single copy with the identical strings before them, or 0 to
+	//! copy all of them
+	void setInternValues(size_t max_size) noexcept {
+		InternValueMaxSize = max_size;
+	}
+
+	//! Sets whether finish() exchanges the stack and memory pools with those of the document instead of shrinking the stack to the size of
+	//! the values, so parsing into the same document again reuses the memory of its previous values once it is large enough
+	//! The memory is kept until the handler and the document are destroyed
+	void setReuseDocument(bool value) noexcept {
+		ReuseDocument = value;
+	}
+
+	//! Sets the allocator of the stack and the memory pools, which releases the memory allocated by the previous allocator
+	//! The documents that the values are moved into release them with the same allocator
+	void setAllocator(const JsopAllocator *allocator) noexcept;
+
 	//! Initializes the parsing
 	bool start() noexcept;
 	//! Finish the parsing by moving the parsed values into the given document
@@ -66,7 +150,12 @@ public:
 	//! Frees memory allocated for the parsed values
 	//! Does not clear the stack as it can be used for subsequent parses
 	void cleanup() noexcept {
-		Pools.clear();
+		Strings.clear();
+		if (ReuseDocument) {
+			Pools.reset();
+		} else {
+			Pools.clear();
+		}
 	}
 
 	//! Checks if it is parsing a value at the top level
@@ -156,6 +245,28 @@ public:
 		return false;
 	}
 
+	//! Makes a number with the given significand and exponent (of 10), which is converted to a double precision number when it is accessed
+	JSOP_INLINE bool makeDecimal(uint64_t significand, int exponent, bool negative) noexcept {
+		auto new_value = makeValue();
+		if (new_value != nullptr) {
+#if JSOP_WORD_SIZE == 64
+			new_value->setDecimal(significand, exponent, negative);
+			return true;
+#else
+			auto new_decimal = Pools.alloc<JsopValue::DecimalNumber>();
+			if (new_decimal != nullptr) {
+				new_decimal->Significand = significand;
+				new_decimal->Exponent = exponent;
+				new_decimal->Negative = negative;
+				new_value->setDecimal(new_decimal);
+				return true;
+			}
+			new_value->setNull();
+#endif
+		}
+		return false;
+	}
+
 	//! Makes a null-terminated string indicated by the (start, end) pair
 	JSOP_INLINE bool makeString(const char *start, const char *end) noexcept {
 		JsopValue *new_value;
@@ -187,10 +298,56 @@ public:
 		}
 		return false;
 	}
-	JSOP_INLINE bool makeString(const char *start, const char *end, bool) noexcept {
+	JSOP_INLINE bool makeString(const char *start, const char *end, bool key) noexcept {
+		size_t n = end - start;
+		if (JSOP_UNLIKELY(key ? InternKeys : n <= InternValueMaxSize) && n >= (sizeof(JsopValue) - sizeof(JsopValue::SmallString::size_type))) {
+			auto new_value = makeValue();
+			return new_value != nullptr && makeInternedString(new_value, start, n);
+		}
 		return makeString(start, end);
 	}
 
+	//! Makes a string indicated by the (start, end) pair in the input, which is not null-terminated but at least 16 characters can be read
+	//! from start
+	JSOP_INLINE bool makeInputString(const char *start, const char *end, bool key) noexcept {
+		static_assert(sizeof(JsopValue) <= 16, "sizeof(JsopValue) <= 16");
+
+		size_t n = end - start;
+		if (!BorrowInput || n < (sizeof(JsopValue) - sizeof(JsopValue::SmallString::size_type))) {
+			return makeString(start, end, key);
+		}
+
+		auto new_value = makeValue();
+		if (new_value != nullptr) {
+			if (JSOP_LIKELY(n <= JsopValue::MAX_SIZE)) {
+				new_value->setBorrowedString(n, start);
+				return true;
+			}
+			new_value->setNull();
+		}
+		return false;
+	}
+
+	//! Makes a null-terminated string indicated by the (start, end) pair in the input of JsopParser::parseInSitu(), where at least 16
+	//! characters can be read from start
+	//! Long strings refer to the input, which must stay valid until the document is destroyed
+	JSOP_INLINE bool makeInSituString(char *start, char *end, bool) noexcept {
+		size_t n = end - start;
+		if (n < (sizeof(JsopValue) - sizeof(JsopValue::SmallString::size_type))) {
+			return makeString(start, end);
+		}
+
+		auto new_value = makeValue();
+		if (new_value != nullptr) {
+			if (JSOP_LIKELY(n <= JsopValue::MAX_SIZE)) {
+				new_value->setString(n, start);
+				return true;
+			}
+			new_value->setNull();
+		}
+		return false;
+	}
+
 	//! Makes a new array, and push the context to add subsequent values to the array
 	JSOP_INLINE bool pushArray() noexcept {
 		auto new_value = makeValue();
@@ -262,8 +419,30 @@ public:
 			if (new_object_size <= JsopValue::MAX_SIZE) {
 				new_values = nullptr;
 				auto stack_size = values_start[-1].getStackSize();
+				if (JSOP_UNLIKELY(SortKeys) && new_object_size <= UINT32_MAX) {
+					//Empty objects are also sorted, so they stay sorted when pairs are added to them later
+					if (n > 0) {
+						new_values = makeSortedObject(values_start, new_object_size);
+						if (new_values == nullptr) {
+							return false;
+						}
+						StackEnd = values_start;
+					}
+					PrevStackSize = stack_size;
+					values_start[-1].setSortedObject(new_values, new_object_size);
+					return true;
+				}
 				if (JSOP_LIKELY(n > 0)) {
-					if (JSOP_LIKELY(stack_size > 0)) {
+					if (JSOP_UNLIKELY(IndexObjects) && JsopObjectView::hasIndex(new_object_size)) {
+						new_values = makeIndexedObject(values_start, new_object_size);
+						if (new_values == nullptr) {
+							return false;
+						}
+						StackEnd = values_start;
+						PrevStackSize = stack_size;
+						values_start[-1].setIndexedObject(new_values, new_object_size);
+						return true;
+					} else if (JSOP_LIKELY(stack_size > 0)) {
 						new_values = Pools.alloc<JsopValue>(n);
 						if (new_values != nullptr) {
 							memcpy(new_values, values_start, sizeof(JsopValue) * n);
@@ -276,7 +455,12 @@ public:
 					}
 				}
 				PrevStackSize = stack_size;
-				values_start[-1].setObject(new_values, new_object_size);
+				//Smaller objects have no index yet, but are still indexed so that JsopMutableDocument adds one once they have enough keys
+				if (JSOP_UNLIKELY(IndexObjects)) {
+					values_start[-1].setIndexedObject(new_values, new_object_size);
+				} else {
+					values_start[-1].setObject(new_values, new_object_size);
+				}
 				return true;
 			}
 		}
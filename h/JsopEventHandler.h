@@ -9,8 +9,9 @@
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
-#include <stdlib.h>
 
+#include "JsopAllocator.h"
+#include "JsopDecimal.h"
 #include "JsopDefines.h"
 
 //! Base class for event driven parser handler that use a simple context stack for array/object
@@ -19,6 +20,7 @@ class JsopEventHandler {
 	size_t *End;
 	size_t *AllocEnd;
 	size_t Mask;
+	const JsopAllocator *Allocator;
 
 	static_assert(JSOP_EVENT_HANDLER_STACK_MIN_SIZE % sizeof(*Start) == 0, "JSOP_EVENT_HANDLER_STACK_MIN_SIZE % sizeof(*Start) == 0");
 
@@ -53,14 +55,14 @@ public:
 		NoExceptions = true
 	};
 
-	JsopEventHandler() noexcept {
-		Start = static_cast<size_t *>(malloc(JSOP_EVENT_HANDLER_STACK_MIN_SIZE));
+	JsopEventHandler() noexcept : Allocator(&jsop_malloc_allocator) {
+		Start = static_cast<size_t *>(jsop_allocate(Allocator, JSOP_EVENT_HANDLER_STACK_MIN_SIZE));
 		End = Start;
 		AllocEnd = Start + JSOP_EVENT_HANDLER_STACK_MIN_SIZE / sizeof(*Start);
 		Mask = 0;
 	}
 	~JsopEventHandler() noexcept {
-		free(Start);
+		jsop_release(Allocator, Start, (AllocEnd - Start) * sizeof(*Start));
 	}
 
 	JsopEventHandler(const JsopEventHandler &) = delete;
@@ -71,6 +73,28 @@ public:
 		return false;
 	}
 
+	//! Check if strings can be passed to makeInputString() and makeInSituString() as pointers to the input
+	bool useInputStrings() const noexcept {
+		//Derived handlers only need to override makeString()
+		return false;
+	}
+
+	//! Check if numbers with a fractional part or an exponent are passed to makeDecimal() instead of being converted for makeDouble()
+	bool useLazyNumbers() const noexcept {
+		//Derived handlers only need to override makeDouble()
+		return false;
+	}
+
+	//! Replaces the context stack with one from the given allocator
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Allocator, Start, (AllocEnd - Start) * sizeof(*Start));
+		Allocator = allocator;
+		Start = static_cast<size_t *>(jsop_allocate(allocator, JSOP_EVENT_HANDLER_STACK_MIN_SIZE));
+		End = Start;
+		AllocEnd = Start + JSOP_EVENT_HANDLER_STACK_MIN_SIZE / sizeof(*Start);
+		Mask = 0;
+	}
+
 	//! Initialize the parsing
 	bool start() noexcept {
 		End = Start;
@@ -118,10 +142,27 @@ public:
 		return true;
 	}
 
+	//! Makes a number with the given significand and exponent (of 10)
+	bool makeDecimal(uint64_t significand, int exponent, bool negative) noexcept {
+		return makeDouble(jsop_decimal_to_double(significand, exponent, negative));
+	}
+
 	bool makeString(const char *start, const char *end, bool key) noexcept {
 		return true;
 	}
 
+	//! Makes a string indicated by the (start, end) pair in the input, which is not null-terminated but at least 16 characters can be read
+	//! from start
+	bool makeInputString(const char *start, const char *end, bool key) noexcept {
+		return makeString(start, end, key);
+	}
+
+	//! Makes a null-terminated string indicated by the (start, end) pair in the input of JsopParser::parseInSitu(), where at least 16
+	//! characters can be read from start
+	bool makeInSituString(char *start, char *end, bool key) noexcept {
+		return makeString(start, end, key);
+	}
+
 	//! Push an array to the context stack
 	JSOP_INLINE bool pushArray() noexcept {
 		if (push()) {
@@ -0,0 +1,39 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_HASH_H
+#define JSOP_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "JsopDefines.h"
+
+//! Computes the hash of the given string, 8 characters at a time, where all the bits of the result depend on every character
+JSOP_INLINE uint64_t jsop_hash_string(const char *s, size_t n) noexcept {
+	uint64_t h, w;
+
+	h = UINT64_C(0x9E3779B97F4A7C15) ^ static_cast<uint64_t>(n);
+	while (n >= sizeof(w)) {
+		memcpy(&w, s, sizeof(w));
+		h = (h ^ w) * UINT64_C(0xBF58476D1CE4E5B9);
+		h ^= h >> 29;
+		s += sizeof(w);
+		n -= sizeof(w);
+	}
+	if (n > 0) {
+		w = 0;
+		memcpy(&w, s, n);
+		h = (h ^ w) * UINT64_C(0xBF58476D1CE4E5B9);
+		h ^= h >> 29;
+	}
+
+	//Mix the high bits into the low bits, which are used to select the slot of a hash table
+	h *= UINT64_C(0x94D049BB133111EB);
+	h ^= h >> 32;
+	return h;
+}
+
+#endif
@@ -0,0 +1,543 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_INDEX_PARSER_H
+#define JSOP_INDEX_PARSER_H
+
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <utility>
+
+#include "JsopDecimal.h"
+#include "JsopDefines.h"
+#include "JsopDocumentHandler.h"
+#include "JsopSimd.h"
+#include "JsopStringBuffer.h"
+#include "JsopStructuralIndex.h"
+#include "JsopUnescape.h"
+
+//! A JSON parser that first builds an index of the structural characters of the whole string, and then creates the values by walking
+//! through the index
+//! Only standard JSON is accepted, along with trailing commas, the UTF-8 byte order mark, Infinity and NaN and the string escape sequences
+//! that are enabled for JsopParser, but not comments, binary or hexadecimal numbers and unquoted keys
+template <typename H = JsopDocumentHandler>
+class JsopIndexParser final : public H {
+	JsopStructuralIndex Index;
+	JsopStringBuffer Buffer;
+	bool Parsed;
+	bool Padded;
+
+	//! Makes a string from the characters between the quotes, which are passed directly from the input if there are no escape sequences,
+	//! or copied to the buffer as the escape sequences are replaced
+	JSOP_INLINE bool makeString(const char *start, const char *end, const char *input_end, bool key) noexcept(H::NoExceptions) {
+		if (H::useInputStrings() && (Padded || input_end - start >= 16) && jsop_skip_unescaped_string_chars(start, end, Padded) == end) {
+			return H::makeInputString(start, end, key);
+		}
+
+		Buffer.clear();
+		if (Buffer.reserve(end - start + 1)) {
+			auto new_end = jsop_unescape_string(Buffer.getEnd(), start, end);
+			if (new_end != nullptr) {
+				Buffer.setEnd(new_end);
+				return (!H::requireNullTerminator() || Buffer.append('\0')) && H::makeString(Buffer.getStart(), Buffer.getEnd(), key);
+			}
+		}
+		return false;
+	}
+
+	//! Appends 8 digits at a time to the integer while there are enough characters left and the integer cannot overflow, and returns the
+	//! character after the converted digits
+	static JSOP_INLINE const char *parseEightDigits(const char *start, const char *end, uint64_t *integer) noexcept {
+		uint32_t eight_digits;
+
+		while (end - start >= 8) {
+#ifndef JSOP_IGNORE_OVERFLOW
+			if (*integer > JSOP_DECIMAL_EIGHT_DIGITS_MAX_INTEGER) {
+				break;
+			}
+#endif
+			if (!jsop_decimal_parse_eight_digits(start, &eight_digits)) {
+				break;
+			}
+			*integer = *integer * 100000000 + eight_digits;
+			start += 8;
+		}
+		return start;
+	}
+
+#ifndef JSOP_IGNORE_OVERFLOW
+	//! Copies the digits that do not fit in the integer to the buffer (without the decimal point), and returns the character after
+	//! them or nullptr on error, where the exponent is increased by the number of digits before the decimal point
+	//! The digits past the maximum are only recorded as being non-zero in the last digit
+	const char *appendLongDigits(const char *start, const char *end, bool fractional, int *exponent) noexcept {
+		Buffer.clear();
+		for (; start != end; ++start) {
+			auto ch = *start;
+			if (static_cast<unsigned>(ch) - '0' < 10) {
+				if (!fractional) {
+					*exponent += 1;
+				}
+				if (static_cast<size_t>(Buffer.getEnd() - Buffer.getStart()) <= JSOP_LONG_DECIMAL_MAX_DIGITS) {
+					if (!Buffer.append(ch)) {
+						return nullptr;
+					}
+				} else if (ch != '0') {
+					Buffer.getEnd()[-1] = '1';
+				}
+			} else if (ch == '.' && !fractional) {
+				fractional = true;
+			} else {
+				break;
+			}
+		}
+		return start;
+	}
+#endif
+
+	//! Makes a number, literal, infinity or NaN value from the given characters (without leading whitespace)
+	bool makeScalar(const char *start, const char *end) noexcept(H::NoExceptions);
+
+	//! Checks whether the given characters are exactly the given literal
+	static JSOP_INLINE bool matchLiteral(const char *start, const char *end, const char *literal, size_t n) noexcept {
+		return static_cast<size_t>(end - start) == n && memcmp(start, literal, n) == 0;
+	}
+
+public:
+	template <typename ... A>
+	JSOP_INLINE JsopIndexParser(A && ... args) noexcept(H::NoExceptions) : H(std::forward<A>(args) ...), Buffer(JSOP_STRING_BUFFER_MIN_SIZE / sizeof(char)), Padded(false) {
+	}
+
+	JsopIndexParser(const JsopIndexParser &) = delete;
+	JsopIndexParser &operator =(const JsopIndexParser &) = delete;
+
+	//! Sets the allocator of the handler and of the buffers of the parser, which must not be called while parsing
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		H::setAllocator(allocator);
+		Index.setAllocator(allocator);
+		Buffer.setAllocator(allocator);
+	}
+
+	//! Initializes the parser
+	template <typename ... A>
+	JSOP_INLINE bool start(A && ... args) noexcept(H::NoExceptions) {
+		if (Buffer.initialized() && H::start(std::forward<A>(args) ...)) {
+			Parsed = false;
+			return true;
+		}
+		return false;
+	}
+
+	//! Indicates that there are no more characters left to parse
+	template <typename ... A>
+	JSOP_INLINE bool finish(A && ... args) noexcept(H::NoExceptions) {
+		if (Parsed) {
+			return H::finish(std::forward<A>(args) ...);
+		} else {
+			H::cleanup();
+			return false;
+		}
+	}
+
+	//! Parse the given string, which must contain the whole JSON value, so this can only be called once after start()
+	bool parse(
+		//! Pointer to the start of the string
+		const char *start,
+		//! Pointer to the end of the string
+		const char *end) noexcept(H::NoExceptions);
+
+	//! Parse the given string, which must contain the whole JSON value, so this can only be called once after start()
+	bool parse(
+		//! Pointer to the start of the string
+		const char *start,
+		//! Length of the string
+		size_t n) noexcept (H::NoExceptions) {
+		return parse(start, start + n);
+	}
+
+	//! Parse the given string (which is assumed to be NUL-terminated), which must contain the whole JSON value, so this can only be
+	//! called once after start()
+	bool parse(
+		//! Pointer to the start of the string
+		const char *start) noexcept(H::NoExceptions) {
+		return parse(start, strlen(start));
+	}
+
+	//! Parse the given string, which must contain the whole JSON value, so this can only be called once after start()
+	//! JSOP_INPUT_PADDING characters after the end of the string must be readable, which allows the scans to load whole vectors
+	//! without handling the end of the string separately
+	bool parsePadded(
+		//! Pointer to the start of the string
+		const char *start,
+		//! Pointer to the end of the string
+		const char *end) noexcept(H::NoExceptions) {
+		Padded = true;
+		auto rv = parse(start, end);
+		Padded = false;
+		return rv;
+	}
+};
+
+template <typename H>
+bool JsopIndexParser<H>::makeScalar(const char *start, const char *end) noexcept(H::NoExceptions) {
+#ifndef JSOP_IGNORE_OVERFLOW
+	uint64_t old_integer;
+	bool long_number;
+#endif
+	uint64_t integer;
+	int exponent, specified_exponent;
+	unsigned digit;
+	bool negate, negate_specified_exponent, is_double;
+
+	//Remove the whitespace between the value and the next structural character
+	while (end != start) {
+		auto ch = *(end - 1);
+		if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n') {
+			break;
+		}
+		--end;
+	}
+
+	assert(start != end);
+	switch (*start) {
+	case 'f':
+		return matchLiteral(start, end, "false", 5) && H::makeBool(false);
+
+	case 'n':
+		return matchLiteral(start, end, "null", 4) && H::makeNull();
+
+	case 't':
+		return matchLiteral(start, end, "true", 4) && H::makeBool(true);
+
+#ifdef JSOP_PARSE_NAN
+	case 'N':
+		return matchLiteral(start, end, "NaN", 3) && H::makeDouble(NAN);
+#endif
+
+	default:
+		break;
+	}
+
+	negate = false;
+	if (*start == '-') {
+		negate = true;
+		start = JsopSimd.SkipWhitespace(start + 1, end);
+		if (start == end) {
+			return false;
+		}
+	}
+
+#ifdef JSOP_PARSE_INFINITY
+#ifdef JSOP_PARSE_STRICT_INFINITY_AND_NAN
+	if (*start == 'I') {
+		return matchLiteral(start, end, "Infinity", 8) && H::makeDouble(!negate ? HUGE_VAL : -HUGE_VAL);
+	}
+#else
+	if ((*start | 0x20) == 'i') {
+		static const char infinity[] = "infinity";
+		size_t n = end - start;
+		if (n != 3 && n != 8) {
+			return false;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			if ((start[i] | 0x20) != infinity[i]) {
+				return false;
+			}
+		}
+		return H::makeDouble(!negate ? HUGE_VAL : -HUGE_VAL);
+	}
+#endif
+#endif
+
+	integer = 0;
+	exponent = 0;
+	is_double = false;
+#ifndef JSOP_IGNORE_OVERFLOW
+	long_number = false;
+#endif
+	digit = static_cast<unsigned>(*start) - '0';
+	if (digit == 0) {
+		++start;
+	} else if (digit < 10) {
+		start = parseEightDigits(start, end, &integer);
+		while (start != end && (digit = static_cast<unsigned>(*start) - '0') < 10) {
+#ifdef JSOP_IGNORE_OVERFLOW
+			integer = integer * 10 + digit;
+#else
+			old_integer = integer;
+			integer = old_integer * 10 + digit;
+			if (JSOP_UNLIKELY(old_integer > UINT64_C(1844674407370955160))) {
+				if (old_integer != UINT64_C(1844674407370955161) || integer < old_integer) {
+					//Keep the rest of the digits in the buffer, and make a double precision number from them at the end
+					integer = old_integer;
+					start = appendLongDigits(start, end, false, &exponent);
+					if (start == nullptr) {
+						return false;
+					}
+					is_double = true;
+					long_number = true;
+					break;
+				}
+			}
+#endif
+			++start;
+		}
+	} else if (*start == '.') {
+		//A number that starts with the decimal point must have a digit after it
+		if (end - start < 2 || static_cast<unsigned>(start[1]) - '0' >= 10) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+
+	if (start != end && *start == '.') {
+		is_double = true;
+		++start;
+		auto digits_start = start;
+		start = parseEightDigits(start, end, &integer);
+		exponent -= static_cast<int>(start - digits_start);
+		for (; start != end && (digit = static_cast<unsigned>(*start) - '0') < 10; ++start) {
+			exponent -= 1;
+#ifdef JSOP_IGNORE_OVERFLOW
+			integer = integer * 10 + digit;
+#else
+			old_integer = integer;
+			integer = old_integer * 10 + digit;
+			if (JSOP_UNLIKELY(old_integer > UINT64_C(1844674407370955160))) {
+				if (old_integer != UINT64_C(1844674407370955161) || integer < old_integer) {
+					//Keep the rest of the digits in the buffer, where the exponent is the one before this digit
+					integer = old_integer;
+					exponent += 1;
+					start = appendLongDigits(start, end, true, &exponent);
+					if (start == nullptr) {
+						return false;
+					}
+					long_number = true;
+					break;
+				}
+			}
+#endif
+		}
+	}
+
+	if (start != end && (*start | 0x20) == 'e') {
+		is_double = true;
+		++start;
+		negate_specified_exponent = false;
+		if (start != end && (*start == '+' || *start == '-')) {
+			negate_specified_exponent = *start == '-';
+			++start;
+		}
+		if (start == end || (digit = static_cast<unsigned>(*start) - '0') >= 10) {
+			return false;
+		}
+		specified_exponent = 0;
+		do {
+#ifdef JSOP_IGNORE_OVERFLOW
+			specified_exponent = specified_exponent * 10 + digit;
+#else
+			if (JSOP_LIKELY(specified_exponent <= (INT_MAX / 10 - 1))) {
+				specified_exponent = specified_exponent * 10 + digit;
+			}
+#endif
+			++start;
+		} while (start != end && (digit = static_cast<unsigned>(*start) - '0') < 10);
+		exponent += negate_specified_exponent ? -specified_exponent : specified_exponent;
+	}
+
+	if (start != end) {
+		return false;
+	}
+
+	if (!is_double) {
+		return H::makeInteger(integer, negate);
+	} else {
+#ifndef JSOP_IGNORE_OVERFLOW
+		if (JSOP_UNLIKELY(long_number)) {
+			return H::makeDouble(jsop_long_decimal_to_double(integer, Buffer.getStart(), Buffer.getEnd() - Buffer.getStart(), exponent, negate));
+		}
+#endif
+		if (H::useLazyNumbers()) {
+			return H::makeDecimal(integer, exponent, negate);
+		}
+		return H::makeDouble(jsop_decimal_to_double(integer, exponent, negate));
+	}
+}
+
+template <typename H>
+bool JsopIndexParser<H>::parse(const char *start, const char *end) noexcept(H::NoExceptions) {
+	auto skip_whitespace = !Padded ? JsopSimd.SkipWhitespace : JsopSimd.SkipWhitespacePadded;
+	const uint32_t *index;
+	const char *p;
+	unsigned char ch;
+
+	if (Parsed || !Index.build(start, end, Padded)) {
+		goto cleanup_on_error;
+	}
+
+	index = Index.getStart();
+	p = start;
+#ifdef JSOP_PARSE_UTF8_BYTE_ORDER_MARK
+	if (end - p >= 3 && memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+		p += 3;
+	}
+#endif
+
+	//The index ends with a sentinel at end, so every structural character found at p must be the current entry of the index, and
+	//characters before the current entry are not structural characters
+value:
+	p = skip_whitespace(p, end);
+	if (p == end) {
+		goto cleanup_on_error;
+	}
+	ch = *p;
+	switch (ch) {
+	case '"':
+		if (start + *index == p) {
+			const char *string_end = start + index[1];
+			if (makeString(p + 1, string_end, end, false)) {
+				index += 2;
+				p = string_end + 1;
+				goto value_end;
+			}
+		}
+		goto cleanup_on_error;
+
+	case '[':
+		if (start + *index == p && H::pushArray()) {
+			++index;
+			p = skip_whitespace(p + 1, end);
+			if (p != end && *p == ']') {
+				goto action_array_close_brace;
+			}
+			goto value;
+		}
+		goto cleanup_on_error;
+
+	case '{':
+		if (start + *index == p && H::pushObject()) {
+			++index;
+			p = skip_whitespace(p + 1, end);
+			if (p != end && *p == '}') {
+				goto action_object_close_brace;
+			}
+			goto key;
+		}
+		goto cleanup_on_error;
+
+	case ']':
+	case '}':
+	case ':':
+	case ',':
+		goto cleanup_on_error;
+
+	default:
+		//The value ends at the next structural character
+		if (start + *index > p && makeScalar(p, start + *index)) {
+			p = start + *index;
+			goto value_end;
+		}
+		goto cleanup_on_error;
+	}
+
+value_end:
+	if (H::inTop()) {
+		goto end_of_stream;
+	}
+	p = skip_whitespace(p, end);
+	if (p == end || start + *index != p) {
+		goto cleanup_on_error;
+	}
+	ch = *p;
+	if (H::inArray()) {
+		switch (ch) {
+		case ',':
+			++index;
+			p = skip_whitespace(p + 1, end);
+#ifdef JSOP_PARSE_TRAILING_COMMA
+			if (p != end && *p == ']') {
+				goto action_array_close_brace;
+			}
+#endif
+			goto value;
+
+		case ']':
+			goto action_array_close_brace;
+
+		default:
+			goto cleanup_on_error;
+		}
+	} else {
+		assert(H::inObject());
+		switch (ch) {
+		case ',':
+			++index;
+			p = skip_whitespace(p + 1, end);
+#ifdef JSOP_PARSE_TRAILING_COMMA
+			if (p != end && *p == '}') {
+				goto action_object_close_brace;
+			}
+#endif
+			goto key;
+
+		case '}':
+			goto action_object_close_brace;
+
+		default:
+			goto cleanup_on_error;
+		}
+	}
+
+key:
+	//p is at the first character after the whitespace
+	if (p != end && *p == '"' && start + *index == p) {
+		const char *string_end = start + index[1];
+		if (makeString(p + 1, string_end, end, true)) {
+			index += 2;
+			p = skip_whitespace(string_end + 1, end);
+			if (p != end && *p == ':' && start + *index == p) {
+				++index;
+				++p;
+				goto value;
+			}
+		}
+	}
+	goto cleanup_on_error;
+
+action_array_close_brace:
+	assert(start + *index == p);
+	if (H::popArray()) {
+		++index;
+		++p;
+		goto value_end;
+	}
+	goto cleanup_on_error;
+
+action_object_close_brace:
+	assert(start + *index == p);
+	if (H::popObject()) {
+		++index;
+		++p;
+		goto value_end;
+	}
+	goto cleanup_on_error;
+
+end_of_stream:
+	if (skip_whitespace(p, end) == end) {
+		assert(index + 1 == Index.getEnd());
+		Parsed = true;
+		return true;
+	}
+
+cleanup_on_error:
+	H::cleanup();
+	return false;
+}
+
+#endif
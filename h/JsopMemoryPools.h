@@ -13,6 +13,7 @@
 #include <cstddef>
 #endif
 
+#include "JsopAllocator.h"
 #include "JsopDefines.h"
 
 //! A singly linked list of memory pools
@@ -32,6 +33,8 @@ public:
 	struct Pool {
 		Pool *Next;
 		size_t Size;
+		//! Number of bytes that the pool can hold
+		size_t Capacity;
 		alignas(max_align_type) uint8_t Data[];
 	};
 	static_assert(alignof(Pool) == alignof(max_align_type), "alignof(Pool) == alignof(max_align_type)");
@@ -42,9 +45,18 @@ public:
 
 private:
 	Pool *Head = nullptr;
+	//! Empty pools of JSOP_MEMORY_POOL_MIN_SIZE bytes released by reset(), which are used before allocating new pools
+	Pool *Free = nullptr;
+	//! Empty pools larger than JSOP_MEMORY_POOL_MIN_SIZE released by reset(), which are used for allocations that fit in them
+	Pool *Large = nullptr;
+	const JsopAllocator *Allocator = &jsop_malloc_allocator;
 
 	//Destroys the list of pools specified by the start
-	static void destroy(Pool *pool) noexcept;
+	void destroy(Pool *pool) noexcept;
+
+	//! Removes the smallest of the large pools released by reset() that can hold the given number of bytes from its list, and returns it
+	//! or nullptr if there is none
+	Pool *takeLarge(size_t size) noexcept;
 
 	//! Allocates memory with the given size
 	template <size_t Alignment>
@@ -57,6 +69,8 @@ public:
 	JsopMemoryPools() = default;
 	~JsopMemoryPools() noexcept {
 		destroy(Head);
+		destroy(Free);
+		destroy(Large);
 	}
 
 	JsopMemoryPools(const JsopMemoryPools &) = delete;
@@ -65,10 +79,44 @@ public:
 	void clear() noexcept {
 		destroy(Head);
 		Head = nullptr;
+		destroy(Free);
+		Free = nullptr;
+		destroy(Large);
+		Large = nullptr;
+	}
+	const JsopAllocator *getAllocator() const noexcept {
+		return Allocator;
+	}
+	//! Releases all the pools and allocates the pools that follow with the given allocator
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		clear();
+		Allocator = allocator;
+	}
+	//! Releases all the allocations but keeps the pools for the allocations that follow
+	//! The large pools kept by the previous reset() that were not used since then are released
+	void reset() noexcept;
+	//! Exchanges the pools and allocator with those of the given list
+	void swap(JsopMemoryPools *pools) noexcept {
+		auto head = Head;
+		auto free_pools = Free;
+		auto large_pools = Large;
+		auto allocator = Allocator;
+		Head = pools->Head;
+		Free = pools->Free;
+		Large = pools->Large;
+		Allocator = pools->Allocator;
+		pools->Head = head;
+		pools->Free = free_pools;
+		pools->Large = large_pools;
+		pools->Allocator = allocator;
 	}
-	//! Moves the pools from the given list to itself and clears the given list
+	//! Moves the pools in use from the given list to itself, along with the allocator that releases them, and clears the given list
 	void move(JsopMemoryPools *pools) noexcept {
-		destroy(Head);
+		if (Allocator != pools->Allocator) {
+			setAllocator(pools->Allocator);
+		} else {
+			destroy(Head);
+		}
 		Head = pools->Head;
 		pools->Head = nullptr;
 	}
@@ -124,7 +172,25 @@ void *JsopMemoryPools::allocate(const size_t aligned_size) noexcept {
 		if (alloc_size < JSOP_MEMORY_POOL_MIN_SIZE) {
 			alloc_size = JSOP_MEMORY_POOL_MIN_SIZE;
 		}
-		new_pool = static_cast<Pool *>(malloc(alloc_size));
+		if (alloc_size == JSOP_MEMORY_POOL_MIN_SIZE) {
+			if (Free != nullptr) {
+				new_pool = Free;
+				Free = new_pool->Next;
+			} else {
+				new_pool = static_cast<Pool *>(jsop_allocate(Allocator, alloc_size));
+				if (new_pool != nullptr) {
+					new_pool->Capacity = alloc_size - offsetof(Pool, Data);
+				}
+			}
+		} else {
+			new_pool = Large != nullptr ? takeLarge(aligned_size) : nullptr;
+			if (new_pool == nullptr) {
+				new_pool = static_cast<Pool *>(jsop_allocate(Allocator, alloc_size));
+				if (new_pool != nullptr) {
+					new_pool->Capacity = aligned_size;
+				}
+			}
+		}
 		if (new_pool != nullptr) {
 			new_pool->Next = pool;
 			new_pool->Size = aligned_size;
@@ -133,8 +199,15 @@ void *JsopMemoryPools::allocate(const size_t aligned_size) noexcept {
 		}
 	} else {
 		//The current pool has more free space, so allocate the exact size
-		//for the new pool and insert it after the current pool
-		new_pool = static_cast<Pool *>(malloc(alloc_size));
+		//for the new pool (or reuse a large pool that it fits in) and insert
+		//it after the current pool
+		new_pool = Large != nullptr ? takeLarge(aligned_size) : nullptr;
+		if (new_pool == nullptr) {
+			new_pool = static_cast<Pool *>(jsop_allocate(Allocator, alloc_size));
+			if (new_pool != nullptr) {
+				new_pool->Capacity = aligned_size;
+			}
+		}
 		if (new_pool != nullptr) {
 			new_pool->Next = pool->Next;
 			new_pool->Size = aligned_size;
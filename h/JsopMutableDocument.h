@@ -0,0 +1,213 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_MUTABLE_DOCUMENT_H
+#define JSOP_MUTABLE_DOCUMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsopAllocator.h"
+#include "JsopDefines.h"
+#include "JsopDocument.h"
+#include "JsopMemoryPools.h"
+#include "JsopValue.h"
+
+//! A hierarchy of values that can be changed after it is parsed, where the arrays and objects that grow are moved to blocks with spare
+//! capacity in the memory pools of the document
+//! Inserting into an array or object may move its values, so pointers to them are only valid until the next insertion into the same
+//! array or object, and compact() moves all the values except the top level value
+//! Objects keep their hash index or sorted keys, so their keys can still be found with JsopObjectView::find()
+class JsopMutableDocument final {
+	//! An array or object made by the document, which has space for more values than its size
+	struct Block {
+		const JsopValue *Values;
+		size_t Capacity;
+	};
+
+	JsopMemoryPools Pools;
+	JsopValue Root;
+	//! The values taken from the top level of a parsed document, and their number of bytes
+	JsopValue *RootValues = nullptr;
+	size_t RootCapacity = 0;
+	void *Input = nullptr;
+	void (*ReleaseInput)(void *) = nullptr;
+	//! Hash table of the blocks by their values, where the slots that are not used have no values
+	Block *BlocksStart = nullptr;
+	size_t BlocksCapacity = 0;
+	size_t BlocksCount = 0;
+
+	//! Gets the number of values (or pairs for objects) that can be stored in the given array or object without moving it
+	size_t getCapacity(const JsopValue &value) const noexcept;
+
+	//! Adds a block with the given capacity to the hash table, and returns false if the memory cannot be allocated
+	bool addBlock(const JsopValue *values, size_t capacity) noexcept;
+
+	//! Gets the number of values after the pairs of an object with the given number of pairs
+	static size_t getTrailerSize(size_t n, JsopValue::ValueType type) noexcept {
+		if (type == JsopValue::SortedObjectType) {
+			return JsopObjectView::getInsertionOrderSize(n);
+		} else if (type == JsopValue::IndexedObjectType && JsopObjectView::hasIndex(n)) {
+			return JsopObjectView::getIndexSize(n);
+		} else {
+			return 0;
+		}
+	}
+
+	//! Makes sure that the given array or object can hold one more value or pair, and returns its values or nullptr if the memory cannot
+	//! be allocated
+	JsopValue *reserve(JsopValue *value) noexcept;
+
+	//! Copies a string into the memory pools
+	bool makeString(JsopValue *value, const char *s, size_t n) noexcept;
+
+	//! Copies the values, string or number that the given value refers to into the given memory pools, but not the children of its
+	//! values
+	static bool copyValue(JsopMemoryPools *pools, JsopValue *value) noexcept;
+
+	//! Releases the values taken from a parsed document and forgets the blocks in the hash table
+	void releaseValues() noexcept {
+		jsop_release(Pools.getAllocator(), RootValues, RootCapacity);
+		RootValues = nullptr;
+		RootCapacity = 0;
+		if (BlocksCount != 0) {
+			memset(static_cast<void *>(BlocksStart), 0, sizeof(Block) * BlocksCapacity);
+			BlocksCount = 0;
+		}
+	}
+
+public:
+	JsopMutableDocument() noexcept {
+		Root.setNull();
+	}
+	~JsopMutableDocument() noexcept {
+		jsop_release(Pools.getAllocator(), BlocksStart, BlocksCapacity * sizeof(Block));
+		jsop_release(Pools.getAllocator(), RootValues, RootCapacity);
+		if (ReleaseInput != nullptr) {
+			ReleaseInput(Input);
+		}
+	}
+
+	JsopMutableDocument(const JsopMutableDocument &) = delete;
+	JsopMutableDocument &operator =(const JsopMutableDocument &) = delete;
+
+	//! Gets the top level value
+	const JsopValue &get() const noexcept {
+		return Root;
+	}
+
+	//! Gets the top level value, which can be changed and stays at the same address
+	JsopValue *getMutable() noexcept {
+		return &Root;
+	}
+
+	//! Takes the values of a parsed document and the input that its strings are borrowed from, which leaves the document empty
+	void adopt(JsopDocument *doc) noexcept;
+
+	//! Takes the ownership of the input that strings are borrowed from (see JsopDocumentHandler::setBorrowInput()), which is released
+	//! with the given function when the document is destroyed or another input is adopted
+	void adoptInput(void *input, void (*release_input)(void *) = free) noexcept {
+		if (ReleaseInput != nullptr) {
+			ReleaseInput(Input);
+		}
+		Input = input;
+		ReleaseInput = release_input;
+	}
+
+	//! Gets the value at the given position of an array, or nullptr if the position is not in the array
+	JsopValue *at(JsopValue *array, size_t i) noexcept {
+		if (array->isArray() && i < array->size()) {
+			return const_cast<JsopValue *>(array->getValues()) + i;
+		}
+		return nullptr;
+	}
+
+	//! Gets the value of the first pair of an object with the given key, or nullptr if there is none
+	JsopValue *find(JsopValue *object, const char *key, size_t n) noexcept {
+		if (object->isObject()) {
+			auto key_value = object->getObjectView().find(key, n);
+			if (key_value != nullptr) {
+				return const_cast<JsopValue *>(&key_value->Value);
+			}
+		}
+		return nullptr;
+	}
+
+	JsopValue *find(JsopValue *object, const char *key) noexcept {
+		return find(object, key, strlen(key));
+	}
+
+	//! Sets a value to a copy of the given string, and returns false if the memory cannot be allocated
+	bool setString(JsopValue *value, const char *s, size_t n) noexcept {
+		return makeString(value, s, n);
+	}
+
+	bool setString(JsopValue *value, const char *s) noexcept {
+		return makeString(value, s, strlen(s));
+	}
+
+	//! Sets a value to an integer, which may need memory on 32-bit platforms
+	bool setInt64(JsopValue *value, int64_t integer) noexcept;
+	bool setUint64(JsopValue *value, uint64_t integer) noexcept;
+
+	//! Sets a value to a double precision number, which needs memory on 32-bit platforms
+	bool setDouble(JsopValue *value, double number) noexcept;
+
+	//! Sets a value to an empty array
+	void setArray(JsopValue *value) noexcept {
+		value->setArray(nullptr, 0);
+	}
+
+	//! Sets a value to an empty object, whose pairs are kept sorted by their keys if sorted is true
+	void setObject(JsopValue *value, bool sorted = false) noexcept {
+		if (sorted) {
+			value->setSortedObject(nullptr, 0);
+		} else {
+			value->setObject(nullptr, 0);
+		}
+	}
+
+	//! Sets a value to an empty object, whose pairs are followed by a hash index of their keys once it has at least
+	//! JSOP_OBJECT_INDEX_MIN_SIZE keys
+	void setIndexedObject(JsopValue *value) noexcept {
+		value->setIndexedObject(nullptr, 0);
+	}
+
+	//! Inserts a null value at the given position of an array, and returns it or nullptr if the position is after the end of the array
+	//! or the memory cannot be allocated
+	JsopValue *insert(JsopValue *array, size_t i) noexcept;
+
+	//! Appends a null value to an array
+	JsopValue *append(JsopValue *array) noexcept {
+		return array->isArray() ? insert(array, array->size()) : nullptr;
+	}
+
+	//! Removes the value at the given position of an array, and returns false if the position is not in the array
+	bool erase(JsopValue *array, size_t i) noexcept;
+
+	//! Gets the value of the first pair of an object with the given key, and adds a pair with a null value if there is none
+	//! Pairs are added at the end of the object, or at the position of their key if the pairs are sorted
+	//! Returns nullptr if the memory cannot be allocated
+	JsopValue *set(JsopValue *object, const char *key, size_t n) noexcept;
+
+	JsopValue *set(JsopValue *object, const char *key) noexcept {
+		return set(object, key, strlen(key));
+	}
+
+	//! Removes the first pair of an object with the given key, and returns false if there is none
+	bool eraseKey(JsopValue *object, const char *key, size_t n) noexcept;
+
+	bool eraseKey(JsopValue *object, const char *key) noexcept {
+		return eraseKey(object, key, strlen(key));
+	}
+
+	//! Copies all the values and strings to new memory pools without any spare capacity, which releases the memory of the values that
+	//! were removed or moved, and returns false (keeping the values unchanged) if the memory cannot be allocated
+	//! Strings borrowed from the input are not copied
+	bool compact() noexcept;
+};
+
+#endif
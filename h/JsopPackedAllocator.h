@@ -29,6 +29,7 @@ public:
 	typedef typename value_type::String String;
 	typedef typename value_type::Array Array;
 	typedef typename value_type::Object Object;
+	typedef typename value_type::ObjectView ObjectView;
 
 private:
 	void *Start = nullptr;
@@ -102,6 +103,8 @@ public:
 	JsopPackedAllocator &operator =(const JsopPackedAllocator &) = delete;
 
 	bool start() noexcept {
+		static_assert(DefaultSize >= sizeof(JsopPackedHeader) + sizeof(value_type), "DefaultSize >= sizeof(JsopPackedHeader) + sizeof(value_type)");
+
 		auto *start = Start;
 		if (start == nullptr) {
 			//Allocate a new memory block with the default size
@@ -109,11 +112,11 @@ public:
 			if (start != nullptr) {
 				Start = start;
 				if (RootFirst) {
-					End = static_cast<uint8_t *>(start) + sizeof(value_type);
-					FreeSize = DefaultSize - sizeof(value_type);
+					End = static_cast<uint8_t *>(start) + (sizeof(JsopPackedHeader) + sizeof(value_type));
+					FreeSize = DefaultSize - (sizeof(JsopPackedHeader) + sizeof(value_type));
 				} else {
-					End = start;
-					FreeSize = DefaultSize;
+					End = static_cast<uint8_t *>(start) + sizeof(JsopPackedHeader);
+					FreeSize = DefaultSize - sizeof(JsopPackedHeader);
 				}
 				return true;
 			}
@@ -121,11 +124,11 @@ public:
 			//Calculate the current capacity of the memory block
 			size_t capacity = reinterpret_cast<uintptr_t>(End) - reinterpret_cast<uintptr_t>(start) + FreeSize;
 			if (RootFirst) {
-				End = static_cast<uint8_t *>(start) + sizeof(value_type);
-				FreeSize = capacity - sizeof(value_type);
+				End = static_cast<uint8_t *>(start) + (sizeof(JsopPackedHeader) + sizeof(value_type));
+				FreeSize = capacity - (sizeof(JsopPackedHeader) + sizeof(value_type));
 			} else {
-				End = start;
-				FreeSize = capacity;
+				End = static_cast<uint8_t *>(start) + sizeof(JsopPackedHeader);
+				FreeSize = capacity - sizeof(JsopPackedHeader);
 			}
 			return true;
 		}
@@ -142,18 +145,19 @@ public:
 		}
 
 		//Shrink the allocated memory block to the exact size
-		auto *start = static_cast<value_type *>(Start);
+		auto *start = Start;
 		uintptr_t n = reinterpret_cast<uintptr_t>(End) - reinterpret_cast<uintptr_t>(start);
-		auto *new_start = static_cast<value_type *>(realloc(start, n));
+		auto *new_start = realloc(start, n);
 		if (new_start != nullptr) {
 			start = new_start;
 		}
 
-		//Set the root and transfer ownership to the document
+		//Set the header and the root, and transfer ownership to the document
+		static_cast<JsopPackedHeader *>(start)->template set<value_type, RootFirst, MinimumAlignmentOnly>(n);
 		if (RootFirst) {
-			*start = value;
+			*reinterpret_cast<value_type *>(static_cast<char *>(start) + sizeof(JsopPackedHeader)) = value;
 		}
-		doc->set(start, reinterpret_cast<char *>(start) + n);
+		doc->set(start, static_cast<char *>(start) + n);
 
 		//Reset to allocate a new memory block on next parse
 		Start = nullptr;
@@ -238,6 +242,26 @@ public:
 			return value_type::makeNull();
 		}
 	}
+	//! Writes an object followed by the hash index of its keys, given the hashes of the keys
+	value_type writeIndexedObject(size_t n, const value_type *key_values, const uint32_t *hashes) noexcept {
+		constexpr size_t alignment = (MinimumAlignmentOnly || alignof(Object) <= MINIMUM_ALIGNMENT) ? MINIMUM_ALIGNMENT : alignof(Object);
+
+		assert(ObjectView::hasIndex(n));
+		auto capacity = ObjectView::getIndexCapacity(n);
+		//The index has less than 4 slots per key
+		if (n <= (MAX_ALLOC_SIZE - Object::sizeofHeader()) / (sizeof(typename Object::value_type) + 4 * sizeof(uint32_t))) {
+			auto *new_value = static_cast<Object *>(allocate<alignment>(Object::sizeofHeader() + n * sizeof(typename Object::value_type) + capacity * sizeof(uint32_t)));
+			if (new_value != nullptr) {
+				new_value->Size = static_cast<typename Object::size_type>(n);
+				memcpy(new_value->Data, key_values, n * sizeof(typename Object::value_type));
+				jsop_packed_object_make_index(reinterpret_cast<uint32_t *>(new_value->Data + n), capacity, hashes, n);
+				return value_type::make(
+					JsopPackedValueType::IndexedObject,
+					(reinterpret_cast<uintptr_t>(new_value) - reinterpret_cast<uintptr_t>(Start)) / MINIMUM_ALIGNMENT);
+			}
+		}
+		return value_type::makeNull();
+	}
 };
 
 template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t DefaultSize, bool RootFirst>
@@ -8,6 +8,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+#include "JsopPackedHeader.h"
 #include "JsopPackedValue.h"
 
 template <class ValueType, bool RootFirst = true>
@@ -17,7 +18,7 @@ public:
 	typedef typename value_type::size_type size_type;
 
 private:
-	value_type *Start;
+	void *Start;
 	const void *End;
 
 public:
@@ -32,7 +33,7 @@ public:
 
 	const value_type *get() const noexcept {
 		if (RootFirst) {
-			return Start;
+			return reinterpret_cast<const value_type *>(static_cast<const char *>(Start) + sizeof(JsopPackedHeader));
 		} else {
 			return static_cast<const value_type *>(End) - 1;
 		}
@@ -46,9 +47,10 @@ public:
 		return End;
 	}
 
-	void set(value_type *value, const void *end) noexcept {
+	//! Takes the memory block that starts with the header
+	void set(void *start, const void *end) noexcept {
 		free(Start);
-		Start = value;
+		Start = start;
 		End = end;
 	}
 };
@@ -13,8 +13,12 @@
 #include <limits>
 #include <utility>
 
+#include "JsopAllocator.h"
+#include "JsopDecimal.h"
 #include "JsopDefines.h"
+#include "JsopHash.h"
 #include "JsopPackedValue.h"
+#include "JsopStringTable.h"
 
 template <class IO>
 class JsopPackedDocumentHandler : public IO {
@@ -25,14 +29,30 @@ class JsopPackedDocumentHandler : public IO {
 	typedef typename value_type::String String;
 	typedef typename value_type::Array Array;
 	typedef typename value_type::Object Object;
+	typedef typename value_type::ObjectView ObjectView;
 
 	value_type *StackStart = nullptr;
 	value_type *StackEnd = nullptr;
 	value_type *StackAllocEnd = nullptr;
 	size_type PrevStackSize = 0;
+	JsopStringTable<value_type> Strings;
+	size_t InternValueMaxSize = 0;
+	bool InternKeys = false;
+	bool IndexObjects = false;
+	//! The low 32 bits of the hashes of the keys of the objects that are being parsed, when the objects are indexed
+	uint32_t *HashesStart = nullptr;
+	uint32_t *HashesEnd = nullptr;
+	uint32_t *HashesAllocEnd = nullptr;
+	const JsopAllocator *Allocator = &jsop_malloc_allocator;
 
 	value_type *resizeStack() noexcept;
 
+	//! Pushes the hash of a key, and returns false if the memory cannot be allocated
+	bool pushHash(const char *start, size_t n) noexcept;
+
+	//! Makes a string that refers to an identical string written earlier, or writes the string and adds it to the table of strings
+	bool makeInternedString(const char *start, const char *end) noexcept;
+
 	//! Creates a value and push it to the stack
 	//! The caller must initialize the value returned
 	JSOP_INLINE value_type *makeValue() noexcept {
@@ -54,7 +74,8 @@ public:
 
 	JsopPackedDocumentHandler() = default;
 	~JsopPackedDocumentHandler() noexcept {
-		free(StackStart);
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(value_type));
+		jsop_release(Allocator, HashesStart, (HashesAllocEnd - HashesStart) * sizeof(uint32_t));
 	}
 
 	JsopPackedDocumentHandler(const JsopPackedDocumentHandler &) = delete;
@@ -66,6 +87,49 @@ public:
 		return false;
 	}
 
+	//! Check if strings can be passed to makeInputString() and makeInSituString() as pointers to the input
+	constexpr static bool useInputStrings() noexcept {
+		//The strings are copied directly from the input instead of through the string buffer of the parser
+		return true;
+	}
+
+	//! Check if numbers with a fractional part or an exponent are passed to makeDecimal() instead of being converted for makeDouble()
+	constexpr static bool useLazyNumbers() noexcept {
+		//The packed values only store double precision numbers
+		return false;
+	}
+
+	//! Sets whether keys that are not stored in the value refer to the identical key written before them, so repeated keys are only
+	//! written once
+	void setInternKeys(bool value) noexcept {
+		InternKeys = value;
+	}
+
+	//! Sets the maximum size of the strings other than keys that refer to the identical string written before them, or 0 to write all of
+	//! them
+	void setInternValues(size_t max_size) noexcept {
+		InternValueMaxSize = max_size;
+	}
+
+	//! Sets whether objects with at least JSOP_OBJECT_INDEX_MIN_SIZE keys are written with a hash index of their keys, which is used by
+	//! JsopPackedObjectView::find()
+	void setIndexObjects(bool value) noexcept {
+		IndexObjects = value;
+	}
+
+	//! Sets the allocator of the stacks of values and hashes, which releases the stacks
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(value_type));
+		jsop_release(Allocator, HashesStart, (HashesAllocEnd - HashesStart) * sizeof(uint32_t));
+		Allocator = allocator;
+		StackStart = nullptr;
+		StackEnd = nullptr;
+		StackAllocEnd = nullptr;
+		HashesStart = nullptr;
+		HashesEnd = nullptr;
+		HashesAllocEnd = nullptr;
+	}
+
 	//! Initializes the parsing
 	template <typename ... A>
 	bool start(A && ... args) noexcept {
@@ -73,7 +137,7 @@ public:
 			auto stack_start = StackStart;
 			if (stack_start == nullptr) {
 				static_assert(JSOP_VALUE_STACK_MIN_SIZE % sizeof(value_type) == 0, "JSOP_VALUE_STACK_MIN_SIZE % sizeof(value_type) == 0");
-				stack_start = static_cast<value_type *>(malloc(JSOP_VALUE_STACK_MIN_SIZE));
+				stack_start = static_cast<value_type *>(jsop_allocate(Allocator, JSOP_VALUE_STACK_MIN_SIZE));
 				if (stack_start != nullptr) {
 					StackStart = stack_start;
 					StackAllocEnd = stack_start + JSOP_VALUE_STACK_MIN_SIZE / sizeof(value_type);
@@ -83,6 +147,9 @@ public:
 			}
 			StackEnd = stack_start;
 			PrevStackSize = 0;
+			HashesEnd = HashesStart;
+			//The strings in the table were written to the previous document
+			Strings.clear();
 			return true;
 		} else {
 			return false;
@@ -97,6 +164,7 @@ public:
 
 	//! Frees memory allocated for the parsed values
 	void cleanup() noexcept {
+		IO::cleanup();
 	}
 
 	//! Checks if it is parsing a value at the top level
@@ -157,6 +225,11 @@ public:
 
 	bool makeDouble(double value) noexcept;
 
+	//! Makes a number with the given significand and exponent (of 10)
+	JSOP_INLINE bool makeDecimal(uint64_t significand, int exponent, bool negative) noexcept {
+		return makeDouble(jsop_decimal_to_double(significand, exponent, negative));
+	}
+
 	//! Makes a null-terminated string indicated by the (start, end) pair
 	JSOP_INLINE bool makeString(const char *start, const char *end) noexcept {
 		auto new_value = makeValue();
@@ -177,10 +250,30 @@ public:
 		}
 		return false;
 	}
-	JSOP_INLINE bool makeString(const char *start, const char *end, bool) noexcept {
+	JSOP_INLINE bool makeString(const char *start, const char *end, bool key) noexcept {
+		size_t n = static_cast<size_t>(end - start);
+		if (JSOP_UNLIKELY(IndexObjects) && key && !pushHash(start, n)) {
+			return false;
+		}
+		if (JSOP_UNLIKELY(key ? InternKeys : n <= InternValueMaxSize) && n > (sizeof(size_type) - sizeof(typename TinyString::size_type) - sizeof(char)) / sizeof(char)) {
+			return makeInternedString(start, end);
+		}
 		return makeString(start, end);
 	}
 
+	//! Makes a string indicated by the (start, end) pair in the input, which is not null-terminated but at least 16 characters can be read
+	//! from start
+	JSOP_INLINE bool makeInputString(const char *start, const char *end, bool key) noexcept {
+		return makeString(start, end, key);
+	}
+
+	//! Makes a null-terminated string indicated by the (start, end) pair in the input of JsopParser::parseInSitu(), where at least 16
+	//! characters can be read from start
+	JSOP_INLINE bool makeInSituString(char *start, char *end, bool key) noexcept {
+		//The packed values can only refer to their own memory, so the string is copied directly from the input
+		return makeString(start, end, key);
+	}
+
 	//! Makes a new array, and push the context to add subsequent values to the array
 	JSOP_INLINE bool pushArray() noexcept {
 		auto new_value = makeValue();
@@ -235,7 +328,19 @@ public:
 			size_t n = static_cast<size_t>(StackEnd - values_start);
 			assert((n % 2) == 0);
 			size_t new_object_size = n / 2;
-			auto new_value = IO::writeObject(new_object_size, values_start);
+			value_type new_value;
+			if (JSOP_UNLIKELY(IndexObjects)) {
+				//The hashes of the keys of the object are at the top of the stack of hashes
+				auto hashes = HashesEnd - new_object_size;
+				if (ObjectView::hasIndex(new_object_size)) {
+					new_value = IO::writeIndexedObject(new_object_size, values_start, hashes);
+				} else {
+					new_value = IO::writeObject(new_object_size, values_start);
+				}
+				HashesEnd = hashes;
+			} else {
+				new_value = IO::writeObject(new_object_size, values_start);
+			}
 			if (!(new_value.isNull())) {
 				StackEnd = values_start;
 
@@ -248,14 +353,36 @@ public:
 	}
 };
 
+template <class IO>
+bool JsopPackedDocumentHandler<IO>::makeInternedString(const char *start, const char *end) noexcept {
+	size_t n = static_cast<size_t>(end - start);
+	auto hash = jsop_hash_string(start, n);
+	auto value = Strings.find(start, n, hash);
+	if (value != nullptr) {
+		auto new_value = makeValue();
+		if (new_value != nullptr) {
+			*new_value = *value;
+			return true;
+		}
+		return false;
+	}
+
+	if (makeString(start, end)) {
+		//The string may have been written to a file, so the table keeps its own copy, and the string is still made if it cannot be added
+		Strings.insert(start, n, hash, StackEnd[-1], true);
+		return true;
+	}
+	return false;
+}
+
 template <class IO>
 auto JsopPackedDocumentHandler<IO>::resizeStack() noexcept -> value_type * {
 	auto *stack_start = StackStart;
 	size_t capacity = StackAllocEnd - stack_start;
 	if (capacity < (SIZE_MAX / (sizeof(value_type) * 2))) {
-		capacity *= 2;
-		auto *new_start = static_cast<value_type *>(realloc(stack_start, capacity * sizeof(value_type)));
+		auto *new_start = static_cast<value_type *>(jsop_reallocate(Allocator, stack_start, capacity * sizeof(value_type), capacity * 2 * sizeof(value_type)));
 		if (new_start != nullptr) {
+			capacity *= 2;
 			StackStart = new_start;
 			auto *new_stack_end = new_start + (StackEnd - stack_start);
 			StackEnd = new_stack_end;
@@ -266,6 +393,28 @@ auto JsopPackedDocumentHandler<IO>::resizeStack() noexcept -> value_type * {
 	return nullptr;
 }
 
+template <class IO>
+bool JsopPackedDocumentHandler<IO>::pushHash(const char *start, size_t n) noexcept {
+	auto hashes_end = HashesEnd;
+	if (JSOP_UNLIKELY(hashes_end == HashesAllocEnd)) {
+		size_t capacity = HashesAllocEnd - HashesStart;
+		size_t new_capacity = capacity != 0 ? capacity * 2 : JSOP_VALUE_STACK_MIN_SIZE / sizeof(uint32_t);
+		if (capacity >= SIZE_MAX / (sizeof(uint32_t) * 2)) {
+			return false;
+		}
+		auto *new_start = static_cast<uint32_t *>(jsop_reallocate(Allocator, HashesStart, capacity * sizeof(uint32_t), new_capacity * sizeof(uint32_t)));
+		if (new_start == nullptr) {
+			return false;
+		}
+		hashes_end = new_start + capacity;
+		HashesStart = new_start;
+		HashesAllocEnd = new_start + new_capacity;
+	}
+	*hashes_end = static_cast<uint32_t>(jsop_hash_string(start, n));
+	HashesEnd = hashes_end + 1;
+	return true;
+}
+
 template <class IO>
 bool JsopPackedDocumentHandler<IO>::makeInteger(uint64_t value, bool negative) noexcept {
 	auto new_value = makeValue();
@@ -5,9 +5,11 @@
 #ifndef JSOP_PACKED_FILE_H
 #define JSOP_PACKED_FILE_H
 
+#include <errno.h>
 #include <limits.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <limits>
@@ -17,7 +19,14 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+#include <pthread.h>
+#endif
+
+#include "JsopDefines.h"
+#include "JsopPackedHeader.h"
 #include "JsopPackedValue.h"
+#include "JsopStringTable.h"
 
 template <
 	class ValueType,
@@ -34,6 +43,7 @@ public:
 	typedef typename value_type::String String;
 	typedef typename value_type::Array Array;
 	typedef typename value_type::Object Object;
+	typedef typename value_type::ObjectView ObjectView;
 
 private:
 	enum : size_t {
@@ -53,16 +63,38 @@ private:
 	size_type WrittenBufferSize;
 	size_t FreeBufferSize;
 	int Handle;
-	union {
-		char Buffer[BufferSize];
-		value_type ValueBuffer[BufferSize / sizeof(value_type)];
-	};
+	//! The hash index of the object that is being written
+	uint32_t *IndexStart;
+	size_t IndexCapacity;
+	//! The strings that were written, which are written only once if they are at most DeduplicateMaxSize bytes
+	JsopStringTable<value_type> WrittenStrings;
+	size_t DeduplicateMaxSize;
+	//! The buffer that is being filled, which is either InlineBuffer or one of AsyncBuffers
+	char *Buffer;
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+	//! The buffers that are written by the writer thread in the order that they are filled, after which they are filled again
+	//! Buffers from AsyncWriteIndex to AsyncFillIndex (exclusive) are waiting to be written, and the writer thread only runs when
+	//! AsyncWrites is true
+	char *AsyncBuffers;
+	unsigned AsyncFillIndex;
+	unsigned AsyncWriteIndex;
+	unsigned AsyncPendingCount;
+	bool AsyncWrites;
+	bool AsyncStarted;
+	bool AsyncStop;
+	bool AsyncFailed;
+	pthread_t AsyncThread;
+	pthread_mutex_t AsyncMutex;
+	pthread_cond_t AsyncCond;
+#endif
+	alignas(value_type) char InlineBuffer[BufferSize];
 
 	static_assert(BufferSize >= MaxWriteSize || ((BufferSize & (BufferSize - 1)) == 0), "BufferSize >= MaxWriteSize || ((BufferSize & (BufferSize - 1)) == 0)");
 	static_assert(MaxWriteSize <= SSIZE_MAX, "MaxWriteSize <= SSIZE_MAX");
+	static_assert(JSOP_PACKED_FILE_ASYNC_BUFFERS >= 2, "JSOP_PACKED_FILE_ASYNC_BUFFERS >= 2");
 
 	static_assert(sizeof(double) == sizeof(int64_t), "sizeof(double) == sizeof(int64_t)");
-	static_assert(BufferSize > 0, "BufferSize > 0");
+	static_assert(BufferSize >= sizeof(JsopPackedHeader) + sizeof(value_type), "BufferSize >= sizeof(JsopPackedHeader) + sizeof(value_type)");
 	static_assert((BufferSize % MINIMUM_ALIGNMENT) == 0, "(BufferSize % MINIMUM_ALIGNMENT) == 0");
 	static_assert((BufferSize % sizeof(int64_t)) == 0, "(BufferSize % sizeof(int64_t)) == 0");
 	static_assert((BufferSize % sizeof(uint64_t)) == 0, "(BufferSize % sizeof(uint64_t)) == 0");
@@ -89,6 +121,63 @@ private:
 		return n;
 	}
 
+	//! Writes the full buffer, or passes it to the writer thread and continues with the next buffer once it is not waiting to be written
+	//! Returns false if the buffer or any buffer passed to the writer thread before it could not be written
+	bool flushBuffer() noexcept {
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+		bool ok;
+
+		if (Buffer == InlineBuffer) {
+			return writeAll(Handle, Buffer, BufferSize) >= 0;
+		}
+		pthread_mutex_lock(&AsyncMutex);
+		++AsyncPendingCount;
+		AsyncFillIndex = (AsyncFillIndex + 1) % JSOP_PACKED_FILE_ASYNC_BUFFERS;
+		pthread_cond_broadcast(&AsyncCond);
+		while (AsyncPendingCount == JSOP_PACKED_FILE_ASYNC_BUFFERS) {
+			pthread_cond_wait(&AsyncCond, &AsyncMutex);
+		}
+		ok = !AsyncFailed;
+		pthread_mutex_unlock(&AsyncMutex);
+		Buffer = AsyncBuffers + AsyncFillIndex * BufferSize;
+		return ok;
+#else
+		return writeAll(Handle, Buffer, BufferSize) >= 0;
+#endif
+	}
+
+	//! Waits until the writer thread has written all the buffers passed to it, and returns false if any of them could not be written
+	bool waitForWrites() noexcept {
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+		bool ok;
+
+		if (!AsyncStarted) {
+			return true;
+		}
+		pthread_mutex_lock(&AsyncMutex);
+		while (AsyncPendingCount != 0) {
+			pthread_cond_wait(&AsyncCond, &AsyncMutex);
+		}
+		ok = !AsyncFailed;
+		AsyncFailed = false;
+		pthread_mutex_unlock(&AsyncMutex);
+		return ok;
+#else
+		return true;
+#endif
+	}
+
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+	//! Allocates the buffers and starts the writer thread
+	bool startWriter() noexcept;
+
+	//! Stops the writer thread after it has written the buffers passed to it, and frees the buffers
+	void stopWriter() noexcept;
+
+	//! Runs the writer thread, which writes the buffers in order until it is stopped
+	static void *writeBuffers(void *arg) noexcept;
+#endif
+
 	template <typename T, size_t Alignment>
 	bool writeSmallData(T value) noexcept {
 		auto n = sizeof(T);
@@ -99,7 +188,7 @@ private:
 			return true;
 		} else {
 			if (Alignment >= sizeof(T) || free_buffer_size == 0) {
-				if (JSOP_UNLIKELY(writeAll(Handle, Buffer, BufferSize) < 0)) {
+				if (JSOP_UNLIKELY(!flushBuffer())) {
 					return false;
 				}
 				if (JSOP_LIKELY(WrittenBufferSize <= TOTAL_SIZE - BufferSize)) {
@@ -115,7 +204,7 @@ private:
 				n -= free_buffer_size;
 				memcpy(Buffer + (BufferSize - free_buffer_size), src, free_buffer_size);
 				src = static_cast<const char *>(src) + free_buffer_size;
-				if (JSOP_UNLIKELY(writeAll(Handle, Buffer, BufferSize) < 0)) {
+				if (JSOP_UNLIKELY(!flushBuffer())) {
 					return false;
 				}
 				if (JSOP_LIKELY(WrittenBufferSize <= TOTAL_SIZE - BufferSize)) {
@@ -132,24 +221,80 @@ private:
 	bool writeData(const void *src, size_t n) noexcept;
 
 public:
-	JsopPackedFile() noexcept : WrittenSize(0), WrittenBufferSize(0), FreeBufferSize(BufferSize), Handle(-1) {
+	JsopPackedFile() noexcept : WrittenSize(0), WrittenBufferSize(0), FreeBufferSize(BufferSize), Handle(-1), IndexStart(nullptr), IndexCapacity(0), DeduplicateMaxSize(0), Buffer(InlineBuffer)
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+		, AsyncBuffers(nullptr), AsyncFillIndex(0), AsyncWriteIndex(0), AsyncPendingCount(0), AsyncWrites(false), AsyncStarted(false), AsyncStop(false), AsyncFailed(false)
+#endif
+	{
+	}
+	~JsopPackedFile() noexcept {
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+		if (AsyncStarted) {
+			stopWriter();
+		}
+#endif
+		free(IndexStart);
 	}
 
 	JsopPackedFile(const JsopPackedFile &) = delete;
 	JsopPackedFile &operator =(const JsopPackedFile &) = delete;
 
+	//! Sets the maximum size of the strings that refer to an identical string written earlier instead of being written again, or 0 to
+	//! write all of them
+	//! The strings are copied to a table that holds at most JSOP_STRING_TABLE_MAX_SIZE strings, after which new strings are always written
+	void setDeduplicateStrings(size_t max_size) noexcept {
+		DeduplicateMaxSize = max_size;
+	}
+
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+	//! Sets whether the full buffers are written by a separate thread, so that parsing continues while they are written to the file
+	//! The thread is started by the next call to start() and fills JSOP_PACKED_FILE_ASYNC_BUFFERS buffers of BufferSize bytes in turn,
+	//! and the file is identical to the file written without it
+	//! Only available when JSOP_PACKED_FILE_ASYNC_WRITES is defined, since the program must then be linked with the threads library
+	//! Must not be called between start() and finish() or cleanup()
+	void setAsyncWrites(bool async_writes) noexcept {
+		AsyncWrites = async_writes;
+		if (!async_writes && AsyncStarted) {
+			stopWriter();
+		}
+	}
+#endif
+
+	//! Starts writing to a file, which must be seekable unless the root is last
+	//! Files opened with O_APPEND are rejected if the root is first, since the root could not be written at the start of the file
 	bool start(int handle) noexcept {
-		if (handle >= 0) {
+		if (handle >= 0 && (!RootFirst || (fcntl(handle, F_GETFL) & O_APPEND) == 0)) {
+			//Any buffers of a previous file that was not finished are still written to it
+			waitForWrites();
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+			if (AsyncWrites) {
+				if (!AsyncStarted && !startWriter()) {
+					return false;
+				}
+				Buffer = AsyncBuffers + AsyncFillIndex * BufferSize;
+			} else {
+				Buffer = InlineBuffer;
+			}
+#else
+			Buffer = InlineBuffer;
+#endif
+			//The strings in the table were written to the previous file
+			WrittenStrings.clear();
+			//The size in the header is set by finish()
+			JsopPackedHeader header;
+			header.template set<value_type, RootFirst, MinimumAlignmentOnly>(0);
+			memcpy(Buffer, &header, sizeof(header));
 			if (RootFirst) {
-				WrittenSize = sizeof(value_type);
+				WrittenSize = sizeof(JsopPackedHeader) + sizeof(value_type);
 				WrittenBufferSize = 0;
-				FreeBufferSize = BufferSize - sizeof(value_type);
+				FreeBufferSize = BufferSize - (sizeof(JsopPackedHeader) + sizeof(value_type));
 				Handle = handle;
-				ValueBuffer[0].setNull();
+				auto root = value_type::makeNull();
+				memcpy(Buffer + sizeof(JsopPackedHeader), &root, sizeof(root));
 			} else {
-				WrittenSize = 0;
+				WrittenSize = sizeof(JsopPackedHeader);
 				WrittenBufferSize = 0;
-				FreeBufferSize = BufferSize;
+				FreeBufferSize = BufferSize - sizeof(JsopPackedHeader);
 				Handle = handle;
 			}
 			return true;
@@ -159,6 +304,7 @@ public:
 	}
 	bool finish(value_type value) noexcept;
 	void cleanup() noexcept {
+		waitForWrites();
 		Handle = -1;
 	}
 
@@ -186,8 +332,88 @@ public:
 		static_assert(Object::sizeofHeader() == sizeof(size_type), "Object::sizeofHeader() == sizeof(size_type)");
 		return writeSizeData(JsopPackedValueType::Object, n, n * 2 * sizeof(value_type), key_values);
 	}
+	//! Writes an object followed by the hash index of its keys, given the hashes of the keys
+	value_type writeIndexedObject(size_t n, const value_type *key_values, const uint32_t *hashes) noexcept;
 };
 
+#ifdef JSOP_PACKED_FILE_ASYNC_WRITES
+template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t BufferSize, size_t MaxWriteSize, bool RootFirst>
+bool JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, MaxWriteSize, RootFirst>::startWriter() noexcept {
+	static_assert(BufferSize <= SIZE_MAX / JSOP_PACKED_FILE_ASYNC_BUFFERS, "BufferSize <= SIZE_MAX / JSOP_PACKED_FILE_ASYNC_BUFFERS");
+
+	auto buffers = static_cast<char *>(malloc(BufferSize * JSOP_PACKED_FILE_ASYNC_BUFFERS));
+	if (buffers == nullptr) {
+		return false;
+	}
+	if (pthread_mutex_init(&AsyncMutex, nullptr) == 0) {
+		if (pthread_cond_init(&AsyncCond, nullptr) == 0) {
+			AsyncBuffers = buffers;
+			AsyncFillIndex = 0;
+			AsyncWriteIndex = 0;
+			AsyncPendingCount = 0;
+			AsyncStop = false;
+			AsyncFailed = false;
+			if (pthread_create(&AsyncThread, nullptr, writeBuffers, this) == 0) {
+				AsyncStarted = true;
+				return true;
+			}
+			AsyncBuffers = nullptr;
+			pthread_cond_destroy(&AsyncCond);
+		}
+		pthread_mutex_destroy(&AsyncMutex);
+	}
+	free(buffers);
+	return false;
+}
+
+template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t BufferSize, size_t MaxWriteSize, bool RootFirst>
+void JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, MaxWriteSize, RootFirst>::stopWriter() noexcept {
+	pthread_mutex_lock(&AsyncMutex);
+	AsyncStop = true;
+	pthread_cond_broadcast(&AsyncCond);
+	pthread_mutex_unlock(&AsyncMutex);
+	pthread_join(AsyncThread, nullptr);
+	pthread_cond_destroy(&AsyncCond);
+	pthread_mutex_destroy(&AsyncMutex);
+	free(AsyncBuffers);
+	AsyncBuffers = nullptr;
+	AsyncStarted = false;
+	Buffer = InlineBuffer;
+}
+
+template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t BufferSize, size_t MaxWriteSize, bool RootFirst>
+void *JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, MaxWriteSize, RootFirst>::writeBuffers(void *arg) noexcept {
+	auto file = static_cast<JsopPackedFile *>(arg);
+
+	pthread_mutex_lock(&file->AsyncMutex);
+	for (;;) {
+		if (file->AsyncPendingCount != 0) {
+			auto buffer = file->AsyncBuffers + file->AsyncWriteIndex * BufferSize;
+			auto handle = file->Handle;
+			bool failed = file->AsyncFailed;
+			pthread_mutex_unlock(&file->AsyncMutex);
+			//The buffers after one that could not be written are dropped, since the file cannot be valid anymore
+			if (!failed) {
+				failed = writeAll(handle, buffer, BufferSize) < 0;
+			}
+			pthread_mutex_lock(&file->AsyncMutex);
+			if (failed) {
+				file->AsyncFailed = true;
+			}
+			file->AsyncWriteIndex = (file->AsyncWriteIndex + 1) % JSOP_PACKED_FILE_ASYNC_BUFFERS;
+			--file->AsyncPendingCount;
+			pthread_cond_broadcast(&file->AsyncCond);
+		} else if (!file->AsyncStop) {
+			pthread_cond_wait(&file->AsyncCond, &file->AsyncMutex);
+		} else {
+			break;
+		}
+	}
+	pthread_mutex_unlock(&file->AsyncMutex);
+	return nullptr;
+}
+#endif
+
 template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t BufferSize, size_t MaxWriteSize, bool RootFirst>
 bool JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, MaxWriteSize, RootFirst>::writeData(const void *src, size_t n) noexcept {
 	auto free_buffer_size = FreeBufferSize;
@@ -203,7 +429,7 @@ bool JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 				memcpy(Buffer + (BufferSize - free_buffer_size), src, free_buffer_size);
 				src = static_cast<const char *>(src) + free_buffer_size;
 			}
-			if (JSOP_UNLIKELY(writeAll(handle, Buffer, BufferSize) < 0)) {
+			if (JSOP_UNLIKELY(!flushBuffer())) {
 				return false;
 			}
 			if (JSOP_LIKELY(WrittenBufferSize <= TOTAL_SIZE - BufferSize)) {
@@ -219,7 +445,17 @@ bool JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 			return false;
 		}
 
-		if (BufferSize < MaxWriteSize) {
+		if (Buffer != InlineBuffer) {
+			//The writer thread only writes its own buffers, so the data is copied to them
+			while (n >= BufferSize) {
+				n -= BufferSize;
+				memcpy(Buffer, src, BufferSize);
+				src = static_cast<const char *>(src) + BufferSize;
+				if (JSOP_UNLIKELY(!flushBuffer())) {
+					return false;
+				}
+			}
+		} else if (BufferSize < MaxWriteSize) {
 			while (n >= MaxWriteSize) {
 				n -= MaxWriteSize;
 				auto write_rv = writeAll(handle, src, MaxWriteSize);
@@ -284,22 +520,32 @@ bool JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 		}
 	}
 
-	//Write the remaining bytes in the buffer
+	//Write the remaining bytes in the buffer after the buffers passed to the writer thread
+	ok = waitForWrites();
 	assert(FreeBufferSize <= BufferSize);
 	size_t remaining_size = BufferSize - FreeBufferSize;
-	if (remaining_size > 0) {
+	if (ok && remaining_size > 0) {
 		ok = writeAll(handle, Buffer, remaining_size) >= 0;
 		if (ok) {
 			ok = WrittenBufferSize <= TOTAL_SIZE - remaining_size;
 		}
-	} else {
-		ok = true;
 	}
-	//Write the root value
-	if (ok && RootFirst) {
-		ok = lseek64(handle, 0, SEEK_SET) == 0;
-		if (ok) {
-			ok = writeAll(handle, &value, sizeof(value)) >= 0;
+	//Write the header with the size of the file, followed by the root value
+	//The size is left as 0 if the root is last and the file was opened with O_APPEND, where pwrite() would append the header instead
+	if (ok && (RootFirst || (fcntl(handle, F_GETFL) & O_APPEND) == 0)) {
+		struct {
+			JsopPackedHeader Header;
+			value_type Root;
+		} start;
+		static_assert(offsetof(decltype(start), Root) == sizeof(JsopPackedHeader), "offsetof(decltype(start), Root) == sizeof(JsopPackedHeader)");
+
+		start.Header.template set<value_type, RootFirst, MinimumAlignmentOnly>(WrittenSize);
+		start.Root = value;
+		size_t n = RootFirst ? sizeof(JsopPackedHeader) + sizeof(value_type) : sizeof(JsopPackedHeader);
+		ok = pwrite64(handle, &start, n, 0) == static_cast<ssize_t>(n);
+		//The size is left as 0 if the root is last and the file is a pipe
+		if (!ok && !RootFirst && errno == ESPIPE) {
+			ok = true;
 		}
 	}
 	//Close the file
@@ -340,6 +586,15 @@ auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 
 	constexpr size_t alignment = (MinimumAlignmentOnly || alignof(typename value_type::SmallString) <= MINIMUM_ALIGNMENT) ? MINIMUM_ALIGNMENT : alignof(typename value_type::SmallString);
 
+	uint64_t hash = 0;
+	if (n <= DeduplicateMaxSize) {
+		hash = jsop_hash_string(s, n);
+		auto value = WrittenStrings.find(s, n, hash);
+		if (value != nullptr) {
+			return *value;
+		}
+	}
+
 	auto free_buffer_size = FreeBufferSize;
 	size_t padding_size = free_buffer_size % alignment;
 	size_type byte_offset = WrittenSize + padding_size;
@@ -358,7 +613,12 @@ auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
  		writeData(s, n * sizeof(char)) &&
 		writeSmallData<char, 1>('\0')) {
 		WrittenSize = byte_offset + SmallString::sizeofHeader() + (n + 1) * sizeof(char);
-		return value_type::make(JsopPackedValueType::SmallString, byte_offset / MINIMUM_ALIGNMENT);
+		auto rv = value_type::make(JsopPackedValueType::SmallString, byte_offset / MINIMUM_ALIGNMENT);
+		if (n <= DeduplicateMaxSize) {
+			//The string is still written if it cannot be added
+			WrittenStrings.insert(s, n, hash, rv, true);
+		}
+		return rv;
 	}
 	return value_type::makeNull();
 }
@@ -369,6 +629,15 @@ auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 
 	constexpr size_t alignment = (MinimumAlignmentOnly || alignof(String) <= MINIMUM_ALIGNMENT) ? MINIMUM_ALIGNMENT : alignof(String);
 
+	uint64_t hash = 0;
+	if (n <= DeduplicateMaxSize) {
+		hash = jsop_hash_string(s, n);
+		auto value = WrittenStrings.find(s, n, hash);
+		if (value != nullptr) {
+			return *value;
+		}
+	}
+
 	auto free_buffer_size = FreeBufferSize;
 	size_t padding_size = free_buffer_size % alignment;
 	size_type byte_offset = WrittenSize + padding_size;
@@ -387,7 +656,12 @@ auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
  		writeData(s, n * sizeof(char)) &&
  		writeSmallData<char, 1>('\0')) {
 		WrittenSize = byte_offset + String::sizeofHeader() + (n + 1) * sizeof(char);
-		return value_type::make(JsopPackedValueType::String, byte_offset / MINIMUM_ALIGNMENT);
+		auto rv = value_type::make(JsopPackedValueType::String, byte_offset / MINIMUM_ALIGNMENT);
+		if (n <= DeduplicateMaxSize) {
+			//The string is still written if it cannot be added
+			WrittenStrings.insert(s, n, hash, rv, true);
+		}
+		return rv;
 	}
 	return value_type::makeNull();
 }
@@ -418,4 +692,28 @@ auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, Ma
 	return value_type::makeNull();
 }
 
+template <class ValueType, bool MinimumAlignmentOnly, bool PadWithZero, size_t BufferSize, size_t MaxWriteSize, bool RootFirst>
+auto JsopPackedFile<ValueType, MinimumAlignmentOnly, PadWithZero, BufferSize, MaxWriteSize, RootFirst>::writeIndexedObject(size_t n, const value_type *key_values, const uint32_t *hashes) noexcept -> value_type {
+	assert(ObjectView::hasIndex(n));
+
+	//The index is built in memory and then written after the pairs
+	auto capacity = ObjectView::getIndexCapacity(n);
+	if (capacity > IndexCapacity) {
+		auto *new_start = static_cast<uint32_t *>(realloc(IndexStart, capacity * sizeof(uint32_t)));
+		if (new_start == nullptr) {
+			return value_type::makeNull();
+		}
+		IndexStart = new_start;
+		IndexCapacity = capacity;
+	}
+	jsop_packed_object_make_index(IndexStart, capacity, hashes, n);
+
+	auto rv = writeSizeData(JsopPackedValueType::IndexedObject, n, n * 2 * sizeof(value_type), key_values);
+	if (!rv.isNull() && writeData(IndexStart, capacity * sizeof(uint32_t))) {
+		WrittenSize += capacity * sizeof(uint32_t);
+		return rv;
+	}
+	return value_type::makeNull();
+}
+
 #endif
@@ -0,0 +1,68 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_PACKED_HEADER_H
+#define JSOP_PACKED_HEADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+//! The header at the start of the memory block of a packed document and of a file written by JsopPackedFile, which describes how the
+//! values were written so that a reader with different parameters rejects them
+struct JsopPackedHeader final {
+	enum : uint16_t {
+		//! Written in the byte order of the writer, so it is read as 0x0201 with a different byte order
+		BYTE_ORDER_MARK = 0x0102,
+	};
+
+	enum : uint8_t {
+		CURRENT_VERSION = 1,
+		ROOT_FIRST = 1,
+		//! The numbers, strings, arrays and objects may only be aligned to the minimum alignment instead of the alignment of their type
+		MINIMUM_ALIGNMENT_ONLY = 2,
+	};
+
+	char Magic[4];
+	uint16_t ByteOrder;
+	uint8_t Version;
+	uint8_t Flags;
+	uint8_t SizeTypeSize;
+	uint8_t MinimumAlignmentShift;
+	uint8_t Reserved[6];
+	//! The number of bytes including the header, or 0 if the root is last and the file could not be seeked to write it
+	uint64_t Size;
+
+	constexpr static uint8_t getShift(size_t n) noexcept {
+		return n > 1 ? getShift(n / 2) + 1 : 0;
+	}
+
+	//! Fills the header for the values of the given type
+	template <class ValueType, bool RootFirst, bool MinimumAlignmentOnly>
+	void set(uint64_t size) noexcept {
+		memcpy(Magic, "JSOP", sizeof(Magic));
+		ByteOrder = BYTE_ORDER_MARK;
+		Version = CURRENT_VERSION;
+		Flags = (RootFirst ? ROOT_FIRST : 0) | (MinimumAlignmentOnly ? MINIMUM_ALIGNMENT_ONLY : 0);
+		SizeTypeSize = sizeof(typename ValueType::size_type);
+		MinimumAlignmentShift = getShift(ValueType::MINIMUM_ALIGNMENT);
+		memset(Reserved, 0, sizeof(Reserved));
+		Size = size;
+	}
+
+	//! Checks if the header describes values of the given type in a block of n bytes
+	template <class ValueType, bool RootFirst>
+	bool check(uint64_t n) const noexcept {
+		return memcmp(Magic, "JSOP", sizeof(Magic)) == 0 &&
+			ByteOrder == BYTE_ORDER_MARK &&
+			Version == CURRENT_VERSION &&
+			(Flags & ~MINIMUM_ALIGNMENT_ONLY) == (RootFirst ? ROOT_FIRST : 0) &&
+			SizeTypeSize == sizeof(typename ValueType::size_type) &&
+			MinimumAlignmentShift == getShift(ValueType::MINIMUM_ALIGNMENT) &&
+			(Size == n || (!RootFirst && Size == 0));
+	}
+};
+static_assert(sizeof(JsopPackedHeader) == 24, "sizeof(JsopPackedHeader) == 24");
+
+#endif
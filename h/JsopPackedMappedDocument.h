@@ -0,0 +1,141 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_PACKED_MAPPED_DOCUMENT_H
+#define JSOP_PACKED_MAPPED_DOCUMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "JsopPackedHeader.h"
+#include "JsopPackedValue.h"
+
+//! A file written by JsopPackedFile that is mapped into memory read-only, so its values are used in place and its pages are only read
+//! when they are accessed
+//! The offsets of the values are relative to getStart(), like the offsets of the values of JsopPackedDocument
+template <class ValueType, bool RootFirst = true>
+class JsopPackedMappedDocument {
+public:
+	typedef ValueType value_type;
+	typedef typename value_type::size_type size_type;
+
+private:
+	const void *Start;
+	size_t Size;
+
+public:
+	constexpr JsopPackedMappedDocument() noexcept : Start(nullptr), Size(0) {
+	}
+	~JsopPackedMappedDocument() noexcept {
+		close();
+	}
+
+	JsopPackedMappedDocument(const JsopPackedMappedDocument &) = delete;
+	JsopPackedMappedDocument &operator =(const JsopPackedMappedDocument &) = delete;
+
+	//! Maps the whole file with the given name, and passes the advice (such as MADV_RANDOM or MADV_WILLNEED) to madvise() unless it is
+	//! MADV_NORMAL
+	//! Returns false if the file cannot be opened or mapped, or its header does not match the value type and RootFirst (the values are
+	//! not checked, see JsopPackedValidator)
+	bool open(const char *name, int advice = MADV_NORMAL) noexcept {
+		int fd = ::open(name, O_RDONLY | O_CLOEXEC);
+		if (fd >= 0) {
+			bool ok = map(fd, advice);
+			::close(fd);
+			return ok;
+		}
+		return false;
+	}
+
+	//! Maps the whole file of an open file descriptor, which can be closed afterwards
+	bool map(int fd, int advice = MADV_NORMAL) noexcept;
+
+	//! Unmaps the file, which invalidates all the pointers to its values
+	void close() noexcept {
+		if (Start != nullptr) {
+			munmap(const_cast<void *>(Start), Size);
+			Start = nullptr;
+			Size = 0;
+		}
+	}
+
+	//! Passes the advice to madvise() for the whole file
+	bool advise(int advice) noexcept {
+		return Start != nullptr && madvise(const_cast<void *>(Start), Size, advice) == 0;
+	}
+
+	//! Passes the advice to madvise() for the pages that hold the n bytes at the given address of the file, such as MADV_WILLNEED for
+	//! the values of a large array that are about to be read
+	bool advise(const void *start, size_t n, int advice) noexcept;
+
+	const value_type *get() const noexcept {
+		if (RootFirst) {
+			return reinterpret_cast<const value_type *>(static_cast<const char *>(Start) + sizeof(JsopPackedHeader));
+		} else {
+			return reinterpret_cast<const value_type *>(static_cast<const char *>(Start) + Size - sizeof(value_type));
+		}
+	}
+
+	const void *getStart() const noexcept {
+		return Start;
+	}
+
+	const void *getEnd() const noexcept {
+		return static_cast<const char *>(Start) + Size;
+	}
+
+	size_t size() const noexcept {
+		return Size;
+	}
+};
+
+template <class ValueType, bool RootFirst>
+bool JsopPackedMappedDocument<ValueType, RootFirst>::map(int fd, int advice) noexcept {
+	struct stat st;
+
+	close();
+	if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(sizeof(JsopPackedHeader) + sizeof(value_type)) && static_cast<uint64_t>(st.st_size) <= SIZE_MAX) {
+		auto n = static_cast<size_t>(st.st_size);
+		auto start = mmap(nullptr, n, PROT_READ, MAP_SHARED, fd, 0);
+		if (start != MAP_FAILED) {
+			if (!static_cast<const JsopPackedHeader *>(start)->template check<value_type, RootFirst>(n)) {
+				munmap(start, n);
+				return false;
+			}
+
+			//The hint only affects the performance, so the file is still mapped if it fails
+			if (advice != MADV_NORMAL) {
+				madvise(start, n, advice);
+			}
+			Start = start;
+			Size = n;
+			return true;
+		}
+	}
+	return false;
+}
+
+template <class ValueType, bool RootFirst>
+bool JsopPackedMappedDocument<ValueType, RootFirst>::advise(const void *start, size_t n, int advice) noexcept {
+	auto *map_start = static_cast<const char *>(Start);
+	auto *p = static_cast<const char *>(start);
+	if (map_start != nullptr && p >= map_start && p < map_start + Size) {
+		//madvise() requires the address to be aligned to a page
+		auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+		size_t offset = p - map_start;
+		size_t page_offset = (offset / page_size) * page_size;
+		if (n > Size - offset) {
+			n = Size - offset;
+		}
+		return madvise(const_cast<char *>(map_start + page_offset), n + (offset - page_offset), advice) == 0;
+	}
+	return false;
+}
+
+#endif
@@ -0,0 +1,279 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_PACKED_VALIDATOR_H
+#define JSOP_PACKED_VALIDATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsopAllocator.h"
+#include "JsopDefines.h"
+#include "JsopPackedDocument.h"
+#include "JsopPackedHeader.h"
+#include "JsopPackedMappedDocument.h"
+#include "JsopPackedValue.h"
+#include "JsopStack.h"
+
+//! Checks that the header of a packed document or file matches the value type, and that every value, string, array and object that can
+//! be reached from the root lies within the memory block, so the block can be read without any other checks afterwards
+//! Arrays and objects are written after their children, so each one must be before the previous one when the children are visited from
+//! last to first, which also rejects cycles and arrays or objects that are referred to more than once
+//! Each value is checked once, so the time is proportional to the size of the block
+template <class ValueType>
+class JsopPackedValidator final {
+public:
+	typedef ValueType value_type;
+	typedef typename value_type::size_type size_type;
+	typedef typename value_type::TinyString TinyString;
+	typedef typename value_type::SmallString SmallString;
+	typedef typename value_type::String String;
+	typedef typename value_type::Array Array;
+	typedef typename value_type::Object Object;
+	typedef typename value_type::ObjectView ObjectView;
+
+private:
+	//! An array or object whose values are checked from the last one, where the values of an object alternate between keys and values
+	struct Context {
+		const value_type *Start;
+		const value_type *Next;
+		bool Object;
+	};
+
+	Context *StackStart;
+	Context *StackEnd;
+	Context *StackAllocEnd;
+	const JsopAllocator *Allocator;
+
+	//! Pushes the context of an array or object with the given values
+	bool push(const value_type *start, const value_type *end, bool object) noexcept;
+
+	//! Checks that the data of a string is within n bytes of base and is followed by a null character
+	static bool checkStringData(const char *base, uint64_t n, uint64_t offset, uint64_t size) noexcept {
+		return size < n - offset && base[offset + size] == '\0';
+	}
+
+	//! Checks that the hash index of an object with n keys fits in the given number of bytes, that its slots refer to pairs of the object,
+	//! and that it has empty slots so that the search for a key stops
+	static bool checkIndex(const char *start, uint64_t size, size_t n) noexcept {
+		if (!ObjectView::hasIndex(n)) {
+			return false;
+		}
+		auto capacity = ObjectView::getIndexCapacity(n);
+		if (capacity > size / sizeof(uint32_t)) {
+			return false;
+		}
+
+		size_t count = 0;
+		for (size_t i = 0; i < capacity; ++i) {
+			uint32_t slot;
+			memcpy(&slot, start + i * sizeof(uint32_t), sizeof(slot));
+			if (slot != 0) {
+				if (slot > n) {
+					return false;
+				}
+				++count;
+			}
+		}
+		return count < capacity;
+	}
+
+public:
+	JsopPackedValidator() noexcept : StackStart(nullptr), StackEnd(nullptr), StackAllocEnd(nullptr), Allocator(&jsop_malloc_allocator) {
+	}
+	~JsopPackedValidator() {
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+	}
+
+	JsopPackedValidator(const JsopPackedValidator &) = delete;
+	JsopPackedValidator &operator =(const JsopPackedValidator &) = delete;
+
+	//! Releases the stack, and allocates it again with the given allocator when it is needed
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+		StackStart = nullptr;
+		StackEnd = nullptr;
+		StackAllocEnd = nullptr;
+		Allocator = allocator;
+	}
+
+	//! Checks a block of n bytes written by JsopPackedAllocator or JsopPackedFile with the same RootFirst, and returns false if it is
+	//! not valid or the stack cannot be allocated
+	template <bool RootFirst = true>
+	bool validate(const void *start, size_t n) noexcept;
+
+	template <bool RootFirst>
+	bool validate(const JsopPackedDocument<value_type, RootFirst> &doc) noexcept {
+		if (doc.getStart() != nullptr) {
+			return validate<RootFirst>(doc.getStart(), static_cast<const char *>(doc.getEnd()) - static_cast<const char *>(doc.getStart()));
+		}
+		return false;
+	}
+
+	template <bool RootFirst>
+	bool validate(const JsopPackedMappedDocument<value_type, RootFirst> &doc) noexcept {
+		if (doc.getStart() != nullptr) {
+			return validate<RootFirst>(doc.getStart(), doc.size());
+		}
+		return false;
+	}
+};
+
+template <class ValueType>
+bool JsopPackedValidator<ValueType>::push(const value_type *start, const value_type *end, bool object) noexcept {
+	if (JSOP_UNLIKELY(StackEnd == StackAllocEnd) && !jsop_stack_grow(Allocator, &StackStart, &StackEnd, &StackAllocEnd, JSOP_VALIDATOR_STACK_MIN_SIZE)) {
+		return false;
+	}
+	StackEnd->Start = start;
+	StackEnd->Next = end;
+	StackEnd->Object = object;
+	++StackEnd;
+	return true;
+}
+
+template <class ValueType>
+template <bool RootFirst>
+bool JsopPackedValidator<ValueType>::validate(const void *start, size_t n) noexcept {
+	JsopPackedHeader header;
+	const value_type *current;
+	uint64_t last_offset;
+	bool aligned;
+	bool key;
+
+	if (n < sizeof(JsopPackedHeader) + sizeof(value_type)) {
+		return false;
+	}
+	memcpy(&header, start, sizeof(header));
+	if (!header.template check<value_type, RootFirst>(n)) {
+		return false;
+	}
+
+	//Unless the writer only used the minimum alignment, the values are aligned like the writer aligns them, so they can be read directly
+	aligned = (header.Flags & JsopPackedHeader::MINIMUM_ALIGNMENT_ONLY) == 0;
+	if (!RootFirst && aligned && (n - sizeof(value_type)) % sizeof(value_type) != 0) {
+		return false;
+	}
+
+	auto base = static_cast<const char *>(start);
+	if (RootFirst) {
+		current = reinterpret_cast<const value_type *>(base + sizeof(JsopPackedHeader));
+	} else {
+		current = reinterpret_cast<const value_type *>(base + n - sizeof(value_type));
+	}
+	last_offset = n;
+	key = false;
+	StackEnd = StackStart;
+	for (;;) {
+		auto type = current->getType();
+		uint64_t offset = current->getByteOffset();
+
+		if (key && type != JsopPackedValueType::TinyString && type != JsopPackedValueType::SmallString && type != JsopPackedValueType::String) {
+			return false;
+		}
+
+		switch (type) {
+		case JsopPackedValueType::Null:
+		case JsopPackedValueType::Bool:
+		case JsopPackedValueType::PackedInt:
+		case JsopPackedValueType::PackedUint:
+			break;
+
+		case JsopPackedValueType::PackedDouble:
+			if (sizeof(size_type) < sizeof(double)) {
+				return false;
+			}
+			break;
+
+		case JsopPackedValueType::FullInt64:
+		case JsopPackedValueType::FullUint64:
+		case JsopPackedValueType::FullDouble:
+			if (offset > n - sizeof(uint64_t) || (aligned && offset % sizeof(uint64_t) != 0)) {
+				return false;
+			}
+			break;
+
+		case JsopPackedValueType::TinyString: {
+			TinyString s;
+			memcpy(&s, current, sizeof(s));
+			if (s.size() >= sizeof(s.Data) || s.Data[s.size()] != '\0') {
+				return false;
+			}
+			break;
+		}
+
+		case JsopPackedValueType::SmallString: {
+			typename SmallString::size_type size;
+			if (offset > n - SmallString::sizeofHeader()) {
+				return false;
+			}
+			memcpy(&size, base + offset, sizeof(size));
+			if (!checkStringData(base, n, offset + SmallString::sizeofHeader(), size)) {
+				return false;
+			}
+			break;
+		}
+
+		case JsopPackedValueType::String: {
+			typename String::size_type size;
+			if (offset > n - String::sizeofHeader() || (aligned && offset % alignof(String) != 0)) {
+				return false;
+			}
+			memcpy(&size, base + offset, sizeof(size));
+			if (!checkStringData(base, n, offset + String::sizeofHeader(), size)) {
+				return false;
+			}
+			break;
+		}
+
+		case JsopPackedValueType::Array:
+		case JsopPackedValueType::Object:
+		case JsopPackedValueType::IndexedObject: {
+			static_assert(Array::sizeofHeader() == Object::sizeofHeader(), "Array::sizeofHeader() == Object::sizeofHeader()");
+
+			size_type size;
+			bool object = type != JsopPackedValueType::Array;
+			if (offset >= last_offset || offset > n - Array::sizeofHeader() || (aligned && offset % alignof(size_type) != 0)) {
+				return false;
+			}
+			memcpy(&size, base + offset, sizeof(size));
+			uint64_t capacity = (n - offset - Array::sizeofHeader()) / sizeof(value_type);
+			if (size > (object ? capacity / 2 : capacity)) {
+				return false;
+			}
+			uint64_t number_of_values = object ? static_cast<uint64_t>(size) * 2 : size;
+			if (type == JsopPackedValueType::IndexedObject && !checkIndex(base + offset + Array::sizeofHeader() + number_of_values * sizeof(value_type), n - offset - Array::sizeofHeader() - number_of_values * sizeof(value_type), size)) {
+				return false;
+			}
+			auto values = reinterpret_cast<const value_type *>(base + offset + Array::sizeofHeader());
+			if (!push(values, values + number_of_values, object)) {
+				return false;
+			}
+			last_offset = offset;
+			break;
+		}
+
+		default:
+			return false;
+		}
+
+		//Move to the previous value of the innermost array or object that has any left
+		for (;;) {
+			auto stack_end = StackEnd;
+			if (stack_end == StackStart) {
+				return true;
+			}
+			auto &context = stack_end[-1];
+			if (context.Next != context.Start) {
+				current = --context.Next;
+				key = context.Object && ((current - context.Start) % 2) == 0;
+				break;
+			}
+			StackEnd = stack_end - 1;
+		}
+	}
+}
+
+#endif
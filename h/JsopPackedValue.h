@@ -16,6 +16,7 @@
 #include <type_traits>
 
 #include "JsopDefines.h"
+#include "JsopHash.h"
 
 enum class JsopPackedValueType : unsigned {
 	Null,
@@ -31,7 +32,9 @@ enum class JsopPackedValueType : unsigned {
 	String,
 	Array,
 	Object,
-	MaxType = Object
+	//! An object whose pairs are followed by a hash index of its keys
+	IndexedObject,
+	MaxType = IndexedObject
 };
 
 template <typename SizeType = uint32_t, size_t MinimumAlignment = 1>
@@ -143,9 +146,40 @@ public:
 private:
 	const value_type *Start;
 	const value_type *Finish;
+	const uint32_t *Index;
 
 public:
-	constexpr JsopPackedObjectView(const value_type *start, const value_type *finish) noexcept : Start(start), Finish(finish) {
+	constexpr JsopPackedObjectView(const value_type *start, const value_type *finish, const uint32_t *index = nullptr) noexcept : Start(start), Finish(finish), Index(index) {
+	}
+
+	//! Checks if an object with n keys can be written with a hash index of its keys
+	static constexpr bool hasIndex(size_t n) noexcept {
+		return n >= JSOP_OBJECT_INDEX_MIN_SIZE && n <= (UINT32_MAX >> 2);
+	}
+
+	//! Gets the number of slots in the hash index of an object with n keys, which is a power of 2 at least twice the number of keys
+	static size_t getIndexCapacity(size_t n) noexcept {
+		size_t capacity;
+
+		assert(hasIndex(n));
+		capacity = JSOP_OBJECT_INDEX_MIN_SIZE * 2;
+		while (capacity < n * 2) {
+			capacity *= 2;
+		}
+		return capacity;
+	}
+
+	//! Gets the hash index of the keys, or nullptr if the object does not have one
+	const uint32_t *getIndex() const noexcept {
+		return Index;
+	}
+
+	//! Finds the first pair with the given key, where the offsets of the keys are relative to base, and returns nullptr if there is none
+	//! Uses the hash index of the object if there is one, or compares the keys one by one
+	JSOP_INLINE const value_type *find(const char *key, size_t n, const void *base) const noexcept;
+
+	const value_type *find(const char *key, const void *base) const noexcept {
+		return find(key, strlen(key), base);
 	}
 
 	JSOP_INLINE size_type size() const noexcept;
@@ -171,6 +205,7 @@ public:
 	typedef JsopPackedString<SizeType> String;
 	typedef JsopPackedArray<SizeType, MinimumAlignment> Array;
 	typedef JsopPackedObject<SizeType, MinimumAlignment> Object;
+	typedef JsopPackedObjectView<SizeType, MinimumAlignment> ObjectView;
 
 	enum : size_t {
 		MINIMUM_ALIGNMENT = MinimumAlignment,
@@ -403,7 +438,7 @@ public:
 	}
 
 	bool isObject() const noexcept {
-		return getType() == JsopPackedValueType::Object;
+		return getType() == JsopPackedValueType::Object || getType() == JsopPackedValueType::IndexedObject;
 	}
 
 	bool isPartialArray() const noexcept {
@@ -669,10 +704,15 @@ JSOP_INLINE JsopPackedArrayView<SizeType, MinimumAlignment> JsopPackedValue<Size
 
 template <typename SizeType, size_t MinimumAlignment>
 JSOP_INLINE JsopPackedObjectView<SizeType, MinimumAlignment> JsopPackedValue<SizeType, MinimumAlignment>::getObjectView(const void *base) const noexcept {
-	assert(getType() == JsopPackedValueType::Object);
+	assert(isObject());
 
 	const auto *object = getPointer<Object>(base);
-	return JsopPackedObjectView<SizeType, MinimumAlignment>(object->Data, object->Data + object->Size);
+	const uint32_t *index = nullptr;
+	if (getType() == JsopPackedValueType::IndexedObject) {
+		//The slots of the index follow the pairs
+		index = reinterpret_cast<const uint32_t *>(object->Data + object->Size);
+	}
+	return JsopPackedObjectView<SizeType, MinimumAlignment>(object->Data, object->Data + object->Size, index);
 }
 
 template <typename SizeType, size_t MinimumAlignment>
@@ -695,6 +735,7 @@ JSOP_INLINE auto JsopPackedValue<SizeType, MinimumAlignment>::size(const void *b
 		return getPointer<Array>(base)->Size;
 
 	case JsopPackedValueType::Object:
+	case JsopPackedValueType::IndexedObject:
 		return getPointer<Object>(base)->Size;
 
 	default:
@@ -725,4 +766,44 @@ JSOP_INLINE auto JsopPackedObjectView<SizeType, MinimumAlignment>::operator [](s
 	return Start[i];
 }
 
+template <typename SizeType, size_t MinimumAlignment>
+JSOP_INLINE auto JsopPackedObjectView<SizeType, MinimumAlignment>::find(const char *key, size_t n, const void *base) const noexcept -> const value_type * {
+	auto index = Index;
+	if (index != nullptr) {
+		//The slots of the index hold the position of a pair plus 1, or 0 if they are empty
+		auto mask = getIndexCapacity(size()) - 1;
+		for (auto i = static_cast<size_t>(static_cast<uint32_t>(jsop_hash_string(key, n))) & mask; index[i] != 0; i = (i + 1) & mask) {
+			auto key_value = Start + (index[i] - 1);
+			auto view = key_value->Key.toStringView(base);
+			if (view.size() == n && memcmp(view.begin(), key, n) == 0) {
+				return key_value;
+			}
+		}
+	} else {
+		for (auto key_value = Start; key_value != Finish; ++key_value) {
+			auto view = key_value->Key.toStringView(base);
+			if (view.size() == n && memcmp(view.begin(), key, n) == 0) {
+				return key_value;
+			}
+		}
+	}
+	return nullptr;
+}
+
+//! Writes the hash index of an object with n keys to the given number of slots (JsopPackedObjectView::getIndexCapacity(n)), given the
+//! hashes of its keys (the low 32 bits of jsop_hash_string())
+JSOP_INLINE void jsop_packed_object_make_index(uint32_t *index, size_t capacity, const uint32_t *hashes, size_t n) noexcept {
+	size_t mask = capacity - 1;
+
+	//Insert the keys in order with linear probing, so the first of duplicate keys is found first
+	memset(index, 0, sizeof(uint32_t) * (mask + 1));
+	for (size_t i = 0; i < n; ++i) {
+		auto j = static_cast<size_t>(hashes[i]) & mask;
+		while (index[j] != 0) {
+			j = (j + 1) & mask;
+		}
+		index[j] = static_cast<uint32_t>(i + 1);
+	}
+}
+
 #endif
@@ -0,0 +1,258 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_PACKED_WRITER_H
+#define JSOP_PACKED_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "JsopDefines.h"
+#include "JsopPackedDocument.h"
+#include "JsopPackedMappedDocument.h"
+#include "JsopPackedValue.h"
+#include "JsopStack.h"
+#include "JsopWriter.h"
+
+//! Serializes packed values as compact JSON directly from the memory block of a packed document or the contents of a packed file,
+//! without converting them to a JsopValue first
+template <class ValueType>
+class JsopPackedWriter final {
+public:
+	typedef ValueType value_type;
+	typedef typename value_type::size_type size_type;
+	typedef typename value_type::Array Array;
+	typedef typename value_type::Object Object;
+
+private:
+	//! An array or object that is being written, where the values of an object alternate between keys and values
+	struct Context {
+		const value_type *Next;
+		const value_type *End;
+		bool Object;
+	};
+
+	JsopWriter Writer;
+	Context *StackStart;
+	Context *StackEnd;
+	Context *StackAllocEnd;
+
+	//! Pushes the context of an array or object with the given values
+	bool push(const value_type *next, const value_type *end, bool object) noexcept;
+
+public:
+	JsopPackedWriter() noexcept : StackStart(nullptr), StackEnd(nullptr), StackAllocEnd(nullptr) {
+	}
+	~JsopPackedWriter() {
+		jsop_release(Writer.Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+	}
+
+	JsopPackedWriter(const JsopPackedWriter &) = delete;
+	JsopPackedWriter &operator =(const JsopPackedWriter &) = delete;
+
+	//! Releases the buffer and the stack, and allocates them again with the given allocator when they are needed, which discards the
+	//! characters in the buffer
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Writer.Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+		StackStart = nullptr;
+		StackEnd = nullptr;
+		StackAllocEnd = nullptr;
+		Writer.setAllocator(allocator);
+	}
+
+	const char *getStart() const noexcept {
+		return Writer.getStart();
+	}
+
+	const char *getEnd() const noexcept {
+		return Writer.getEnd();
+	}
+
+	size_t size() const noexcept {
+		return Writer.size();
+	}
+
+	//! Discards the characters in the buffer
+	void clear() noexcept {
+		Writer.clear();
+	}
+
+	//! Sets the file descriptor that the buffer is written to when it becomes full and by flush(), or -1 to keep all the characters in
+	//! the buffer
+	void setFile(int fd) noexcept {
+		Writer.setFile(fd);
+	}
+
+	//! Appends the given value and all its children as compact JSON, where the offsets of the values are relative to base, and returns
+	//! false if the buffer cannot be allocated or the file cannot be written
+	//! Numbers that are infinite or NaN are written as null
+	bool write(const value_type &value, const void *base) noexcept;
+
+	//! Appends the root value of the given document
+	template <bool RootFirst>
+	bool write(const JsopPackedDocument<value_type, RootFirst> &doc) noexcept {
+		if (doc.getStart() != nullptr) {
+			return write(*doc.get(), doc.getStart());
+		}
+		return false;
+	}
+
+	//! Appends the root value of a mapped file
+	template <bool RootFirst>
+	bool write(const JsopPackedMappedDocument<value_type, RootFirst> &doc) noexcept {
+		if (doc.getStart() != nullptr) {
+			return write(*doc.get(), doc.getStart());
+		}
+		return false;
+	}
+
+	//! Appends the root value of the contents of a file of n bytes written by JsopPackedFile with the same RootFirst
+	template <bool RootFirst = true>
+	bool writeFile(const void *start, size_t n) noexcept {
+		if (n >= sizeof(JsopPackedHeader) + sizeof(value_type)) {
+			const value_type *root;
+			if (RootFirst) {
+				root = reinterpret_cast<const value_type *>(static_cast<const char *>(start) + sizeof(JsopPackedHeader));
+			} else {
+				root = reinterpret_cast<const value_type *>(static_cast<const char *>(start) + n - sizeof(value_type));
+			}
+			return write(*root, start);
+		}
+		return false;
+	}
+
+	//! Writes the characters in the buffer to the file and clears the buffer, or keeps them if there is no file
+	bool flush() noexcept {
+		return Writer.flush();
+	}
+};
+
+template <class ValueType>
+bool JsopPackedWriter<ValueType>::push(const value_type *next, const value_type *end, bool object) noexcept {
+	if (JSOP_UNLIKELY(StackEnd == StackAllocEnd) && !jsop_stack_grow(Writer.Allocator, &StackStart, &StackEnd, &StackAllocEnd, JSOP_WRITER_STACK_MIN_SIZE)) {
+		return false;
+	}
+	StackEnd->Next = next;
+	StackEnd->End = end;
+	StackEnd->Object = object;
+	++StackEnd;
+	return true;
+}
+
+template <class ValueType>
+bool JsopPackedWriter<ValueType>::write(const value_type &value, const void *base) noexcept {
+	const value_type *current;
+	const value_type *values;
+	size_t n;
+	bool ok;
+
+	current = &value;
+	StackEnd = StackStart;
+	for (;;) {
+		switch (current->getType()) {
+		case JsopPackedValueType::Null:
+			ok = Writer.append("null", 4);
+			break;
+
+		case JsopPackedValueType::Bool:
+			if (current->getBool()) {
+				ok = Writer.append("true", 4);
+			} else {
+				ok = Writer.append("false", 5);
+			}
+			break;
+
+		case JsopPackedValueType::PackedInt:
+		case JsopPackedValueType::FullInt64: {
+			auto integer = current->toInt64(base);
+			ok = Writer.writeInteger(integer < 0 ? -static_cast<uint64_t>(integer) : static_cast<uint64_t>(integer), integer < 0);
+			break;
+		}
+
+		case JsopPackedValueType::PackedUint:
+		case JsopPackedValueType::FullUint64:
+			ok = Writer.writeInteger(current->toUint64(base), false);
+			break;
+
+		case JsopPackedValueType::PackedDouble:
+			ok = Writer.writeDouble(current->getPackedDouble());
+			break;
+
+		case JsopPackedValueType::FullDouble:
+			ok = Writer.writeDouble(current->getFullDouble(base));
+			break;
+
+		case JsopPackedValueType::TinyString:
+		case JsopPackedValueType::SmallString:
+		case JsopPackedValueType::String: {
+			auto view = current->toStringView(base);
+			ok = Writer.writeString(view.begin(), view.end());
+			break;
+		}
+
+		case JsopPackedValueType::Array: {
+			const auto *array = current->template getPointer<Array>(base);
+			n = array->Size;
+			if (n != 0) {
+				values = array->Data;
+				if (!Writer.append('[') || !push(values + 1, values + n, false)) {
+					return false;
+				}
+				current = values;
+				continue;
+			}
+			ok = Writer.append("[]", 2);
+			break;
+		}
+
+		case JsopPackedValueType::Object:
+		case JsopPackedValueType::IndexedObject: {
+			const auto *object = current->template getPointer<Object>(base);
+			n = object->Size;
+			if (n != 0) {
+				//The keys and values of an object are stored as consecutive values
+				values = &object->Data[0].Key;
+				if (!Writer.append('{') || !push(values + 1, values + n * 2, true)) {
+					return false;
+				}
+				current = values;
+				continue;
+			}
+			ok = Writer.append("{}", 2);
+			break;
+		}
+
+		default:
+			ok = false;
+			break;
+		}
+		if (!ok) {
+			return false;
+		}
+
+		//Move to the next value, closing the arrays and objects that have no values left
+		for (;;) {
+			if (StackEnd == StackStart) {
+				return true;
+			}
+			auto context = StackEnd - 1;
+			if (context->Next != context->End) {
+				//An odd number of values left in an object means that the next one is the value of a key
+				if (!Writer.append(context->Object && ((context->End - context->Next) & 1) != 0 ? ':' : ',')) {
+					return false;
+				}
+				current = context->Next;
+				context->Next = current + 1;
+				break;
+			}
+			if (!Writer.append(context->Object ? '}' : ']')) {
+				return false;
+			}
+			StackEnd = context;
+		}
+	}
+}
+
+#endif
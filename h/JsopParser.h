@@ -12,20 +12,24 @@
 
 #include <utility>
 
-#ifdef __SSE2__
-#include <emmintrin.h>
-#endif
-
 #include "JsopCodePoint.h"
 #include "JsopDecimal.h"
 #include "JsopDefines.h"
 #include "JsopDocumentHandler.h"
 #include "JsopMemoryPools.h"
+#include "JsopSimd.h"
 #include "JsopStringBuffer.h"
+#include "JsopUnescape.h"
+
+#if JSOP_PARSE_STRING_SIMD_WIDTH >= 32
+#include <immintrin.h>
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 16
+#include <emmintrin.h>
+#endif
 
 #ifdef JSOP_PARSE_STRING_MULTI_BYTE_COPY
 
-#ifdef __SSE2__
+#if JSOP_PARSE_STRING_SIMD_WIDTH >= 16
 
 template <typename T>
 struct JsopCountTrailingZerosReturnType {
@@ -45,6 +49,22 @@ JSOP_INLINE JsopCountTrailingZerosReturnType<uint32_t> jsop_count_trailing_zeros
 		return { count, zero_value };
 }
 
+#if JSOP_PARSE_STRING_SIMD_WIDTH == 64
+
+//! x86-64 bit scan forward instruction
+JSOP_INLINE JsopCountTrailingZerosReturnType<uint64_t> jsop_count_trailing_zeros(uint64_t value) noexcept {
+		uint64_t count;
+		bool zero_value;
+
+		asm ("bsfq %2, %1"
+				: "=@ccz" (zero_value), "=r" (count)
+				: "rm" (value)
+				: "cc");
+		return { count, zero_value };
+}
+
+#endif
+
 #endif
 
 #endif
@@ -108,6 +128,10 @@ class JsopParser final : public H {
 		Number,
 		FractionalPartFirstDigit,
 		FractionalPart,
+#ifndef JSOP_IGNORE_OVERFLOW
+		LongNumber,
+		LongFractionalPart,
+#endif
 		ExponentSignOrFirstDigit,
 		ExponentFirstDigit,
 		Exponent,
@@ -219,6 +243,12 @@ class JsopParser final : public H {
 	bool Negate;
 	bool NegateSpecifiedExponent;
 	bool ParsingKey;
+	bool InSitu;
+	bool Padded;
+#ifndef JSOP_IGNORE_OVERFLOW
+	//! Whether the digits of the current number that do not fit in CurrentInteger are in Buffer
+	bool ParsingLongNumber;
+#endif
 #ifndef JSOP_PARSE_TRAILING_COMMA
 	bool CommaBeforeBrace;
 #endif
@@ -235,17 +265,52 @@ class JsopParser final : public H {
 		return H::makeDouble(!negative ? HUGE_VAL : -HUGE_VAL);
 	}
 
+#ifndef JSOP_IGNORE_OVERFLOW
+	//! Appends a digit that does not fit in the integer to the buffer, where the digits past the maximum are only recorded as being
+	//! non-zero in the last digit
+	JSOP_INLINE bool appendLongDigit(char ch) noexcept {
+		if (static_cast<size_t>(Buffer.getEnd() - Buffer.getStart()) <= JSOP_LONG_DECIMAL_MAX_DIGITS) {
+			return Buffer.append(ch);
+		}
+		if (ch != '0') {
+			Buffer.getEnd()[-1] = '1';
+		}
+		return true;
+	}
+#endif
+
+	//! Makes the current decimal number with the given exponent, which is converted to a double precision number unless the handler
+	//! uses lazy numbers
+	JSOP_INLINE bool makeDecimalNumber(int exponent) noexcept(H::NoExceptions) {
+#ifndef JSOP_IGNORE_OVERFLOW
+		if (JSOP_UNLIKELY(ParsingLongNumber)) {
+			ParsingLongNumber = false;
+			return H::makeDouble(jsop_long_decimal_to_double(CurrentInteger, Buffer.getStart(), Buffer.getEnd() - Buffer.getStart(), exponent, Negate));
+		}
+#endif
+		if (H::useLazyNumbers()) {
+			return H::makeDecimal(CurrentInteger, exponent, Negate);
+		}
+		return H::makeDouble(jsop_decimal_to_double(CurrentInteger, exponent, Negate));
+	}
+
 	//! Indicates that the parsing reaches the end of stream and creates the top level value if necessary
 	bool parseEndOfStream() noexcept(H::NoExceptions);
 
 public:
 	template <typename ... A>
-	JSOP_INLINE JsopParser(A && ... args) noexcept(H::NoExceptions) : H(std::forward<A>(args) ...), Buffer(JSOP_STRING_BUFFER_MIN_SIZE / sizeof(char)) {
+	JSOP_INLINE JsopParser(A && ... args) noexcept(H::NoExceptions) : H(std::forward<A>(args) ...), Buffer(JSOP_STRING_BUFFER_MIN_SIZE / sizeof(char)), InSitu(false), Padded(false) {
 	}
 
 	JsopParser(const JsopParser &) = delete;
 	JsopParser &operator =(const JsopParser &) = delete;
 
+	//! Sets the allocator of the handler and of the buffers of the parser, which must not be called while parsing
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		H::setAllocator(allocator);
+		Buffer.setAllocator(allocator);
+	}
+
 	//! Initializes the parser
 	template <typename ... A>
 	JSOP_INLINE bool start(A && ... args) noexcept(H::NoExceptions) {
@@ -256,6 +321,9 @@ public:
 			Column = 1;
 #endif
 			ParsingKey = false;
+#ifndef JSOP_IGNORE_OVERFLOW
+			ParsingLongNumber = false;
+#endif
 #ifndef JSOP_PARSE_TRAILING_COMMA
 			CommaBeforeBrace = false;
 #endif
@@ -299,6 +367,34 @@ public:
 		const char *start) noexcept(H::NoExceptions) {
 		return parse(start, strlen(start));
 	}
+
+	//! Parse the given string, and can be called multiple times (as part of reading a file for example)
+	//! Strings are unescaped and null-terminated in place where possible, so the handler can refer to them instead of copying them,
+	//! and the string must stay valid as long as the values refer to it
+	bool parseInSitu(
+		//! Pointer to the start of the string
+		char *start,
+		//! Pointer to the end of the string
+		char *end) noexcept(H::NoExceptions) {
+		InSitu = true;
+		auto rv = parse(start, end);
+		InSitu = false;
+		return rv;
+	}
+
+	//! Parse the given string, and can be called multiple times (as part of reading a file for example)
+	//! JSOP_INPUT_PADDING characters after the end of the string must be readable, which allows the scans to load whole vectors
+	//! without handling the end of the string separately, and strings to be passed from the input up to the end of the string
+	bool parsePadded(
+		//! Pointer to the start of the string
+		const char *start,
+		//! Pointer to the end of the string
+		const char *end) noexcept(H::NoExceptions) {
+		Padded = true;
+		auto rv = parse(start, end);
+		Padded = false;
+		return rv;
+	}
 };
 
 #ifndef JSOP_PARSE_TRAILING_COMMA
@@ -334,6 +430,15 @@ public:
 	goto state_single_or_multi_line_comment
 #endif
 
+//Converts the 8 characters after the decimal point at once if they are all digits and continues with the unrolled fractional part after
+//them, which ends at the same position as if the digits were converted one at a time
+#define JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(first, next) \
+	if (jsop_decimal_parse_eight_digits(start, &eight_digits)) { \
+		current_integer = current_integer * 100000000 + eight_digits; \
+		goto action_fractional_part_##next##_non_zero_digit; \
+	} \
+	goto action_fractional_part_##first##_non_zero_digit
+
 #define JSOP_PARSER_COMMA_COMMON_ACTION \
 	assert(!H::inTop()); \
 	JSOP_PARSER_SET_COMMA_BEFORE_BRACE(true); \
@@ -384,13 +489,17 @@ bool JsopParser<H>::parseEndOfStream() noexcept(H::NoExceptions) {
 		goto cleanup_on_error;
 
 	case FractionalPart:
-		if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+#ifndef JSOP_IGNORE_OVERFLOW
+	case LongNumber:
+	case LongFractionalPart:
+#endif
+		if (makeDecimalNumber(CurrentExponent)) {
 			break;
 		}
 		goto cleanup_on_error;
 
 	case Exponent:
-		if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+		if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 			break;
 		}
 		goto cleanup_on_error;
@@ -444,14 +553,21 @@ cleanup_on_error:
 
 template <typename H>
 bool JsopParser<H>::parse(const char *start, const char *end) noexcept(H::NoExceptions) {
-#ifdef JSOP_PARSE_STRING_MULTI_BYTE_COPY
+#if defined(JSOP_PARSE_STRING_MULTI_BYTE_COPY) && !defined(JSOP_RUNTIME_DISPATCH)
 
-#ifdef __SSE2__
+#if JSOP_PARSE_STRING_SIMD_WIDTH == 64
+	const auto forward_slash_x64 = _mm512_set1_epi8('\\'), quote_x64 = _mm512_set1_epi8('"'), space_x64 = _mm512_set1_epi8(0x20);
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 32
+	const auto forward_slash_x32 = _mm256_set1_epi8('\\'), quote_x32 = _mm256_set1_epi8('"'), space_x32 = _mm256_set1_epi8(0x20);
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 16
 	const auto forward_slash_x16 = _mm_set1_epi8('\\'), quote_x16 = _mm_set1_epi8('"'), space_x16 = _mm_set1_epi8(0x20);
 #endif
 
 #endif
 
+#ifndef JSOP_PARSER_LOCATION
+	auto skip_whitespace = !Padded ? JsopSimd.SkipWhitespace : JsopSimd.SkipWhitespacePadded;
+#endif
 #ifndef JSOP_IGNORE_OVERFLOW
 	uint64_t old_integer;
 #endif
@@ -487,6 +603,14 @@ dispatch_state:
 	case FractionalPart:
 		goto state_fractional_part;
 
+#ifndef JSOP_IGNORE_OVERFLOW
+	case LongNumber:
+		goto state_long_number;
+
+	case LongFractionalPart:
+		goto state_long_fractional_part;
+#endif
+
 	case ExponentSignOrFirstDigit:
 		goto state_exponent_sign_or_first_digit;
 
@@ -797,8 +921,7 @@ state_start:
 			goto state_literal_t;
 
 		case '"':
-			Buffer.clear();
-			goto state_string_chars;
+			goto action_string_start;
 
 		case '[':
 			if (H::pushArray()) {
@@ -912,7 +1035,7 @@ state_zero:
 		case '.':
 			CurrentInteger = 0;
 			CurrentExponent = 0;
-			goto state_fractional_part;
+			goto action_fractional_part_eight_digits;
 
 		case 'E':
 		case 'e':
@@ -985,6 +1108,7 @@ state_zero:
 action_number_1_non_zero_digit:
 	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 19) {
 		auto current_integer = CurrentInteger;
+		uint32_t eight_digits;
 		ch = start[0];
 		auto old_start = start + 1;
 		auto token_end = old_start + 17;
@@ -1117,61 +1241,61 @@ action_number_1_non_zero_digit:
 											} else {
 												start += 10;
 												if (JSOP_LIKELY(ch == '.')) {
-													goto action_fractional_part_10_non_zero_digit;
+													JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(10, 18);
 												}
 											}
 										} else {
 											start += 9;
 											if (JSOP_LIKELY(ch == '.')) {
-												goto action_fractional_part_9_non_zero_digit;
+												JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(9, 17);
 											}
 										}
 									} else {
 										start += 8;
 										if (JSOP_LIKELY(ch == '.')) {
-											goto action_fractional_part_8_non_zero_digit;
+											JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(8, 16);
 										}
 									}
 								} else {
 									start += 7;
 									if (JSOP_LIKELY(ch == '.')) {
-										goto action_fractional_part_7_non_zero_digit;
+										JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(7, 15);
 									}
 								}
 							} else {
 								start += 6;
 								if (JSOP_LIKELY(ch == '.')) {
-									goto action_fractional_part_6_non_zero_digit;
+									JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(6, 14);
 								}
 							}
 						} else {
 							start += 5;
 							if (JSOP_LIKELY(ch == '.')) {
-								goto action_fractional_part_5_non_zero_digit;
+								JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(5, 13);
 							}
 						}
 					} else {
 						start += 4;
 						if (JSOP_LIKELY(ch == '.')) {
-							goto action_fractional_part_4_non_zero_digit;
+							JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(4, 12);
 						}
 					}
 				} else {
 					start += 3;
 					if (JSOP_LIKELY(ch == '.')) {
-						goto action_fractional_part_3_non_zero_digit;
+						JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(3, 11);
 					}
 				}
 			} else {
 				start += 2;
 				if (JSOP_LIKELY(ch == '.')) {
-					goto action_fractional_part_2_non_zero_digit;
+					JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(2, 10);
 				}
 			}
 		} else {
 			start += 1;
 			if (JSOP_LIKELY(ch == '.')) {
-				goto action_fractional_part_1_non_zero_digit;
+				JSOP_PARSER_FRACTIONAL_PART_EIGHT_DIGITS(1, 9);
 			}
 		}
 
@@ -1416,6 +1540,22 @@ action_fractional_part_non_zero_digit_final:
 		start = token_end;
 		goto action_fractional_part_not_a_digit;
 	}
+
+	//Near the end of the buffer, convert 8 digits at a time while there are enough characters left and the integer cannot overflow, and
+	//leave the rest of the digits to the state that handles one digit at a time
+	while (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 8) {
+		uint32_t eight_digits;
+#ifndef JSOP_IGNORE_OVERFLOW
+		if (CurrentInteger > JSOP_DECIMAL_EIGHT_DIGITS_MAX_INTEGER) {
+			break;
+		}
+#endif
+		if (!jsop_decimal_parse_eight_digits(start, &eight_digits)) {
+			break;
+		}
+		CurrentInteger = CurrentInteger * 100000000 + eight_digits;
+		start += 8;
+	}
 	//Fallthrough to state_number
 
 state_number:
@@ -1437,13 +1577,21 @@ state_number:
 					goto state_number;
 				}
 			}
+			//Keep the rest of the digits in the buffer, and make a double precision number from them at the end
+			CurrentInteger = old_integer;
+			CurrentExponent = 1;
+			ParsingLongNumber = true;
+			Buffer.clear();
+			if (Buffer.append(ch)) {
+				goto state_long_number;
+			}
 			goto cleanup_on_error;
 #endif
 		} else {
 			switch (ch) {
 			case '.':
 				CurrentExponent = 0;
-				goto state_fractional_part;
+				goto action_fractional_part_eight_digits;
 
 			case 'E':
 			case 'e':
@@ -1509,7 +1657,7 @@ state_fractional_part_first_digit:
 		if (JSOP_LIKELY(digit < 10)) {
 			CurrentExponent = -1;
 			CurrentInteger = digit;
-			goto state_fractional_part;
+			goto action_fractional_part_eight_digits;
 		} else {
 			goto cleanup_on_error;
 		}
@@ -1517,6 +1665,23 @@ state_fractional_part_first_digit:
 		JSOP_PARSER_RETURN(FractionalPartFirstDigit);
 	}
 
+action_fractional_part_eight_digits:
+	while (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 8) {
+		uint32_t eight_digits;
+#ifndef JSOP_IGNORE_OVERFLOW
+		if (CurrentInteger > JSOP_DECIMAL_EIGHT_DIGITS_MAX_INTEGER) {
+			break;
+		}
+#endif
+		if (!jsop_decimal_parse_eight_digits(start, &eight_digits)) {
+			break;
+		}
+		CurrentInteger = CurrentInteger * 100000000 + eight_digits;
+		CurrentExponent -= 8;
+		start += 8;
+	}
+	//Fallthrough to state_fractional_part
+
 state_fractional_part:
 	if (start != end) {
 		ch = *start;
@@ -1537,6 +1702,14 @@ state_fractional_part:
 					goto state_fractional_part;
 				}
 			}
+			//Keep the rest of the digits in the buffer, where the exponent is the one before this digit
+			CurrentInteger = old_integer;
+			CurrentExponent += 1;
+			ParsingLongNumber = true;
+			Buffer.clear();
+			if (Buffer.append(ch)) {
+				goto state_long_fractional_part;
+			}
 			goto cleanup_on_error;
 #endif
 		} else {
@@ -1548,7 +1721,7 @@ action_fractional_part_not_a_digit:
 
 			case ',':
 				if (!H::inTop()) {
-					if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+					if (makeDecimalNumber(CurrentExponent)) {
 						JSOP_PARSER_COMMA_COMMON_ACTION;
 					}
 				}
@@ -1556,14 +1729,14 @@ action_fractional_part_not_a_digit:
 
 			case ']':
 				//Add the new value and create the array
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+				if (makeDecimalNumber(CurrentExponent)) {
 					goto action_array_close_brace;
 				}
 				goto cleanup_on_error;
 
 			case '}':
 				//Add the new value and create the array
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+				if (makeDecimalNumber(CurrentExponent)) {
 					goto action_object_close_brace;
 				}
 				goto cleanup_on_error;
@@ -1576,14 +1749,14 @@ action_fractional_part_not_a_digit:
 			case ' ':
 			case '\t':
 			case '\r':
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+				if (makeDecimalNumber(CurrentExponent)) {
 					JSOP_PARSER_PUSH_VALUE_EPILOGUE;
 				}
 				goto cleanup_on_error;
 
 #ifdef JSOP_PARSE_COMMENT
 			case '/':
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent, Negate))) {
+				if (makeDecimalNumber(CurrentExponent)) {
 					JSOP_PARSER_PUSH_VALUE_COMMENT_EPILOGUE;
 				}
 				goto cleanup_on_error;
@@ -1597,6 +1770,97 @@ action_fractional_part_not_a_digit:
 		JSOP_PARSER_RETURN(FractionalPart);
 	}
 
+#ifndef JSOP_IGNORE_OVERFLOW
+state_long_number:
+	if (start != end) {
+		ch = *start;
+		++start;
+		digit = static_cast<unsigned>(ch) - '0';
+		if (JSOP_LIKELY(digit < 10)) {
+			//Each digit of the integer part that does not fit in the integer increases the exponent
+			CurrentExponent += 1;
+			if (appendLongDigit(ch)) {
+				goto state_long_number;
+			}
+			goto cleanup_on_error;
+		} else {
+			switch (ch) {
+			case '.':
+				goto state_long_fractional_part;
+
+			case 'E':
+			case 'e':
+				goto state_exponent_sign_or_first_digit;
+
+			case ',':
+				if (!H::inTop()) {
+					if (makeDecimalNumber(CurrentExponent)) {
+						JSOP_PARSER_COMMA_COMMON_ACTION;
+					}
+				}
+				goto cleanup_on_error;
+
+			case ']':
+				//Add the new value and create the array
+				if (makeDecimalNumber(CurrentExponent)) {
+					goto action_array_close_brace;
+				}
+				goto cleanup_on_error;
+
+			case '}':
+				//Add the new value and create the array
+				if (makeDecimalNumber(CurrentExponent)) {
+					goto action_object_close_brace;
+				}
+				goto cleanup_on_error;
+
+			case '\n':
+#ifdef JSOP_PARSER_LOCATION
+				++cur_line;
+				cur_line_start = start;
+#endif
+			case ' ':
+			case '\t':
+			case '\r':
+				if (makeDecimalNumber(CurrentExponent)) {
+					JSOP_PARSER_PUSH_VALUE_EPILOGUE;
+				}
+				goto cleanup_on_error;
+
+#ifdef JSOP_PARSE_COMMENT
+			case '/':
+				if (makeDecimalNumber(CurrentExponent)) {
+					JSOP_PARSER_PUSH_VALUE_COMMENT_EPILOGUE;
+				}
+				goto cleanup_on_error;
+#endif
+
+			default:
+				goto cleanup_on_error;
+			}
+		}
+	} else {
+		JSOP_PARSER_RETURN(LongNumber);
+	}
+
+state_long_fractional_part:
+	if (start != end) {
+		ch = *start;
+		++start;
+		digit = static_cast<unsigned>(ch) - '0';
+		if (JSOP_LIKELY(digit < 10)) {
+			if (appendLongDigit(ch)) {
+				goto state_long_fractional_part;
+			}
+			goto cleanup_on_error;
+		} else {
+			goto action_fractional_part_not_a_digit;
+		}
+	} else {
+		JSOP_PARSER_RETURN(LongFractionalPart);
+	}
+#endif
+
 state_exponent_sign_or_first_digit:
 	if (start != end) {
 		ch = *start;
@@ -1665,7 +1929,7 @@ state_exponent:
 			switch (ch) {
 			case ',':
 				if (!H::inTop()) {
-					if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+					if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 						JSOP_PARSER_COMMA_COMMON_ACTION;
 					}
 				}
@@ -1673,14 +1937,14 @@ state_exponent:
 
 			case ']':
 				//Add the new value and create the array
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+				if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 					goto action_array_close_brace;
 				}
 				goto cleanup_on_error;
 
 			case '}':
 				//Add the new value and create the array
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+				if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 					goto action_object_close_brace;
 				}
 				goto cleanup_on_error;
@@ -1693,14 +1957,14 @@ state_exponent:
 			case ' ':
 			case '\t':
 			case '\r':
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+				if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 					JSOP_PARSER_PUSH_VALUE_EPILOGUE;
 				}
 				goto cleanup_on_error;
 
 #ifdef JSOP_PARSE_COMMENT
 			case '/':
-				if (H::makeDouble(jsop_decimal_to_double(CurrentInteger, CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent), Negate))) {
+				if (makeDecimalNumber(CurrentExponent + (NegateSpecifiedExponent ? -CurrentSpecifiedExponent : CurrentSpecifiedExponent))) {
 					JSOP_PARSER_PUSH_VALUE_COMMENT_EPILOGUE;
 				}
 				goto cleanup_on_error;
@@ -2552,10 +2816,164 @@ state_end_of_stream:
 		JSOP_PARSER_RETURN(EndOfStream);
 	}
 
+action_string_start:
+	Buffer.clear();
+	//Strings without escape sequences are passed directly from the input if the whole string is in the input, and there are enough
+	//characters after the start of the string (or padding after the input) to allow reading a whole word at a time
+	if (H::useInputStrings() && (Padded || reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 16)) {
+		if (InSitu) {
+			auto string_end = jsop_find_string_end(start, end);
+			if (string_end != nullptr) {
+				//The input is known to be writable when called from parseInSitu()
+				auto string_start = const_cast<char *>(start);
+				auto new_string_end = jsop_unescape_string(string_start, string_start, string_end);
+				start = string_end + 1;
+				if (new_string_end != nullptr) {
+					*new_string_end = '\0';
+					if (H::makeInSituString(string_start, new_string_end, ParsingKey)) {
+						if (!H::inTop()) {
+							if (!ParsingKey) {
+								if (H::inArray()) {
+									goto state_values_separator_or_close;
+								} else {
+									assert(H::inObject());
+									goto state_key_values_separator_or_close;
+								}
+							} else {
+								goto state_key_separator;
+							}
+						}
+						goto state_end_of_stream;
+					}
+				}
+				goto cleanup_on_error;
+			}
+		}
+
+		auto string_start = start;
+		start = jsop_skip_unescaped_string_chars(start, end, Padded);
+		if (start != end && *start == '"') {
+			++start;
+			if (H::makeInputString(string_start, start - 1, ParsingKey)) {
+				if (!H::inTop()) {
+					if (!ParsingKey) {
+						if (H::inArray()) {
+							goto state_values_separator_or_close;
+						} else {
+							assert(H::inObject());
+							goto state_key_values_separator_or_close;
+						}
+					} else {
+						goto state_key_separator;
+					}
+				}
+				goto state_end_of_stream;
+			}
+			goto cleanup_on_error;
+		}
+
+		//Copy the characters before the escape sequence (or the end of the input), and continue with the rest of the string
+		size_t n = start - string_start;
+		if (!Buffer.reserve(n)) {
+			goto cleanup_on_error;
+		}
+		memcpy(Buffer.getEnd(), string_start, n);
+		Buffer.setEnd(Buffer.getEnd() + n);
+	}
+	//Fallthrough to state_string_chars
+
 state_string_chars:
 #ifdef JSOP_PARSE_STRING_MULTI_BYTE_COPY
 
-#ifdef __SSE2__
+#if defined(JSOP_RUNTIME_DISPATCH)
+	static_assert(JSOP_STRING_BUFFER_MIN_SIZE >= 16, "JSOP_STRING_BUFFER_MIN_SIZE >= 16");
+	//Only call the function selected for the processor when there are enough characters to make up for the indirect call
+	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 16) {
+		if (Buffer.resize_if(16)) {
+			size_t n = end - start;
+			auto remaining_capacity = Buffer.getRemainingCapacity();
+			if (n > remaining_capacity) {
+				n = remaining_capacity;
+			}
+
+			auto new_end = Buffer.getEnd();
+			auto copied = JsopSimd.CopyStringChars(new_end, start, n);
+			Buffer.setEnd(new_end + copied);
+			start += copied;
+			if (JSOP_LIKELY(copied == n)) {
+				goto state_string_chars;
+			} else {
+				ch = *start;
+				start++;
+				goto action_string_chars_test_special_chars;
+			}
+		} else {
+			goto cleanup_on_error;
+		}
+	}
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 64
+	static_assert(JSOP_STRING_BUFFER_MIN_SIZE >= 64, "JSOP_STRING_BUFFER_MIN_SIZE >= 64");
+	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 64) {
+		if (Buffer.resize_if(64)) {
+			auto fragment = _mm512_loadu_si512(start);
+
+			//Signed comparison with space also matches bytes >= 0x80, which need to be validated as UTF-8
+			uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, forward_slash_x64) |
+				_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+				_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+			auto new_end = Buffer.getEnd();
+			_mm512_storeu_si512(new_end, fragment);
+
+			auto special_mask_trailing_zeros = jsop_count_trailing_zeros(special_mask);
+			if (JSOP_LIKELY(special_mask_trailing_zeros.ZeroValue)) {
+				Buffer.setEnd(new_end + 64);
+				start += 64;
+				goto state_string_chars;
+			} else {
+				auto special_pos = special_mask_trailing_zeros.Count;
+				Buffer.setEnd(new_end + special_pos);
+				start += special_pos;
+				ch = *start;
+				start++;
+				goto action_string_chars_test_special_chars;
+			}
+		} else {
+			goto cleanup_on_error;
+		}
+	}
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 32
+	static_assert(JSOP_STRING_BUFFER_MIN_SIZE >= 32, "JSOP_STRING_BUFFER_MIN_SIZE >= 32");
+	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 32) {
+		if (Buffer.resize_if(32)) {
+			auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start));
+
+			//AVX2 has no signed less than comparison, so swap the operands of the greater than comparison
+			uint32_t special_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, forward_slash_x32),
+				_mm256_cmpeq_epi8(fragment, quote_x32)),
+				_mm256_cmpgt_epi8(space_x32, fragment)));
+
+			auto new_end = Buffer.getEnd();
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(new_end), fragment);
+
+			auto special_mask_trailing_zeros = jsop_count_trailing_zeros(special_mask);
+			if (JSOP_LIKELY(special_mask_trailing_zeros.ZeroValue)) {
+				Buffer.setEnd(new_end + 32);
+				start += 32;
+				goto state_string_chars;
+			} else {
+				auto special_pos = special_mask_trailing_zeros.Count;
+				Buffer.setEnd(new_end + special_pos);
+				start += special_pos;
+				ch = *start;
+				start++;
+				goto action_string_chars_test_special_chars;
+			}
+		} else {
+			goto cleanup_on_error;
+		}
+	}
+#elif JSOP_PARSE_STRING_SIMD_WIDTH == 16
 	static_assert(JSOP_STRING_BUFFER_MIN_SIZE >= 16, "JSOP_STRING_BUFFER_MIN_SIZE >= 16");
 	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= 16) {
 		if (Buffer.resize_if(16)) {
@@ -3405,8 +3823,7 @@ state_values:
 
 		case '"':
 			JSOP_PARSER_SET_COMMA_BEFORE_BRACE(false);
-			Buffer.clear();
-			goto state_string_chars;
+			goto action_string_start;
 
 		case '[':
 			JSOP_PARSER_SET_COMMA_BEFORE_BRACE(false);
@@ -3436,6 +3853,9 @@ state_values:
 #ifdef JSOP_PARSER_LOCATION
 			++cur_line;
 			cur_line_start = start;
+#else
+			//Skip the indentation that usually follows a new line
+			start = jsop_skip_indentation(start, end, skip_whitespace);
 #endif
 		case ' ':
 		case '\t':
@@ -3470,6 +3890,9 @@ state_values_separator_or_close:
 #ifdef JSOP_PARSER_LOCATION
 			++cur_line;
 			cur_line_start = start;
+#else
+			//Skip the indentation that usually follows a new line
+			start = jsop_skip_indentation(start, end, skip_whitespace);
 #endif
 		case ' ':
 		case '\t':
@@ -3497,8 +3920,7 @@ state_key_values:
 		case '"':
 			ParsingKey = true;
 			JSOP_PARSER_SET_COMMA_BEFORE_BRACE(false);
-			Buffer.clear();
-			goto state_string_chars;
+			goto action_string_start;
 
 		case '}':
 #ifndef JSOP_PARSE_TRAILING_COMMA
@@ -3514,6 +3936,9 @@ state_key_values:
 #ifdef JSOP_PARSER_LOCATION
 			++cur_line;
 			cur_line_start = start;
+#else
+			//Skip the indentation that usually follows a new line
+			start = jsop_skip_indentation(start, end, skip_whitespace);
 #endif
 		case ' ':
 		case '\t':
@@ -3670,6 +4095,9 @@ state_key_values_separator_or_close:
 #ifdef JSOP_PARSER_LOCATION
 			++cur_line;
 			cur_line_start = start;
+#else
+			//Skip the indentation that usually follows a new line
+			start = jsop_skip_indentation(start, end, skip_whitespace);
 #endif
 		case ' ':
 		case '\t':
@@ -0,0 +1,163 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_PRINT_HANDLER_H
+#define JSOP_PRINT_HANDLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "JsopDefines.h"
+#include "JsopEventHandler.h"
+#include "JsopWriter.h"
+
+//! Parser handler that writes the values back as JSON while they are parsed, either compact or indented, without creating a document
+//! Numbers that are infinite or NaN are written as null, and comments are not kept
+class JsopPrintHandler : public JsopEventHandler {
+	JsopWriter Writer;
+	size_t Depth;
+	unsigned Indent;
+	//! Whether no value has been written in the current array or object
+	bool First;
+	//! Whether a key has just been written, so the next value needs no separator
+	bool AfterKey;
+
+	//! Writes a line break followed by the indentation of the current depth
+	bool writeLineBreak() noexcept;
+
+	//! Writes the separator before a value (or key) in the current array or object
+	JSOP_INLINE bool startValue() noexcept {
+		if (AfterKey) {
+			AfterKey = false;
+			return true;
+		}
+		if (inTop()) {
+			return true;
+		}
+		if (!First && !Writer.append(',')) {
+			return false;
+		}
+		First = false;
+		return Indent == 0 || writeLineBreak();
+	}
+
+	//! Writes the closing character of the current array or object that has just been popped
+	bool endContainer(char ch) noexcept;
+
+public:
+	JsopPrintHandler() noexcept : Depth(0), Indent(0), First(false), AfterKey(false) {
+	}
+
+	const char *getStart() const noexcept {
+		return Writer.getStart();
+	}
+
+	const char *getEnd() const noexcept {
+		return Writer.getEnd();
+	}
+
+	size_t size() const noexcept {
+		return Writer.size();
+	}
+
+	//! Discards the characters in the buffer
+	void clear() noexcept {
+		Writer.clear();
+	}
+
+	//! Sets the file descriptor that the buffer is written to when it becomes full and by finish(), or -1 to keep all the characters in
+	//! the buffer
+	void setFile(int fd) noexcept {
+		Writer.setFile(fd);
+	}
+
+	//! Replaces the context stack and the output buffer with ones from the given allocator, which discards the characters in the buffer
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		JsopEventHandler::setAllocator(allocator);
+		Writer.setAllocator(allocator);
+	}
+
+	//! Sets the number of spaces for each level of indentation, or 0 to write compact JSON without any whitespace
+	void setIndent(unsigned indent) noexcept {
+		Indent = indent;
+	}
+
+	//! The strings are written immediately, so they can be passed from the input
+	bool useInputStrings() const noexcept {
+		return true;
+	}
+
+	//! Initialize the parsing
+	bool start() noexcept {
+		Depth = 0;
+		First = false;
+		AfterKey = false;
+		return JsopEventHandler::start();
+	}
+	//! Finish the parsing by writing the rest of the buffer to the file
+	bool finish() noexcept {
+		return Writer.flush();
+	}
+
+	bool makeNull() noexcept {
+		return startValue() && Writer.append("null", 4);
+	}
+
+	bool makeBool(bool value) noexcept {
+		if (startValue()) {
+			return value ? Writer.append("true", 4) : Writer.append("false", 5);
+		}
+		return false;
+	}
+
+	bool makeInteger(uint64_t value, bool negative) noexcept {
+		return startValue() && Writer.writeInteger(value, negative && value != 0);
+	}
+
+	bool makeDouble(double value) noexcept {
+		return startValue() && Writer.writeDouble(value);
+	}
+
+	bool makeString(const char *start, const char *end, bool key) noexcept;
+
+	bool makeInputString(const char *start, const char *end, bool key) noexcept {
+		return makeString(start, end, key);
+	}
+
+	bool makeInSituString(char *start, char *end, bool key) noexcept {
+		return makeString(start, end, key);
+	}
+
+	//! Push an array to the context stack
+	JSOP_INLINE bool pushArray() noexcept {
+		if (startValue() && Writer.append('[') && JsopEventHandler::pushArray()) {
+			++Depth;
+			First = true;
+			return true;
+		}
+		return false;
+	}
+
+	//! Checks if the top of the context stack refers to an array and pops the stack
+	JSOP_INLINE bool popArray() noexcept {
+		return JsopEventHandler::popArray() && endContainer(']');
+	}
+
+	//! Push an object to the context stack
+	JSOP_INLINE bool pushObject() noexcept {
+		if (startValue() && Writer.append('{') && JsopEventHandler::pushObject()) {
+			++Depth;
+			First = true;
+			return true;
+		}
+		return false;
+	}
+
+	//! Checks if the top of the context stack refers to an object and pops the stack
+	JSOP_INLINE bool popObject() noexcept {
+		return JsopEventHandler::popObject() && endContainer('}');
+	}
+};
+
+#endif
@@ -0,0 +1,81 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_SIMD_H
+#define JSOP_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "JsopDefines.h"
+
+//! Instruction set extensions that the scanning functions can be selected for
+enum class JsopSimdLevel : unsigned {
+	Scalar,
+	SSE2,
+	AVX2,
+	AVX512BW
+};
+
+//! Bit masks of the characters in a block of 64 characters, where bit i corresponds to character i of the block
+struct JsopSimdBlockMasks {
+	//! '"'
+	uint64_t Quote;
+	//! '\\'
+	uint64_t Backslash;
+	//! '{', '}', '[', ']', ':' and ','
+	uint64_t Structural;
+};
+
+//! Scanning functions that are selected at startup for the instruction set extensions supported by the processor
+struct JsopSimdFunctions {
+	//! Copies the normal string characters (any character except '"', '\\', control characters and bytes >= 0x80) from src to dest,
+	//! stopping at the first other character or after n characters, and returns the number of characters copied
+	size_t (*CopyStringChars)(char *dest, const char *src, size_t n) noexcept;
+	//! Returns the first character in [start, end) that is not a normal string character, or end if there is none
+	const char *(*SkipStringChars)(const char *start, const char *end) noexcept;
+	//! Same as SkipStringChars, but loads whole vectors past end, so JSOP_INPUT_PADDING characters after end must be readable
+	const char *(*SkipStringCharsPadded)(const char *start, const char *end) noexcept;
+	//! Returns the first character in [start, end) that is not a space, tab, carriage return or line feed, or end if there is none
+	const char *(*SkipWhitespace)(const char *start, const char *end) noexcept;
+	//! Same as SkipWhitespace, but loads whole vectors past end, so JSOP_INPUT_PADDING characters after end must be readable
+	const char *(*SkipWhitespacePadded)(const char *start, const char *end) noexcept;
+	//! Classifies the characters in the given block of 64 characters
+	void (*ClassifyBlock)(const char *block, JsopSimdBlockMasks *masks) noexcept;
+	JsopSimdLevel Level;
+};
+
+extern JsopSimdFunctions JsopSimd;
+
+//! Selects the scanning functions by querying the processor with cpuid
+//! This is done automatically at startup up to AVX2, and only needs to be called again to restrict the functions to the given maximum
+//! level, or to allow JsopSimdLevel::AVX512BW, which is slower than AVX2 on short strings
+void jsop_simd_init(JsopSimdLevel max_level = JsopSimdLevel::AVX2) noexcept;
+
+//! Skips the spaces of the indentation after a new line, where the first 8 characters are checked inline and only longer runs call the
+//! given function (JsopSimd.SkipWhitespace or JsopSimd.SkipWhitespacePadded), since an indirect call costs more than the usual short
+//! indentation
+//! Near the end of the input and after fewer than 8 spaces, any other whitespace characters are left to the caller
+template <typename SkipFunction>
+JSOP_INLINE const char *jsop_skip_indentation(const char *start, const char *end, SkipFunction skip_whitespace) noexcept {
+	uint64_t chars;
+
+	if (reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start) >= sizeof(chars)) {
+		memcpy(&chars, start, sizeof(chars));
+		//Each byte that is a space becomes zero
+		chars ^= UINT64_C(0x2020202020202020);
+		if (chars != 0) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			return start + __builtin_clzll(chars) / 8;
+#else
+			return start + jsop_count_trailing_zeros(chars) / 8;
+#endif
+		}
+		return skip_whitespace(start + sizeof(chars), end);
+	}
+	return start;
+}
+
+#endif
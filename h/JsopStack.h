@@ -0,0 +1,39 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_STACK_H
+#define JSOP_STACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "JsopAllocator.h"
+#include "JsopDefines.h"
+
+//! Makes room for one more element in a full stack allocated with the given allocator, which walks the arrays and objects of a
+//! document without recursion
+//! The stack starts with min_size elements and doubles its capacity after that, and is kept unchanged if the memory cannot be allocated
+template <typename T>
+bool jsop_stack_grow(const JsopAllocator *allocator, T **start, T **end, T **alloc_end, size_t min_size) noexcept {
+	size_t n, new_capacity;
+
+	n = *alloc_end - *start;
+	if (n == 0) {
+		new_capacity = min_size;
+	} else if (n <= SIZE_MAX / (2 * sizeof(T))) {
+		new_capacity = n * 2;
+	} else {
+		return false;
+	}
+	auto new_start = static_cast<T *>(jsop_reallocate(allocator, *start, n * sizeof(T), new_capacity * sizeof(T)));
+	if (new_start == nullptr) {
+		return false;
+	}
+	*start = new_start;
+	*end = new_start + n;
+	*alloc_end = new_start + new_capacity;
+	return true;
+}
+
+#endif
@@ -7,8 +7,9 @@
 
 #include <assert.h>
 #include <stdint.h>
-#include <stdlib.h>
+#include <stddef.h>
 
+#include "JsopAllocator.h"
 #include "JsopDefines.h"
 
 //! Represents a temporary automatically resized string buffer
@@ -16,20 +17,21 @@ class JsopStringBuffer final {
 	char *Start;
 	char *End;
 	char *AllocEnd;
+	const JsopAllocator *Allocator;
 
 	char *resize() noexcept;
 
 public:
 	//! Creates a string buffer with the given size
-	explicit JsopStringBuffer(size_t n) noexcept {
+	explicit JsopStringBuffer(size_t n) noexcept : Allocator(&jsop_malloc_allocator) {
 		assert(n >= 16 && n % 16 == 0);
 
-		Start = static_cast<char *>(malloc(n * sizeof(char)));
+		Start = static_cast<char *>(jsop_allocate(Allocator, n * sizeof(char)));
 		End = Start;
 		AllocEnd = Start + n;
 	}
 	~JsopStringBuffer() {
-		free(Start);
+		jsop_release(Allocator, Start, (AllocEnd - Start) * sizeof(char));
 	}
 
 	JsopStringBuffer(const JsopStringBuffer &) = delete;
@@ -39,6 +41,16 @@ public:
 		return Start != nullptr;
 	}
 
+	//! Replaces the buffer with one of the same size from the given allocator
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		size_t n = AllocEnd - Start;
+		jsop_release(Allocator, Start, n * sizeof(char));
+		Allocator = allocator;
+		Start = static_cast<char *>(jsop_allocate(allocator, n * sizeof(char)));
+		End = Start;
+		AllocEnd = Start + n;
+	}
+
 	void clear() noexcept {
 		End = Start;
 	}
@@ -55,8 +67,13 @@ public:
 		return End;
 	}
 
+	//! Gets the number of characters that can be appended without resizing the buffer
+	size_t getRemainingCapacity() const noexcept {
+		return AllocEnd - End;
+	}
+
 	void setEnd(char *ptr) noexcept {
-		assert(ptr >= Start && ptr < AllocEnd);
+		assert(ptr >= Start && ptr <= AllocEnd);
 		End = ptr;
 	}
 
@@ -137,6 +154,16 @@ public:
 		return true;
 	}
 
+	//! Resize the buffer until the remaining capacity in the buffer is at least the given size
+	bool reserve(size_t n) noexcept {
+		while (JSOP_UNLIKELY(static_cast<size_t>(AllocEnd - End) < n)) {
+			if (resize() == nullptr) {
+				return false;
+			}
+		}
+		return true;
+	}
+
 	//! Converts the 32-bit character into the equivalent UTF-8 character(s) and appends to the string
 	bool appendUtf32(uint32_t code) noexcept;
 };
@@ -0,0 +1,124 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_STRING_TABLE_H
+#define JSOP_STRING_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsopDefines.h"
+#include "JsopHash.h"
+#include "JsopMemoryPools.h"
+
+//! A hash table from strings to the values that were made for them, which allows repeated strings to share a single copy
+//! The number of strings is limited to JSOP_STRING_TABLE_MAX_SIZE, after which new strings are not added
+template <class T>
+class JsopStringTable final {
+	struct Entry {
+		const char *String;
+		uint32_t Size;
+		uint32_t Hash;
+		T Value;
+	};
+
+	Entry *Start = nullptr;
+	size_t Capacity = 0;
+	size_t Count = 0;
+	//! Copies of the strings that are not stored elsewhere
+	JsopMemoryPools Strings;
+
+	static_assert(JSOP_STRING_TABLE_MAX_SIZE <= UINT32_MAX / 2, "JSOP_STRING_TABLE_MAX_SIZE <= UINT32_MAX / 2");
+
+	//! Doubles the number of slots, and returns false if the memory cannot be allocated
+	bool resize() noexcept {
+		size_t new_capacity = Capacity == 0 ? JSOP_STRING_TABLE_MIN_SIZE : Capacity * 2;
+		auto new_start = static_cast<Entry *>(calloc(new_capacity, sizeof(Entry)));
+		if (new_start == nullptr) {
+			return false;
+		}
+		for (auto entry = Start, end = Start + Capacity; entry != end; ++entry) {
+			if (entry->String != nullptr) {
+				auto i = static_cast<size_t>(entry->Hash) & (new_capacity - 1);
+				while (new_start[i].String != nullptr) {
+					i = (i + 1) & (new_capacity - 1);
+				}
+				new_start[i] = *entry;
+			}
+		}
+		free(Start);
+		Start = new_start;
+		Capacity = new_capacity;
+		return true;
+	}
+
+public:
+	JsopStringTable() = default;
+	~JsopStringTable() noexcept {
+		free(Start);
+	}
+
+	JsopStringTable(const JsopStringTable &) = delete;
+	JsopStringTable &operator =(const JsopStringTable &) = delete;
+
+	//! Removes all the strings but keeps the slots for reuse
+	void clear() noexcept {
+		if (Count != 0) {
+			memset(static_cast<void *>(Start), 0, Capacity * sizeof(Entry));
+			Count = 0;
+			Strings.clear();
+		}
+	}
+
+	//! Finds the value of the given string with the hash from jsop_hash_string(), and returns nullptr if it is not in the table
+	JSOP_INLINE const T *find(const char *s, size_t n, uint64_t hash) const noexcept {
+		if (Count != 0) {
+			auto h = static_cast<uint32_t>(hash);
+			for (auto i = static_cast<size_t>(h) & (Capacity - 1); Start[i].String != nullptr; i = (i + 1) & (Capacity - 1)) {
+				auto entry = Start + i;
+				if (entry->Hash == h && entry->Size == n && memcmp(entry->String, s, n) == 0) {
+					return &entry->Value;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	//! Adds the given string that is not in the table with its value, where the string is copied into the table if it does not stay
+	//! valid until clear() is called
+	//! Returns false if the memory cannot be allocated, which leaves the table unchanged
+	bool insert(const char *s, size_t n, uint64_t hash, const T &value, bool copy) noexcept {
+		if (Count >= JSOP_STRING_TABLE_MAX_SIZE || n > UINT32_MAX) {
+			return true;
+		}
+		if (Count >= Capacity / 2 && !resize()) {
+			return false;
+		}
+		if (copy) {
+			auto new_string = Strings.alloc<char>(n + 1);
+			if (new_string == nullptr) {
+				return false;
+			}
+			memcpy(new_string, s, n);
+			new_string[n] = '\0';
+			s = new_string;
+		}
+
+		auto h = static_cast<uint32_t>(hash);
+		auto i = static_cast<size_t>(h) & (Capacity - 1);
+		while (Start[i].String != nullptr) {
+			i = (i + 1) & (Capacity - 1);
+		}
+		Start[i].String = s;
+		Start[i].Size = static_cast<uint32_t>(n);
+		Start[i].Hash = h;
+		Start[i].Value = value;
+		++Count;
+		return true;
+	}
+};
+
+#endif
@@ -0,0 +1,62 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_STRUCTURAL_INDEX_H
+#define JSOP_STRUCTURAL_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "JsopAllocator.h"
+#include "JsopDefines.h"
+
+//! Positions of the structural characters ('{', '}', '[', ']', ':', ',' outside of strings and the quotes of all strings) in a JSON string,
+//! followed by the length of the string as a sentinel
+class JsopStructuralIndex final {
+	uint32_t *Start;
+	uint32_t *End;
+	uint32_t *AllocEnd;
+	const JsopAllocator *Allocator;
+
+	uint32_t *resize() noexcept;
+
+public:
+	JsopStructuralIndex() noexcept : Start(nullptr), End(nullptr), AllocEnd(nullptr), Allocator(&jsop_malloc_allocator) {
+	}
+	~JsopStructuralIndex() {
+		jsop_release(Allocator, Start, (AllocEnd - Start) * sizeof(uint32_t));
+	}
+
+	JsopStructuralIndex(const JsopStructuralIndex &) = delete;
+	JsopStructuralIndex &operator =(const JsopStructuralIndex &) = delete;
+
+	//! Releases the index, which is allocated again by the given allocator
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Allocator, Start, (AllocEnd - Start) * sizeof(uint32_t));
+		Allocator = allocator;
+		Start = nullptr;
+		End = nullptr;
+		AllocEnd = nullptr;
+	}
+
+	const uint32_t *getStart() const noexcept {
+		return Start;
+	}
+
+	const uint32_t *getEnd() const noexcept {
+		return End;
+	}
+
+	//! Builds the index for the given string, and returns false if the string is too long, contains an unterminated string or the
+	//! index cannot be allocated
+	bool build(
+		//! Pointer to the start of the string
+		const char *start,
+		//! Pointer to the end of the string
+		const char *end,
+		//! Whether JSOP_INPUT_PADDING characters after end are readable, so the last block does not need to be copied
+		bool padded = false) noexcept;
+};
+
+#endif
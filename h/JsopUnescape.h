@@ -0,0 +1,24 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_UNESCAPE_H
+#define JSOP_UNESCAPE_H
+
+#include "JsopDefines.h"
+
+//! Copies the characters of a string (excluding the quotes) in [start, end) to dest, replacing escape sequences and validating UTF-8 sequences
+//! The result is never longer than the input, so dest can point to start to unescape the string in place
+//! Returns the end of the copied string, or nullptr if the string is not valid
+char *jsop_unescape_string(char *dest, const char *start, const char *end) noexcept;
+
+//! Returns the first character in [start, end) that is a quote, a backslash, a control character or the start of an invalid (or
+//! incomplete) UTF-8 sequence, or end if there is none, so the characters before it can be used as a string without unescaping
+//! If padded is true, JSOP_INPUT_PADDING characters after end must be readable
+const char *jsop_skip_unescaped_string_chars(const char *start, const char *end, bool padded = false) noexcept;
+
+//! Returns the closing quote of the string that starts at start (after the opening quote), or nullptr if it is not in [start, end)
+//! If padded is true, JSOP_INPUT_PADDING characters after end must be readable
+const char *jsop_find_string_end(const char *start, const char *end, bool padded = false) noexcept;
+
+#endif
@@ -10,8 +10,11 @@
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
+#include "JsopDecimal.h"
 #include "JsopDefines.h"
+#include "JsopHash.h"
 
 class JsopValue;
 
@@ -95,9 +98,11 @@ public:
 private:
 	const value_type *Start;
 	const value_type *Finish;
+	bool Sorted;
+	bool Indexed;
 
 public:
-	constexpr JsopObjectView(const value_type *start, const value_type *finish) noexcept : Start(start), Finish(finish) {
+	constexpr JsopObjectView(const value_type *start, const value_type *finish, bool sorted = false, bool indexed = false) noexcept : Start(start), Finish(finish), Sorted(sorted), Indexed(indexed) {
 	}
 
 	JSOP_INLINE size_type size() const noexcept;
@@ -115,6 +120,47 @@ public:
 	const value_type *data() const noexcept {
 		return Start;
 	}
+
+	//! Checks if the pairs are sorted by their keys (see JsopDocumentHandler::setSortKeys())
+	bool isSorted() const noexcept {
+		return Sorted;
+	}
+
+	//! Checks if the pairs are followed by a hash index of their keys once there are enough of them (see
+	//! JsopDocumentHandler::setIndexObjects())
+	bool isIndexed() const noexcept {
+		return Indexed && hasIndex(size());
+	}
+
+	//! Gets the positions of the pairs in the order that they were parsed, or nullptr if the pairs are not sorted
+	const uint32_t *getInsertionOrder() const noexcept {
+		return Sorted ? reinterpret_cast<const uint32_t *>(Finish) : nullptr;
+	}
+
+	//! Checks if an indexed object with n keys is followed by a hash index of its keys
+	static constexpr bool hasIndex(size_type n) noexcept {
+		return n >= JSOP_OBJECT_INDEX_MIN_SIZE && n <= (UINT32_MAX >> 2);
+	}
+
+	//! Gets the number of slots in the hash index of an object with n keys, which is a power of 2 at least twice the number of keys
+	static JSOP_INLINE size_type getIndexCapacity(size_type n) noexcept;
+
+	//! Gets the number of values taken by the hash index of an object with n keys
+	static JSOP_INLINE size_type getIndexSize(size_type n) noexcept;
+
+	//! Gets the number of values taken by the insertion order of a sorted object with n keys
+	static JSOP_INLINE size_type getInsertionOrderSize(size_type n) noexcept;
+
+	//! Finds the first pair whose key is not less than the given key when the pairs are sorted, comparing the bytes of the keys
+	JSOP_INLINE const value_type *lowerBound(const char *key, size_t n) const noexcept;
+
+	//! Finds the first pair with the given key, and returns nullptr if there is none
+	//! Uses a binary search if the pairs are sorted, the hash index of the object if it is indexed, or compares the keys one by one
+	JSOP_INLINE const value_type *find(const char *key, size_t n) const noexcept;
+
+	const value_type *find(const char *key) const noexcept {
+		return find(key, strlen(key));
+	}
 };
 
 //! Represents a value using a type field and a union of all possible values
@@ -132,7 +178,11 @@ public:
 		StringType,
 		ArrayType,
 		ObjectType,
-		MaxType = ObjectType
+		BorrowedStringType,
+		DecimalType,
+		SortedObjectType,
+		IndexedObjectType,
+		MaxType = IndexedObjectType
 	};
 	static_assert(MaxType < (1 << 4), "MaxType < (1 << 4)");
 
@@ -147,6 +197,15 @@ public:
 #endif
 	};
 
+#if JSOP_WORD_SIZE == 32
+	//! A number whose conversion to a double precision number is deferred until it is accessed
+	struct DecimalNumber {
+		uint64_t Significand;
+		int Exponent;
+		bool Negative;
+	};
+#endif
+
 	struct SmallString {
 		typedef uint8_t size_type;
 		typedef char value_type;
@@ -172,6 +231,7 @@ private:
 				int64_t *Int64;
 				uint64_t *Uint64;
 				double *Double;
+				const DecimalNumber *Decimal;
 #endif
 				size_type StackSize;
 			};
@@ -233,14 +293,21 @@ public:
 		}
 	}
 
+	//! Checks if the value is a double precision number, including a number that has not been converted yet
 	bool isDouble() const noexcept {
-		return getType() == DoubleType;
+		return getType() == DoubleType || getType() == DecimalType;
+	}
+
+	//! Checks if the value is a number that is converted to a double precision number when it is accessed
+	bool isDecimal() const noexcept {
+		return getType() == DecimalType;
 	}
 
 	JSOP_INLINE bool isString() const noexcept {
 		switch (getType()) {
 		case SmallStringType:
 		case StringType:
+		case BorrowedStringType:
 			return true;
 
 		default:
@@ -252,8 +319,9 @@ public:
 		return getType() == ArrayType;
 	}
 
+	//! Checks if the value is an object, including an object with sorted keys or a hash index
 	bool isObject() const noexcept {
-		return getType() == ObjectType;
+		return getType() == ObjectType || getType() == SortedObjectType || getType() == IndexedObjectType;
 	}
 
 	const JsopValue *getValues() const noexcept {
@@ -271,7 +339,7 @@ public:
 			start = mySmallString.Data;
 			finish = start + ((Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS) & ((1 << (CHAR_BIT - VALUE_TYPE_NUMBER_OF_BITS)) - 1));
 		} else {
-			assert(getType() == StringType);
+			assert(getType() == StringType || getType() == BorrowedStringType);
 			start = Value.String;
 			finish = start + (Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS);
 		}
@@ -279,6 +347,7 @@ public:
 	}
 
 	//! Gets the null-terminated string stored in the value
+	//! Strings borrowed from the input are not null-terminated, so only getStringView() can be used for them
 	const char *c_str() const noexcept {
 		if (getType() == SmallStringType) {
 			return mySmallString.Data;
@@ -299,7 +368,10 @@ public:
 	}
 
 	double getDouble() const noexcept {
-		assert(getType() == DoubleType);
+		assert(getType() == DoubleType || getType() == DecimalType);
+		if (JSOP_UNLIKELY(getType() == DecimalType)) {
+			return jsop_decimal_to_double(getDecimalSignificand(), getDecimalExponent(), getDecimalNegative());
+		}
 #if JSOP_WORD_SIZE == 64
 		return Value.Double;
 #else
@@ -307,6 +379,36 @@ public:
 #endif
 	}
 
+	//! Gets the integer significand of a number that has not been converted yet, where its value is significand * 10^exponent
+	uint64_t getDecimalSignificand() const noexcept {
+		assert(getType() == DecimalType);
+#if JSOP_WORD_SIZE == 64
+		return static_cast<uint64_t>(Value.Int64);
+#else
+		return Value.Decimal->Significand;
+#endif
+	}
+
+	//! Gets the exponent (of 10) of a number that has not been converted yet
+	int getDecimalExponent() const noexcept {
+		assert(getType() == DecimalType);
+#if JSOP_WORD_SIZE == 64
+		return static_cast<int>(static_cast<uint32_t>(Value.TypeAndSize >> (VALUE_TYPE_NUMBER_OF_BITS + 1)));
+#else
+		return Value.Decimal->Exponent;
+#endif
+	}
+
+	//! Gets the sign of a number that has not been converted yet
+	bool getDecimalNegative() const noexcept {
+		assert(getType() == DecimalType);
+#if JSOP_WORD_SIZE == 64
+		return ((Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS) & 1) != 0;
+#else
+		return Value.Decimal->Negative;
+#endif
+	}
+
 	JSOP_INLINE size_type size() const noexcept;
 
 	size_t getStackSize() const noexcept {
@@ -336,6 +438,19 @@ public:
 		Value.Values = value;
 	}
 
+	//! Sets an object whose pairs are sorted by their keys and followed by their insertion order
+	void setSortedObject(JsopValue *value, size_type n) noexcept {
+		setTypeAndSize(SortedObjectType, n);
+		Value.Values = value;
+	}
+
+	//! Sets an object whose pairs are followed by the hash index of their keys if there are enough of them (see
+	//! JsopObjectView::hasIndex())
+	void setIndexedObject(JsopValue *value, size_type n) noexcept {
+		setTypeAndSize(IndexedObjectType, n);
+		Value.Values = value;
+	}
+
 	void setSmallString(size_type n, const char *value) noexcept {
 		assert(n < sizeof(mySmallString.Data));
 
@@ -352,6 +467,11 @@ public:
 		Value.String = value;
 	}
 
+	void setBorrowedString(size_type n, const char *value) noexcept {
+		setTypeAndSize(BorrowedStringType, n);
+		Value.String = value;
+	}
+
 	void setBool(bool value) noexcept {
 		Value.TypeAndSize = BoolType;
 #if JSOP_WORD_SIZE == 64
@@ -373,6 +493,23 @@ public:
 	}
 #endif
 
+#if JSOP_WORD_SIZE == 64
+	//! Stores the significand and exponent of a number, which are converted to a double precision number when it is accessed
+	void setDecimal(uint64_t significand, int exponent, bool negative) noexcept {
+		static_assert(VALUE_TYPE_NUMBER_OF_BITS + 1 + 32 <= 64, "VALUE_TYPE_NUMBER_OF_BITS + 1 + 32 <= 64");
+
+		Value.TypeAndSize = static_cast<size_type>(DecimalType) | (static_cast<size_type>(negative) << VALUE_TYPE_NUMBER_OF_BITS) |
+			(static_cast<size_type>(static_cast<uint32_t>(exponent)) << (VALUE_TYPE_NUMBER_OF_BITS + 1));
+		Value.Int64 = static_cast<int64_t>(significand);
+	}
+#else
+	//! Stores a number, which is converted to a double precision number when it is accessed
+	void setDecimal(const DecimalNumber *value) noexcept {
+		Value.TypeAndSize = DecimalType;
+		Value.Decimal = value;
+	}
+#endif
+
 #if JSOP_WORD_SIZE == 64
 	void setInt64(int64_t value) noexcept {
 		Value.TypeAndSize = Int64Type;
@@ -427,6 +564,9 @@ public:
 		case DoubleType:
 			return static_cast<int64_t>(Value.Double);
 
+		case DecimalType:
+			return static_cast<int64_t>(getDouble());
+
 #else
 		case BoolType:
 		case Int32Type:
@@ -443,6 +583,9 @@ public:
 
 		case DoubleType:
 			return static_cast<int64_t>(*(Value.Double));
+
+		case DecimalType:
+			return static_cast<int64_t>(getDouble());
 #endif
 
 		default:
@@ -462,6 +605,9 @@ public:
 		case DoubleType:
 			return static_cast<uint64_t>(Value.Double);
 
+		case DecimalType:
+			return static_cast<uint64_t>(getDouble());
+
 #else
 		case BoolType:
 		case Int32Type:
@@ -476,6 +622,9 @@ public:
 
 		case DoubleType:
 			return static_cast<int64_t>(*(Value.Double));
+
+		case DecimalType:
+			return static_cast<uint64_t>(getDouble());
 #endif
 		default:
 			return 0;
@@ -495,6 +644,9 @@ public:
 
 		case DoubleType:
 			return Value.Double;
+
+		case DecimalType:
+			return getDouble();
 #else
 		case BoolType:
 		case Int32Type:
@@ -511,6 +663,9 @@ public:
 
 		case DoubleType:
 			return *(Value.Double);
+
+		case DecimalType:
+			return getDouble();
 #endif
 
 		default:
@@ -536,12 +691,12 @@ JSOP_INLINE JsopArrayView JsopValue::getArrayView() const noexcept {
 }
 
 JSOP_INLINE JsopObjectView JsopValue::getObjectView() const noexcept {
-	assert(getType() == ObjectType);
-	return JsopObjectView(Value.KeyValues, Value.KeyValues + (Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS));
+	assert(isObject());
+	return JsopObjectView(Value.KeyValues, Value.KeyValues + (Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS), getType() == SortedObjectType, getType() == IndexedObjectType);
 }
 
 JSOP_INLINE JsopValue::size_type JsopValue::size() const noexcept {
-	assert(getType() == ArrayType || getType() == ObjectType || getType() == SmallStringType || getType() == StringType);
+	assert(getType() == ArrayType || getType() == ObjectType || getType() == SortedObjectType || getType() == IndexedObjectType || getType() == SmallStringType || getType() == StringType || getType() == BorrowedStringType);
 	size_type n = Value.TypeAndSize >> VALUE_TYPE_NUMBER_OF_BITS;
 	if (JSOP_UNLIKELY(getType() == SmallStringType)) {
 		n &= (1 << (CHAR_BIT - VALUE_TYPE_NUMBER_OF_BITS)) - 1;
@@ -567,4 +722,90 @@ JSOP_INLINE const JsopKeyValue &JsopObjectView::operator [](size_type i) const n
 	return Start[i];
 }
 
+JSOP_INLINE JsopObjectView::size_type JsopObjectView::getIndexCapacity(size_type n) noexcept {
+	size_type capacity;
+
+	assert(hasIndex(n));
+	capacity = JSOP_OBJECT_INDEX_MIN_SIZE * 2;
+	while (capacity < n * 2) {
+		capacity *= 2;
+	}
+	return capacity;
+}
+
+JSOP_INLINE JsopObjectView::size_type JsopObjectView::getIndexSize(size_type n) noexcept {
+	return (getIndexCapacity(n) * sizeof(uint32_t) + sizeof(JsopValue) - 1) / sizeof(JsopValue);
+}
+
+JSOP_INLINE JsopObjectView::size_type JsopObjectView::getInsertionOrderSize(size_type n) noexcept {
+	return (n * sizeof(uint32_t) + sizeof(JsopValue) - 1) / sizeof(JsopValue);
+}
+
+JSOP_INLINE const JsopKeyValue *JsopObjectView::lowerBound(const char *key, size_t n) const noexcept {
+	auto first = Start;
+	auto count = size();
+	while (count > 0) {
+		auto half = count / 2;
+		auto view = first[half].Key.getStringView();
+		auto rv = memcmp(view.data(), key, view.size() < n ? view.size() : n);
+		if (rv < 0 || (rv == 0 && view.size() < n)) {
+			first += half + 1;
+			count -= half + 1;
+		} else {
+			count = half;
+		}
+	}
+	return first;
+}
+
+JSOP_INLINE const JsopKeyValue *JsopObjectView::find(const char *key, size_t n) const noexcept {
+	auto object_size = size();
+	if (Sorted) {
+		auto first = lowerBound(key, n);
+		if (first != Finish) {
+			auto view = first->Key.getStringView();
+			if (view.size() == n && memcmp(view.data(), key, n) == 0) {
+				return first;
+			}
+		}
+	} else if (Indexed && hasIndex(object_size)) {
+		//The slots of the index hold the position of a pair plus 1, or 0 if they are empty
+		auto index = reinterpret_cast<const uint32_t *>(Finish);
+		auto mask = getIndexCapacity(object_size) - 1;
+		for (auto i = static_cast<size_type>(jsop_hash_string(key, n)) & mask; index[i] != 0; i = (i + 1) & mask) {
+			auto key_value = Start + (index[i] - 1);
+			auto view = key_value->Key.getStringView();
+			if (view.size() == n && memcmp(view.data(), key, n) == 0) {
+				return key_value;
+			}
+		}
+	} else {
+		for (auto key_value = Start; key_value != Finish; ++key_value) {
+			auto view = key_value->Key.getStringView();
+			if (view.size() == n && memcmp(view.data(), key, n) == 0) {
+				return key_value;
+			}
+		}
+	}
+	return nullptr;
+}
+
+//! Writes the hash index of an object with n keys after its pairs, where the values must have space for JsopObjectView::getIndexSize(n)
+//! more values
+JSOP_INLINE void jsop_object_make_index(JsopValue *values, size_t n) noexcept {
+	auto capacity = JsopObjectView::getIndexCapacity(n);
+
+	//Insert the keys in order with linear probing, so the first of duplicate keys is found first
+	auto index = reinterpret_cast<uint32_t *>(values + n * 2);
+	memset(index, 0, sizeof(uint32_t) * capacity);
+	for (size_t i = 0; i < n; ++i) {
+		auto view = values[i * 2].getStringView();
+		auto j = static_cast<size_t>(jsop_hash_string(view.data(), view.size())) & (capacity - 1);
+		while (index[j] != 0) {
+			j = (j + 1) & (capacity - 1);
+		}
+		index[j] = static_cast<uint32_t>(i + 1);
+	}
+}
+
 #endif
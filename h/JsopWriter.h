@@ -0,0 +1,140 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSOP_WRITER_H
+#define JSOP_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "JsopAllocator.h"
+#include "JsopDefines.h"
+#include "JsopValue.h"
+
+template <class ValueType>
+class JsopPackedWriter;
+
+//! Serializes values as compact JSON into an automatically resized buffer, which is optionally written to a file descriptor whenever it
+//! becomes full
+class JsopWriter final {
+	//! An array or object that is being written, where the values of an object alternate between keys and values
+	struct Context {
+		const JsopValue *Next;
+		const JsopValue *End;
+		bool Object;
+	};
+
+	char *Start;
+	char *End;
+	char *AllocEnd;
+	Context *StackStart;
+	Context *StackEnd;
+	Context *StackAllocEnd;
+	int Fd;
+	const JsopAllocator *Allocator;
+
+	//! Makes room for at least n more characters by writing the buffer to the file or resizing it, and returns the end of the buffer
+	//! or nullptr on error
+	char *reserveSlow(size_t n) noexcept;
+
+	//! Makes room for at least n more characters, and returns the end of the buffer or nullptr on error
+	JSOP_INLINE char *reserve(size_t n) noexcept {
+		if (JSOP_LIKELY(static_cast<size_t>(AllocEnd - End) >= n)) {
+			return End;
+		}
+		return reserveSlow(n);
+	}
+
+	JSOP_INLINE bool append(char ch) noexcept {
+		auto end = reserve(1);
+		if (end != nullptr) {
+			*end = ch;
+			End = end + 1;
+			return true;
+		}
+		return false;
+	}
+
+	JSOP_INLINE bool append(const char *s, size_t n) noexcept {
+		auto end = reserve(n);
+		if (end != nullptr) {
+			memcpy(end, s, n);
+			End = end + n;
+			return true;
+		}
+		return false;
+	}
+
+	//! Pushes the context of an array or object with the given values
+	bool push(const JsopValue *next, const JsopValue *end, bool object) noexcept;
+
+	bool writeString(const char *start, const char *end) noexcept;
+	bool writeInteger(uint64_t value, bool negative) noexcept;
+	bool writeDouble(double value) noexcept;
+	bool writeDecimal(uint64_t significand, int exponent, bool negative) noexcept;
+
+	template <class ValueType>
+	friend class JsopPackedWriter;
+	friend class JsopPrintHandler;
+
+public:
+	JsopWriter() noexcept : Start(nullptr), End(nullptr), AllocEnd(nullptr), StackStart(nullptr), StackEnd(nullptr), StackAllocEnd(nullptr), Fd(-1), Allocator(&jsop_malloc_allocator) {
+	}
+	~JsopWriter() {
+		jsop_release(Allocator, Start, AllocEnd - Start);
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+	}
+
+	JsopWriter(const JsopWriter &) = delete;
+	JsopWriter &operator =(const JsopWriter &) = delete;
+
+	const char *getStart() const noexcept {
+		return Start;
+	}
+
+	const char *getEnd() const noexcept {
+		return End;
+	}
+
+	size_t size() const noexcept {
+		return End - Start;
+	}
+
+	//! Discards the characters in the buffer
+	void clear() noexcept {
+		End = Start;
+	}
+
+	//! Releases the buffer and the stack, and allocates them again with the given allocator when they are needed, which discards the
+	//! characters in the buffer
+	void setAllocator(const JsopAllocator *allocator) noexcept {
+		jsop_release(Allocator, Start, AllocEnd - Start);
+		jsop_release(Allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(Context));
+		Start = nullptr;
+		End = nullptr;
+		AllocEnd = nullptr;
+		StackStart = nullptr;
+		StackEnd = nullptr;
+		StackAllocEnd = nullptr;
+		Allocator = allocator;
+	}
+
+	//! Sets the file descriptor that the buffer is written to when it becomes full and by flush(), or -1 to keep all the characters in
+	//! the buffer
+	void setFile(int fd) noexcept {
+		Fd = fd;
+	}
+
+	//! Appends the given value and all its children as compact JSON, and returns false if the buffer cannot be allocated or the file
+	//! cannot be written
+	//! Numbers that are infinite or NaN are written as null
+	bool write(const JsopValue &value) noexcept;
+
+	//! Writes the characters in the buffer to the file and clears the buffer, or keeps them if there is no file
+	bool flush() noexcept;
+};
+
+#endif
@@ -0,0 +1,21 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <stdlib.h>
+
+#include "JsopAllocator.h"
+
+static void *jsop_malloc_allocate(void *, size_t n) noexcept {
+	return malloc(n);
+}
+
+static void *jsop_malloc_reallocate(void *, void *p, size_t, size_t new_n) noexcept {
+	return realloc(p, new_n);
+}
+
+static void jsop_malloc_release(void *, void *p, size_t) noexcept {
+	free(p);
+}
+
+const JsopAllocator jsop_malloc_allocator = {jsop_malloc_allocate, jsop_malloc_reallocate, jsop_malloc_release, nullptr};
@@ -36,6 +36,12 @@
 #define JSOP_MPN_MAX_UINTS (1024 / JSOP_WORD_SIZE)
 
 #define JSOP_MAX_EXPONENT_OF_FIVE 308
+#define JSOP_MIN_EXPONENT_OF_FIVE_128 (-342)
+//The smallest subnormal number is about 4.9 * 10^-324
+#define JSOP_MIN_EXPONENT_OF_SUBNORMAL 324
+
+//Enough 32-bit uints for the comparisons in jsop_long_decimal_to_double()
+#define JSOP_LONG_DECIMAL_MAX_UINTS (6144 / 32)
 
 #ifdef JSOP_USE_FP_MATH
 
@@ -623,6 +629,662 @@ static const uint64_t JsopNormalizedReciprocalsOf5[] = {
 	UINT64_C(0xeef453d6923bd65a),
 };
 
+//! The most significant 128 bits of the powers of five from 5^-342 to 5^308 (as the high and low parts), which are normalized so that
+//! the highest bit is set, and rounded up for the negative powers
+static const uint64_t JsopPowersOfFive128[] = {
+	UINT64_C(0xeef453d6923bd65a), UINT64_C(0x113faa2906a13b3f),	//5e-342
+	UINT64_C(0x9558b4661b6565f8), UINT64_C(0x4ac7ca59a424c507),	//5e-341
+	UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x5d79bcf00d2df649),	//5e-340
+	UINT64_C(0xe95a99df8ace6f53), UINT64_C(0xf4d82c2c107973dc),	//5e-339
+	UINT64_C(0x91d8a02bb6c10594), UINT64_C(0x79071b9b8a4be869),	//5e-338
+	UINT64_C(0xb64ec836a47146f9), UINT64_C(0x9748e2826cdee284),	//5e-337
+	UINT64_C(0xe3e27a444d8d98b7), UINT64_C(0xfd1b1b2308169b25),	//5e-336
+	UINT64_C(0x8e6d8c6ab0787f72), UINT64_C(0xfe30f0f5e50e20f7),	//5e-335
+	UINT64_C(0xb208ef855c969f4f), UINT64_C(0xbdbd2d335e51a935),	//5e-334
+	UINT64_C(0xde8b2b66b3bc4723), UINT64_C(0xad2c788035e61382),	//5e-333
+	UINT64_C(0x8b16fb203055ac76), UINT64_C(0x4c3bcb5021afcc31),	//5e-332
+	UINT64_C(0xaddcb9e83c6b1793), UINT64_C(0xdf4abe242a1bbf3d),	//5e-331
+	UINT64_C(0xd953e8624b85dd78), UINT64_C(0xd71d6dad34a2af0d),	//5e-330
+	UINT64_C(0x87d4713d6f33aa6b), UINT64_C(0x8672648c40e5ad68),	//5e-329
+	UINT64_C(0xa9c98d8ccb009506), UINT64_C(0x680efdaf511f18c2),	//5e-328
+	UINT64_C(0xd43bf0effdc0ba48), UINT64_C(0x0212bd1b2566def2),	//5e-327
+	UINT64_C(0x84a57695fe98746d), UINT64_C(0x014bb630f7604b57),	//5e-326
+	UINT64_C(0xa5ced43b7e3e9188), UINT64_C(0x419ea3bd35385e2d),	//5e-325
+	UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x52064cac828675b9),	//5e-324
+	UINT64_C(0x818995ce7aa0e1b2), UINT64_C(0x7343efebd1940993),	//5e-323
+	UINT64_C(0xa1ebfb4219491a1f), UINT64_C(0x1014ebe6c5f90bf8),	//5e-322
+	UINT64_C(0xca66fa129f9b60a6), UINT64_C(0xd41a26e077774ef6),	//5e-321
+	UINT64_C(0xfd00b897478238d0), UINT64_C(0x8920b098955522b4),	//5e-320
+	UINT64_C(0x9e20735e8cb16382), UINT64_C(0x55b46e5f5d5535b0),	//5e-319
+	UINT64_C(0xc5a890362fddbc62), UINT64_C(0xeb2189f734aa831d),	//5e-318
+	UINT64_C(0xf712b443bbd52b7b), UINT64_C(0xa5e9ec7501d523e4),	//5e-317
+	UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0x47b233c92125366e),	//5e-316
+	UINT64_C(0xc1069cd4eabe89f8), UINT64_C(0x999ec0bb696e840a),	//5e-315
+	UINT64_C(0xf148440a256e2c76), UINT64_C(0xc00670ea43ca250d),	//5e-314
+	UINT64_C(0x96cd2a865764dbca), UINT64_C(0x380406926a5e5728),	//5e-313
+	UINT64_C(0xbc807527ed3e12bc), UINT64_C(0xc605083704f5ecf2),	//5e-312
+	UINT64_C(0xeba09271e88d976b), UINT64_C(0xf7864a44c633682e),	//5e-311
+	UINT64_C(0x93445b8731587ea3), UINT64_C(0x7ab3ee6afbe0211d),	//5e-310
+	UINT64_C(0xb8157268fdae9e4c), UINT64_C(0x5960ea05bad82964),	//5e-309
+	UINT64_C(0xe61acf033d1a45df), UINT64_C(0x6fb92487298e33bd),	//5e-308
+	UINT64_C(0x8fd0c16206306bab), UINT64_C(0xa5d3b6d479f8e056),	//5e-307
+	UINT64_C(0xb3c4f1ba87bc8696), UINT64_C(0x8f48a4899877186c),	//5e-306
+	UINT64_C(0xe0b62e2929aba83c), UINT64_C(0x331acdabfe94de87),	//5e-305
+	UINT64_C(0x8c71dcd9ba0b4925), UINT64_C(0x9ff0c08b7f1d0b14),	//5e-304
+	UINT64_C(0xaf8e5410288e1b6f), UINT64_C(0x07ecf0ae5ee44dd9),	//5e-303
+	UINT64_C(0xdb71e91432b1a24a), UINT64_C(0xc9e82cd9f69d6150),	//5e-302
+	UINT64_C(0x892731ac9faf056e), UINT64_C(0xbe311c083a225cd2),	//5e-301
+	UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0x6dbd630a48aaf406),	//5e-300
+	UINT64_C(0xd64d3d9db981787d), UINT64_C(0x092cbbccdad5b108),	//5e-299
+	UINT64_C(0x85f0468293f0eb4e), UINT64_C(0x25bbf56008c58ea5),	//5e-298
+	UINT64_C(0xa76c582338ed2621), UINT64_C(0xaf2af2b80af6f24e),	//5e-297
+	UINT64_C(0xd1476e2c07286faa), UINT64_C(0x1af5af660db4aee1),	//5e-296
+	UINT64_C(0x82cca4db847945ca), UINT64_C(0x50d98d9fc890ed4d),	//5e-295
+	UINT64_C(0xa37fce126597973c), UINT64_C(0xe50ff107bab528a0),	//5e-294
+	UINT64_C(0xcc5fc196fefd7d0c), UINT64_C(0x1e53ed49a96272c8),	//5e-293
+	UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0x25e8e89c13bb0f7a),	//5e-292
+	UINT64_C(0x9faacf3df73609b1), UINT64_C(0x77b191618c54e9ac),	//5e-291
+	UINT64_C(0xc795830d75038c1d), UINT64_C(0xd59df5b9ef6a2417),	//5e-290
+	UINT64_C(0xf97ae3d0d2446f25), UINT64_C(0x4b0573286b44ad1d),	//5e-289
+	UINT64_C(0x9becce62836ac577), UINT64_C(0x4ee367f9430aec32),	//5e-288
+	UINT64_C(0xc2e801fb244576d5), UINT64_C(0x229c41f793cda73f),	//5e-287
+	UINT64_C(0xf3a20279ed56d48a), UINT64_C(0x6b43527578c1110f),	//5e-286
+	UINT64_C(0x9845418c345644d6), UINT64_C(0x830a13896b78aaa9),	//5e-285
+	UINT64_C(0xbe5691ef416bd60c), UINT64_C(0x23cc986bc656d553),	//5e-284
+	UINT64_C(0xedec366b11c6cb8f), UINT64_C(0x2cbfbe86b7ec8aa8),	//5e-283
+	UINT64_C(0x94b3a202eb1c3f39), UINT64_C(0x7bf7d71432f3d6a9),	//5e-282
+	UINT64_C(0xb9e08a83a5e34f07), UINT64_C(0xdaf5ccd93fb0cc53),	//5e-281
+	UINT64_C(0xe858ad248f5c22c9), UINT64_C(0xd1b3400f8f9cff68),	//5e-280
+	UINT64_C(0x91376c36d99995be), UINT64_C(0x23100809b9c21fa1),	//5e-279
+	UINT64_C(0xb58547448ffffb2d), UINT64_C(0xabd40a0c2832a78a),	//5e-278
+	UINT64_C(0xe2e69915b3fff9f9), UINT64_C(0x16c90c8f323f516c),	//5e-277
+	UINT64_C(0x8dd01fad907ffc3b), UINT64_C(0xae3da7d97f6792e3),	//5e-276
+	UINT64_C(0xb1442798f49ffb4a), UINT64_C(0x99cd11cfdf41779c),	//5e-275
+	UINT64_C(0xdd95317f31c7fa1d), UINT64_C(0x40405643d711d583),	//5e-274
+	UINT64_C(0x8a7d3eef7f1cfc52), UINT64_C(0x482835ea666b2572),	//5e-273
+	UINT64_C(0xad1c8eab5ee43b66), UINT64_C(0xda3243650005eecf),	//5e-272
+	UINT64_C(0xd863b256369d4a40), UINT64_C(0x90bed43e40076a82),	//5e-271
+	UINT64_C(0x873e4f75e2224e68), UINT64_C(0x5a7744a6e804a291),	//5e-270
+	UINT64_C(0xa90de3535aaae202), UINT64_C(0x711515d0a205cb36),	//5e-269
+	UINT64_C(0xd3515c2831559a83), UINT64_C(0x0d5a5b44ca873e03),	//5e-268
+	UINT64_C(0x8412d9991ed58091), UINT64_C(0xe858790afe9486c2),	//5e-267
+	UINT64_C(0xa5178fff668ae0b6), UINT64_C(0x626e974dbe39a872),	//5e-266
+	UINT64_C(0xce5d73ff402d98e3), UINT64_C(0xfb0a3d212dc8128f),	//5e-265
+	UINT64_C(0x80fa687f881c7f8e), UINT64_C(0x7ce66634bc9d0b99),	//5e-264
+	UINT64_C(0xa139029f6a239f72), UINT64_C(0x1c1fffc1ebc44e80),	//5e-263
+	UINT64_C(0xc987434744ac874e), UINT64_C(0xa327ffb266b56220),	//5e-262
+	UINT64_C(0xfbe9141915d7a922), UINT64_C(0x4bf1ff9f0062baa8),	//5e-261
+	UINT64_C(0x9d71ac8fada6c9b5), UINT64_C(0x6f773fc3603db4a9),	//5e-260
+	UINT64_C(0xc4ce17b399107c22), UINT64_C(0xcb550fb4384d21d3),	//5e-259
+	UINT64_C(0xf6019da07f549b2b), UINT64_C(0x7e2a53a146606a48),	//5e-258
+	UINT64_C(0x99c102844f94e0fb), UINT64_C(0x2eda7444cbfc426d),	//5e-257
+	UINT64_C(0xc0314325637a1939), UINT64_C(0xfa911155fefb5308),	//5e-256
+	UINT64_C(0xf03d93eebc589f88), UINT64_C(0x793555ab7eba27ca),	//5e-255
+	UINT64_C(0x96267c7535b763b5), UINT64_C(0x4bc1558b2f3458de),	//5e-254
+	UINT64_C(0xbbb01b9283253ca2), UINT64_C(0x9eb1aaedfb016f16),	//5e-253
+	UINT64_C(0xea9c227723ee8bcb), UINT64_C(0x465e15a979c1cadc),	//5e-252
+	UINT64_C(0x92a1958a7675175f), UINT64_C(0x0bfacd89ec191ec9),	//5e-251
+	UINT64_C(0xb749faed14125d36), UINT64_C(0xcef980ec671f667b),	//5e-250
+	UINT64_C(0xe51c79a85916f484), UINT64_C(0x82b7e12780e7401a),	//5e-249
+	UINT64_C(0x8f31cc0937ae58d2), UINT64_C(0xd1b2ecb8b0908810),	//5e-248
+	UINT64_C(0xb2fe3f0b8599ef07), UINT64_C(0x861fa7e6dcb4aa15),	//5e-247
+	UINT64_C(0xdfbdcece67006ac9), UINT64_C(0x67a791e093e1d49a),	//5e-246
+	UINT64_C(0x8bd6a141006042bd), UINT64_C(0xe0c8bb2c5c6d24e0),	//5e-245
+	UINT64_C(0xaecc49914078536d), UINT64_C(0x58fae9f773886e18),	//5e-244
+	UINT64_C(0xda7f5bf590966848), UINT64_C(0xaf39a475506a899e),	//5e-243
+	UINT64_C(0x888f99797a5e012d), UINT64_C(0x6d8406c952429603),	//5e-242
+	UINT64_C(0xaab37fd7d8f58178), UINT64_C(0xc8e5087ba6d33b83),	//5e-241
+	UINT64_C(0xd5605fcdcf32e1d6), UINT64_C(0xfb1e4a9a90880a64),	//5e-240
+	UINT64_C(0x855c3be0a17fcd26), UINT64_C(0x5cf2eea09a55067f),	//5e-239
+	UINT64_C(0xa6b34ad8c9dfc06f), UINT64_C(0xf42faa48c0ea481e),	//5e-238
+	UINT64_C(0xd0601d8efc57b08b), UINT64_C(0xf13b94daf124da26),	//5e-237
+	UINT64_C(0x823c12795db6ce57), UINT64_C(0x76c53d08d6b70858),	//5e-236
+	UINT64_C(0xa2cb1717b52481ed), UINT64_C(0x54768c4b0c64ca6e),	//5e-235
+	UINT64_C(0xcb7ddcdda26da268), UINT64_C(0xa9942f5dcf7dfd09),	//5e-234
+	UINT64_C(0xfe5d54150b090b02), UINT64_C(0xd3f93b35435d7c4c),	//5e-233
+	UINT64_C(0x9efa548d26e5a6e1), UINT64_C(0xc47bc5014a1a6daf),	//5e-232
+	UINT64_C(0xc6b8e9b0709f109a), UINT64_C(0x359ab6419ca1091b),	//5e-231
+	UINT64_C(0xf867241c8cc6d4c0), UINT64_C(0xc30163d203c94b62),	//5e-230
+	UINT64_C(0x9b407691d7fc44f8), UINT64_C(0x79e0de63425dcf1d),	//5e-229
+	UINT64_C(0xc21094364dfb5636), UINT64_C(0x985915fc12f542e4),	//5e-228
+	UINT64_C(0xf294b943e17a2bc4), UINT64_C(0x3e6f5b7b17b2939d),	//5e-227
+	UINT64_C(0x979cf3ca6cec5b5a), UINT64_C(0xa705992ceecf9c42),	//5e-226
+	UINT64_C(0xbd8430bd08277231), UINT64_C(0x50c6ff782a838353),	//5e-225
+	UINT64_C(0xece53cec4a314ebd), UINT64_C(0xa4f8bf5635246428),	//5e-224
+	UINT64_C(0x940f4613ae5ed136), UINT64_C(0x871b7795e136be99),	//5e-223
+	UINT64_C(0xb913179899f68584), UINT64_C(0x28e2557b59846e3f),	//5e-222
+	UINT64_C(0xe757dd7ec07426e5), UINT64_C(0x331aeada2fe589cf),	//5e-221
+	UINT64_C(0x9096ea6f3848984f), UINT64_C(0x3ff0d2c85def7621),	//5e-220
+	UINT64_C(0xb4bca50b065abe63), UINT64_C(0x0fed077a756b53a9),	//5e-219
+	UINT64_C(0xe1ebce4dc7f16dfb), UINT64_C(0xd3e8495912c62894),	//5e-218
+	UINT64_C(0x8d3360f09cf6e4bd), UINT64_C(0x64712dd7abbbd95c),	//5e-217
+	UINT64_C(0xb080392cc4349dec), UINT64_C(0xbd8d794d96aacfb3),	//5e-216
+	UINT64_C(0xdca04777f541c567), UINT64_C(0xecf0d7a0fc5583a0),	//5e-215
+	UINT64_C(0x89e42caaf9491b60), UINT64_C(0xf41686c49db57244),	//5e-214
+	UINT64_C(0xac5d37d5b79b6239), UINT64_C(0x311c2875c522ced5),	//5e-213
+	UINT64_C(0xd77485cb25823ac7), UINT64_C(0x7d633293366b828b),	//5e-212
+	UINT64_C(0x86a8d39ef77164bc), UINT64_C(0xae5dff9c02033197),	//5e-211
+	UINT64_C(0xa8530886b54dbdeb), UINT64_C(0xd9f57f830283fdfc),	//5e-210
+	UINT64_C(0xd267caa862a12d66), UINT64_C(0xd072df63c324fd7b),	//5e-209
+	UINT64_C(0x8380dea93da4bc60), UINT64_C(0x4247cb9e59f71e6d),	//5e-208
+	UINT64_C(0xa46116538d0deb78), UINT64_C(0x52d9be85f074e608),	//5e-207
+	UINT64_C(0xcd795be870516656), UINT64_C(0x67902e276c921f8b),	//5e-206
+	UINT64_C(0x806bd9714632dff6), UINT64_C(0x00ba1cd8a3db53b6),	//5e-205
+	UINT64_C(0xa086cfcd97bf97f3), UINT64_C(0x80e8a40eccd228a4),	//5e-204
+	UINT64_C(0xc8a883c0fdaf7df0), UINT64_C(0x6122cd128006b2cd),	//5e-203
+	UINT64_C(0xfad2a4b13d1b5d6c), UINT64_C(0x796b805720085f81),	//5e-202
+	UINT64_C(0x9cc3a6eec6311a63), UINT64_C(0xcbe3303674053bb0),	//5e-201
+	UINT64_C(0xc3f490aa77bd60fc), UINT64_C(0xbedbfc4411068a9c),	//5e-200
+	UINT64_C(0xf4f1b4d515acb93b), UINT64_C(0xee92fb5515482d44),	//5e-199
+	UINT64_C(0x991711052d8bf3c5), UINT64_C(0x751bdd152d4d1c4a),	//5e-198
+	UINT64_C(0xbf5cd54678eef0b6), UINT64_C(0xd262d45a78a0635d),	//5e-197
+	UINT64_C(0xef340a98172aace4), UINT64_C(0x86fb897116c87c34),	//5e-196
+	UINT64_C(0x9580869f0e7aac0e), UINT64_C(0xd45d35e6ae3d4da0),	//5e-195
+	UINT64_C(0xbae0a846d2195712), UINT64_C(0x8974836059cca109),	//5e-194
+	UINT64_C(0xe998d258869facd7), UINT64_C(0x2bd1a438703fc94b),	//5e-193
+	UINT64_C(0x91ff83775423cc06), UINT64_C(0x7b6306a34627ddcf),	//5e-192
+	UINT64_C(0xb67f6455292cbf08), UINT64_C(0x1a3bc84c17b1d542),	//5e-191
+	UINT64_C(0xe41f3d6a7377eeca), UINT64_C(0x20caba5f1d9e4a93),	//5e-190
+	UINT64_C(0x8e938662882af53e), UINT64_C(0x547eb47b7282ee9c),	//5e-189
+	UINT64_C(0xb23867fb2a35b28d), UINT64_C(0xe99e619a4f23aa43),	//5e-188
+	UINT64_C(0xdec681f9f4c31f31), UINT64_C(0x6405fa00e2ec94d4),	//5e-187
+	UINT64_C(0x8b3c113c38f9f37e), UINT64_C(0xde83bc408dd3dd04),	//5e-186
+	UINT64_C(0xae0b158b4738705e), UINT64_C(0x9624ab50b148d445),	//5e-185
+	UINT64_C(0xd98ddaee19068c76), UINT64_C(0x3badd624dd9b0957),	//5e-184
+	UINT64_C(0x87f8a8d4cfa417c9), UINT64_C(0xe54ca5d70a80e5d6),	//5e-183
+	UINT64_C(0xa9f6d30a038d1dbc), UINT64_C(0x5e9fcf4ccd211f4c),	//5e-182
+	UINT64_C(0xd47487cc8470652b), UINT64_C(0x7647c3200069671f),	//5e-181
+	UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0x29ecd9f40041e073),	//5e-180
+	UINT64_C(0xa5fb0a17c777cf09), UINT64_C(0xf468107100525890),	//5e-179
+	UINT64_C(0xcf79cc9db955c2cc), UINT64_C(0x7182148d4066eeb4),	//5e-178
+	UINT64_C(0x81ac1fe293d599bf), UINT64_C(0xc6f14cd848405530),	//5e-177
+	UINT64_C(0xa21727db38cb002f), UINT64_C(0xb8ada00e5a506a7c),	//5e-176
+	UINT64_C(0xca9cf1d206fdc03b), UINT64_C(0xa6d90811f0e4851c),	//5e-175
+	UINT64_C(0xfd442e4688bd304a), UINT64_C(0x908f4a166d1da663),	//5e-174
+	UINT64_C(0x9e4a9cec15763e2e), UINT64_C(0x9a598e4e043287fe),	//5e-173
+	UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x40eff1e1853f29fd),	//5e-172
+	UINT64_C(0xf7549530e188c128), UINT64_C(0xd12bee59e68ef47c),	//5e-171
+	UINT64_C(0x9a94dd3e8cf578b9), UINT64_C(0x82bb74f8301958ce),	//5e-170
+	UINT64_C(0xc13a148e3032d6e7), UINT64_C(0xe36a52363c1faf01),	//5e-169
+	UINT64_C(0xf18899b1bc3f8ca1), UINT64_C(0xdc44e6c3cb279ac1),	//5e-168
+	UINT64_C(0x96f5600f15a7b7e5), UINT64_C(0x29ab103a5ef8c0b9),	//5e-167
+	UINT64_C(0xbcb2b812db11a5de), UINT64_C(0x7415d448f6b6f0e7),	//5e-166
+	UINT64_C(0xebdf661791d60f56), UINT64_C(0x111b495b3464ad21),	//5e-165
+	UINT64_C(0x936b9fcebb25c995), UINT64_C(0xcab10dd900beec34),	//5e-164
+	UINT64_C(0xb84687c269ef3bfb), UINT64_C(0x3d5d514f40eea742),	//5e-163
+	UINT64_C(0xe65829b3046b0afa), UINT64_C(0x0cb4a5a3112a5112),	//5e-162
+	UINT64_C(0x8ff71a0fe2c2e6dc), UINT64_C(0x47f0e785eaba72ab),	//5e-161
+	UINT64_C(0xb3f4e093db73a093), UINT64_C(0x59ed216765690f56),	//5e-160
+	UINT64_C(0xe0f218b8d25088b8), UINT64_C(0x306869c13ec3532c),	//5e-159
+	UINT64_C(0x8c974f7383725573), UINT64_C(0x1e414218c73a13fb),	//5e-158
+	UINT64_C(0xafbd2350644eeacf), UINT64_C(0xe5d1929ef90898fa),	//5e-157
+	UINT64_C(0xdbac6c247d62a583), UINT64_C(0xdf45f746b74abf39),	//5e-156
+	UINT64_C(0x894bc396ce5da772), UINT64_C(0x6b8bba8c328eb783),	//5e-155
+	UINT64_C(0xab9eb47c81f5114f), UINT64_C(0x066ea92f3f326564),	//5e-154
+	UINT64_C(0xd686619ba27255a2), UINT64_C(0xc80a537b0efefebd),	//5e-153
+	UINT64_C(0x8613fd0145877585), UINT64_C(0xbd06742ce95f5f36),	//5e-152
+	UINT64_C(0xa798fc4196e952e7), UINT64_C(0x2c48113823b73704),	//5e-151
+	UINT64_C(0xd17f3b51fca3a7a0), UINT64_C(0xf75a15862ca504c5),	//5e-150
+	UINT64_C(0x82ef85133de648c4), UINT64_C(0x9a984d73dbe722fb),	//5e-149
+	UINT64_C(0xa3ab66580d5fdaf5), UINT64_C(0xc13e60d0d2e0ebba),	//5e-148
+	UINT64_C(0xcc963fee10b7d1b3), UINT64_C(0x318df905079926a8),	//5e-147
+	UINT64_C(0xffbbcfe994e5c61f), UINT64_C(0xfdf17746497f7052),	//5e-146
+	UINT64_C(0x9fd561f1fd0f9bd3), UINT64_C(0xfeb6ea8bedefa633),	//5e-145
+	UINT64_C(0xc7caba6e7c5382c8), UINT64_C(0xfe64a52ee96b8fc0),	//5e-144
+	UINT64_C(0xf9bd690a1b68637b), UINT64_C(0x3dfdce7aa3c673b0),	//5e-143
+	UINT64_C(0x9c1661a651213e2d), UINT64_C(0x06bea10ca65c084e),	//5e-142
+	UINT64_C(0xc31bfa0fe5698db8), UINT64_C(0x486e494fcff30a62),	//5e-141
+	UINT64_C(0xf3e2f893dec3f126), UINT64_C(0x5a89dba3c3efccfa),	//5e-140
+	UINT64_C(0x986ddb5c6b3a76b7), UINT64_C(0xf89629465a75e01c),	//5e-139
+	UINT64_C(0xbe89523386091465), UINT64_C(0xf6bbb397f1135823),	//5e-138
+	UINT64_C(0xee2ba6c0678b597f), UINT64_C(0x746aa07ded582e2c),	//5e-137
+	UINT64_C(0x94db483840b717ef), UINT64_C(0xa8c2a44eb4571cdc),	//5e-136
+	UINT64_C(0xba121a4650e4ddeb), UINT64_C(0x92f34d62616ce413),	//5e-135
+	UINT64_C(0xe896a0d7e51e1566), UINT64_C(0x77b020baf9c81d17),	//5e-134
+	UINT64_C(0x915e2486ef32cd60), UINT64_C(0x0ace1474dc1d122e),	//5e-133
+	UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x0d819992132456ba),	//5e-132
+	UINT64_C(0xe3231912d5bf60e6), UINT64_C(0x10e1fff697ed6c69),	//5e-131
+	UINT64_C(0x8df5efabc5979c8f), UINT64_C(0xca8d3ffa1ef463c1),	//5e-130
+	UINT64_C(0xb1736b96b6fd83b3), UINT64_C(0xbd308ff8a6b17cb2),	//5e-129
+	UINT64_C(0xddd0467c64bce4a0), UINT64_C(0xac7cb3f6d05ddbde),	//5e-128
+	UINT64_C(0x8aa22c0dbef60ee4), UINT64_C(0x6bcdf07a423aa96b),	//5e-127
+	UINT64_C(0xad4ab7112eb3929d), UINT64_C(0x86c16c98d2c953c6),	//5e-126
+	UINT64_C(0xd89d64d57a607744), UINT64_C(0xe871c7bf077ba8b7),	//5e-125
+	UINT64_C(0x87625f056c7c4a8b), UINT64_C(0x11471cd764ad4972),	//5e-124
+	UINT64_C(0xa93af6c6c79b5d2d), UINT64_C(0xd598e40d3dd89bcf),	//5e-123
+	UINT64_C(0xd389b47879823479), UINT64_C(0x4aff1d108d4ec2c3),	//5e-122
+	UINT64_C(0x843610cb4bf160cb), UINT64_C(0xcedf722a585139ba),	//5e-121
+	UINT64_C(0xa54394fe1eedb8fe), UINT64_C(0xc2974eb4ee658828),	//5e-120
+	UINT64_C(0xce947a3da6a9273e), UINT64_C(0x733d226229feea32),	//5e-119
+	UINT64_C(0x811ccc668829b887), UINT64_C(0x0806357d5a3f525f),	//5e-118
+	UINT64_C(0xa163ff802a3426a8), UINT64_C(0xca07c2dcb0cf26f7),	//5e-117
+	UINT64_C(0xc9bcff6034c13052), UINT64_C(0xfc89b393dd02f0b5),	//5e-116
+	UINT64_C(0xfc2c3f3841f17c67), UINT64_C(0xbbac2078d443ace2),	//5e-115
+	UINT64_C(0x9d9ba7832936edc0), UINT64_C(0xd54b944b84aa4c0d),	//5e-114
+	UINT64_C(0xc5029163f384a931), UINT64_C(0x0a9e795e65d4df11),	//5e-113
+	UINT64_C(0xf64335bcf065d37d), UINT64_C(0x4d4617b5ff4a16d5),	//5e-112
+	UINT64_C(0x99ea0196163fa42e), UINT64_C(0x504bced1bf8e4e45),	//5e-111
+	UINT64_C(0xc06481fb9bcf8d39), UINT64_C(0xe45ec2862f71e1d6),	//5e-110
+	UINT64_C(0xf07da27a82c37088), UINT64_C(0x5d767327bb4e5a4c),	//5e-109
+	UINT64_C(0x964e858c91ba2655), UINT64_C(0x3a6a07f8d510f86f),	//5e-108
+	UINT64_C(0xbbe226efb628afea), UINT64_C(0x890489f70a55368b),	//5e-107
+	UINT64_C(0xeadab0aba3b2dbe5), UINT64_C(0x2b45ac74ccea842e),	//5e-106
+	UINT64_C(0x92c8ae6b464fc96f), UINT64_C(0x3b0b8bc90012929d),	//5e-105
+	UINT64_C(0xb77ada0617e3bbcb), UINT64_C(0x09ce6ebb40173744),	//5e-104
+	UINT64_C(0xe55990879ddcaabd), UINT64_C(0xcc420a6a101d0515),	//5e-103
+	UINT64_C(0x8f57fa54c2a9eab6), UINT64_C(0x9fa946824a12232d),	//5e-102
+	UINT64_C(0xb32df8e9f3546564), UINT64_C(0x47939822dc96abf9),	//5e-101
+	UINT64_C(0xdff9772470297ebd), UINT64_C(0x59787e2b93bc56f7),	//5e-100
+	UINT64_C(0x8bfbea76c619ef36), UINT64_C(0x57eb4edb3c55b65a),	//5e-99
+	UINT64_C(0xaefae51477a06b03), UINT64_C(0xede622920b6b23f1),	//5e-98
+	UINT64_C(0xdab99e59958885c4), UINT64_C(0xe95fab368e45eced),	//5e-97
+	UINT64_C(0x88b402f7fd75539b), UINT64_C(0x11dbcb0218ebb414),	//5e-96
+	UINT64_C(0xaae103b5fcd2a881), UINT64_C(0xd652bdc29f26a119),	//5e-95
+	UINT64_C(0xd59944a37c0752a2), UINT64_C(0x4be76d3346f0495f),	//5e-94
+	UINT64_C(0x857fcae62d8493a5), UINT64_C(0x6f70a4400c562ddb),	//5e-93
+	UINT64_C(0xa6dfbd9fb8e5b88e), UINT64_C(0xcb4ccd500f6bb952),	//5e-92
+	UINT64_C(0xd097ad07a71f26b2), UINT64_C(0x7e2000a41346a7a7),	//5e-91
+	UINT64_C(0x825ecc24c873782f), UINT64_C(0x8ed400668c0c28c8),	//5e-90
+	UINT64_C(0xa2f67f2dfa90563b), UINT64_C(0x728900802f0f32fa),	//5e-89
+	UINT64_C(0xcbb41ef979346bca), UINT64_C(0x4f2b40a03ad2ffb9),	//5e-88
+	UINT64_C(0xfea126b7d78186bc), UINT64_C(0xe2f610c84987bfa8),	//5e-87
+	UINT64_C(0x9f24b832e6b0f436), UINT64_C(0x0dd9ca7d2df4d7c9),	//5e-86
+	UINT64_C(0xc6ede63fa05d3143), UINT64_C(0x91503d1c79720dbb),	//5e-85
+	UINT64_C(0xf8a95fcf88747d94), UINT64_C(0x75a44c6397ce912a),	//5e-84
+	UINT64_C(0x9b69dbe1b548ce7c), UINT64_C(0xc986afbe3ee11aba),	//5e-83
+	UINT64_C(0xc24452da229b021b), UINT64_C(0xfbe85badce996168),	//5e-82
+	UINT64_C(0xf2d56790ab41c2a2), UINT64_C(0xfae27299423fb9c3),	//5e-81
+	UINT64_C(0x97c560ba6b0919a5), UINT64_C(0xdccd879fc967d41a),	//5e-80
+	UINT64_C(0xbdb6b8e905cb600f), UINT64_C(0x5400e987bbc1c920),	//5e-79
+	UINT64_C(0xed246723473e3813), UINT64_C(0x290123e9aab23b68),	//5e-78
+	UINT64_C(0x9436c0760c86e30b), UINT64_C(0xf9a0b6720aaf6521),	//5e-77
+	UINT64_C(0xb94470938fa89bce), UINT64_C(0xf808e40e8d5b3e69),	//5e-76
+	UINT64_C(0xe7958cb87392c2c2), UINT64_C(0xb60b1d1230b20e04),	//5e-75
+	UINT64_C(0x90bd77f3483bb9b9), UINT64_C(0xb1c6f22b5e6f48c2),	//5e-74
+	UINT64_C(0xb4ecd5f01a4aa828), UINT64_C(0x1e38aeb6360b1af3),	//5e-73
+	UINT64_C(0xe2280b6c20dd5232), UINT64_C(0x25c6da63c38de1b0),	//5e-72
+	UINT64_C(0x8d590723948a535f), UINT64_C(0x579c487e5a38ad0e),	//5e-71
+	UINT64_C(0xb0af48ec79ace837), UINT64_C(0x2d835a9df0c6d851),	//5e-70
+	UINT64_C(0xdcdb1b2798182244), UINT64_C(0xf8e431456cf88e65),	//5e-69
+	UINT64_C(0x8a08f0f8bf0f156b), UINT64_C(0x1b8e9ecb641b58ff),	//5e-68
+	UINT64_C(0xac8b2d36eed2dac5), UINT64_C(0xe272467e3d222f3f),	//5e-67
+	UINT64_C(0xd7adf884aa879177), UINT64_C(0x5b0ed81dcc6abb0f),	//5e-66
+	UINT64_C(0x86ccbb52ea94baea), UINT64_C(0x98e947129fc2b4e9),	//5e-65
+	UINT64_C(0xa87fea27a539e9a5), UINT64_C(0x3f2398d747b36224),	//5e-64
+	UINT64_C(0xd29fe4b18e88640e), UINT64_C(0x8eec7f0d19a03aad),	//5e-63
+	UINT64_C(0x83a3eeeef9153e89), UINT64_C(0x1953cf68300424ac),	//5e-62
+	UINT64_C(0xa48ceaaab75a8e2b), UINT64_C(0x5fa8c3423c052dd7),	//5e-61
+	UINT64_C(0xcdb02555653131b6), UINT64_C(0x3792f412cb06794d),	//5e-60
+	UINT64_C(0x808e17555f3ebf11), UINT64_C(0xe2bbd88bbee40bd0),	//5e-59
+	UINT64_C(0xa0b19d2ab70e6ed6), UINT64_C(0x5b6aceaeae9d0ec4),	//5e-58
+	UINT64_C(0xc8de047564d20a8b), UINT64_C(0xf245825a5a445275),	//5e-57
+	UINT64_C(0xfb158592be068d2e), UINT64_C(0xeed6e2f0f0d56712),	//5e-56
+	UINT64_C(0x9ced737bb6c4183d), UINT64_C(0x55464dd69685606b),	//5e-55
+	UINT64_C(0xc428d05aa4751e4c), UINT64_C(0xaa97e14c3c26b886),	//5e-54
+	UINT64_C(0xf53304714d9265df), UINT64_C(0xd53dd99f4b3066a8),	//5e-53
+	UINT64_C(0x993fe2c6d07b7fab), UINT64_C(0xe546a8038efe4029),	//5e-52
+	UINT64_C(0xbf8fdb78849a5f96), UINT64_C(0xde98520472bdd033),	//5e-51
+	UINT64_C(0xef73d256a5c0f77c), UINT64_C(0x963e66858f6d4440),	//5e-50
+	UINT64_C(0x95a8637627989aad), UINT64_C(0xdde7001379a44aa8),	//5e-49
+	UINT64_C(0xbb127c53b17ec159), UINT64_C(0x5560c018580d5d52),	//5e-48
+	UINT64_C(0xe9d71b689dde71af), UINT64_C(0xaab8f01e6e10b4a6),	//5e-47
+	UINT64_C(0x9226712162ab070d), UINT64_C(0xcab3961304ca70e8),	//5e-46
+	UINT64_C(0xb6b00d69bb55c8d1), UINT64_C(0x3d607b97c5fd0d22),	//5e-45
+	UINT64_C(0xe45c10c42a2b3b05), UINT64_C(0x8cb89a7db77c506a),	//5e-44
+	UINT64_C(0x8eb98a7a9a5b04e3), UINT64_C(0x77f3608e92adb242),	//5e-43
+	UINT64_C(0xb267ed1940f1c61c), UINT64_C(0x55f038b237591ed3),	//5e-42
+	UINT64_C(0xdf01e85f912e37a3), UINT64_C(0x6b6c46dec52f6688),	//5e-41
+	UINT64_C(0x8b61313bbabce2c6), UINT64_C(0x2323ac4b3b3da015),	//5e-40
+	UINT64_C(0xae397d8aa96c1b77), UINT64_C(0xabec975e0a0d081a),	//5e-39
+	UINT64_C(0xd9c7dced53c72255), UINT64_C(0x96e7bd358c904a21),	//5e-38
+	UINT64_C(0x881cea14545c7575), UINT64_C(0x7e50d64177da2e54),	//5e-37
+	UINT64_C(0xaa242499697392d2), UINT64_C(0xdde50bd1d5d0b9e9),	//5e-36
+	UINT64_C(0xd4ad2dbfc3d07787), UINT64_C(0x955e4ec64b44e864),	//5e-35
+	UINT64_C(0x84ec3c97da624ab4), UINT64_C(0xbd5af13bef0b113e),	//5e-34
+	UINT64_C(0xa6274bbdd0fadd61), UINT64_C(0xecb1ad8aeacdd58e),	//5e-33
+	UINT64_C(0xcfb11ead453994ba), UINT64_C(0x67de18eda5814af2),	//5e-32
+	UINT64_C(0x81ceb32c4b43fcf4), UINT64_C(0x80eacf948770ced7),	//5e-31
+	UINT64_C(0xa2425ff75e14fc31), UINT64_C(0xa1258379a94d028d),	//5e-30
+	UINT64_C(0xcad2f7f5359a3b3e), UINT64_C(0x096ee45813a04330),	//5e-29
+	UINT64_C(0xfd87b5f28300ca0d), UINT64_C(0x8bca9d6e188853fc),	//5e-28
+	UINT64_C(0x9e74d1b791e07e48), UINT64_C(0x775ea264cf55347e),	//5e-27
+	UINT64_C(0xc612062576589dda), UINT64_C(0x95364afe032a819e),	//5e-26
+	UINT64_C(0xf79687aed3eec551), UINT64_C(0x3a83ddbd83f52205),	//5e-25
+	UINT64_C(0x9abe14cd44753b52), UINT64_C(0xc4926a9672793543),	//5e-24
+	UINT64_C(0xc16d9a0095928a27), UINT64_C(0x75b7053c0f178294),	//5e-23
+	UINT64_C(0xf1c90080baf72cb1), UINT64_C(0x5324c68b12dd6339),	//5e-22
+	UINT64_C(0x971da05074da7bee), UINT64_C(0xd3f6fc16ebca5e04),	//5e-21
+	UINT64_C(0xbce5086492111aea), UINT64_C(0x88f4bb1ca6bcf585),	//5e-20
+	UINT64_C(0xec1e4a7db69561a5), UINT64_C(0x2b31e9e3d06c32e6),	//5e-19
+	UINT64_C(0x9392ee8e921d5d07), UINT64_C(0x3aff322e62439fd0),	//5e-18
+	UINT64_C(0xb877aa3236a4b449), UINT64_C(0x09befeb9fad487c3),	//5e-17
+	UINT64_C(0xe69594bec44de15b), UINT64_C(0x4c2ebe687989a9b4),	//5e-16
+	UINT64_C(0x901d7cf73ab0acd9), UINT64_C(0x0f9d37014bf60a11),	//5e-15
+	UINT64_C(0xb424dc35095cd80f), UINT64_C(0x538484c19ef38c95),	//5e-14
+	UINT64_C(0xe12e13424bb40e13), UINT64_C(0x2865a5f206b06fba),	//5e-13
+	UINT64_C(0x8cbccc096f5088cb), UINT64_C(0xf93f87b7442e45d4),	//5e-12
+	UINT64_C(0xafebff0bcb24aafe), UINT64_C(0xf78f69a51539d749),	//5e-11
+	UINT64_C(0xdbe6fecebdedd5be), UINT64_C(0xb573440e5a884d1c),	//5e-10
+	UINT64_C(0x89705f4136b4a597), UINT64_C(0x31680a88f8953031),	//5e-9
+	UINT64_C(0xabcc77118461cefc), UINT64_C(0xfdc20d2b36ba7c3e),	//5e-8
+	UINT64_C(0xd6bf94d5e57a42bc), UINT64_C(0x3d32907604691b4d),	//5e-7
+	UINT64_C(0x8637bd05af6c69b5), UINT64_C(0xa63f9a49c2c1b110),	//5e-6
+	UINT64_C(0xa7c5ac471b478423), UINT64_C(0x0fcf80dc33721d54),	//5e-5
+	UINT64_C(0xd1b71758e219652b), UINT64_C(0xd3c36113404ea4a9),	//5e-4
+	UINT64_C(0x83126e978d4fdf3b), UINT64_C(0x645a1cac083126ea),	//5e-3
+	UINT64_C(0xa3d70a3d70a3d70a), UINT64_C(0x3d70a3d70a3d70a4),	//5e-2
+	UINT64_C(0xcccccccccccccccc), UINT64_C(0xcccccccccccccccd),	//5e-1
+	UINT64_C(0x8000000000000000), UINT64_C(0x0000000000000000),	//5e0
+	UINT64_C(0xa000000000000000), UINT64_C(0x0000000000000000),	//5e1
+	UINT64_C(0xc800000000000000), UINT64_C(0x0000000000000000),	//5e2
+	UINT64_C(0xfa00000000000000), UINT64_C(0x0000000000000000),	//5e3
+	UINT64_C(0x9c40000000000000), UINT64_C(0x0000000000000000),	//5e4
+	UINT64_C(0xc350000000000000), UINT64_C(0x0000000000000000),	//5e5
+	UINT64_C(0xf424000000000000), UINT64_C(0x0000000000000000),	//5e6
+	UINT64_C(0x9896800000000000), UINT64_C(0x0000000000000000),	//5e7
+	UINT64_C(0xbebc200000000000), UINT64_C(0x0000000000000000),	//5e8
+	UINT64_C(0xee6b280000000000), UINT64_C(0x0000000000000000),	//5e9
+	UINT64_C(0x9502f90000000000), UINT64_C(0x0000000000000000),	//5e10
+	UINT64_C(0xba43b74000000000), UINT64_C(0x0000000000000000),	//5e11
+	UINT64_C(0xe8d4a51000000000), UINT64_C(0x0000000000000000),	//5e12
+	UINT64_C(0x9184e72a00000000), UINT64_C(0x0000000000000000),	//5e13
+	UINT64_C(0xb5e620f480000000), UINT64_C(0x0000000000000000),	//5e14
+	UINT64_C(0xe35fa931a0000000), UINT64_C(0x0000000000000000),	//5e15
+	UINT64_C(0x8e1bc9bf04000000), UINT64_C(0x0000000000000000),	//5e16
+	UINT64_C(0xb1a2bc2ec5000000), UINT64_C(0x0000000000000000),	//5e17
+	UINT64_C(0xde0b6b3a76400000), UINT64_C(0x0000000000000000),	//5e18
+	UINT64_C(0x8ac7230489e80000), UINT64_C(0x0000000000000000),	//5e19
+	UINT64_C(0xad78ebc5ac620000), UINT64_C(0x0000000000000000),	//5e20
+	UINT64_C(0xd8d726b7177a8000), UINT64_C(0x0000000000000000),	//5e21
+	UINT64_C(0x878678326eac9000), UINT64_C(0x0000000000000000),	//5e22
+	UINT64_C(0xa968163f0a57b400), UINT64_C(0x0000000000000000),	//5e23
+	UINT64_C(0xd3c21bcecceda100), UINT64_C(0x0000000000000000),	//5e24
+	UINT64_C(0x84595161401484a0), UINT64_C(0x0000000000000000),	//5e25
+	UINT64_C(0xa56fa5b99019a5c8), UINT64_C(0x0000000000000000),	//5e26
+	UINT64_C(0xcecb8f27f4200f3a), UINT64_C(0x0000000000000000),	//5e27
+	UINT64_C(0x813f3978f8940984), UINT64_C(0x4000000000000000),	//5e28
+	UINT64_C(0xa18f07d736b90be5), UINT64_C(0x5000000000000000),	//5e29
+	UINT64_C(0xc9f2c9cd04674ede), UINT64_C(0xa400000000000000),	//5e30
+	UINT64_C(0xfc6f7c4045812296), UINT64_C(0x4d00000000000000),	//5e31
+	UINT64_C(0x9dc5ada82b70b59d), UINT64_C(0xf020000000000000),	//5e32
+	UINT64_C(0xc5371912364ce305), UINT64_C(0x6c28000000000000),	//5e33
+	UINT64_C(0xf684df56c3e01bc6), UINT64_C(0xc732000000000000),	//5e34
+	UINT64_C(0x9a130b963a6c115c), UINT64_C(0x3c7f400000000000),	//5e35
+	UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x4b9f100000000000),	//5e36
+	UINT64_C(0xf0bdc21abb48db20), UINT64_C(0x1e86d40000000000),	//5e37
+	UINT64_C(0x96769950b50d88f4), UINT64_C(0x1314448000000000),	//5e38
+	UINT64_C(0xbc143fa4e250eb31), UINT64_C(0x17d955a000000000),	//5e39
+	UINT64_C(0xeb194f8e1ae525fd), UINT64_C(0x5dcfab0800000000),	//5e40
+	UINT64_C(0x92efd1b8d0cf37be), UINT64_C(0x5aa1cae500000000),	//5e41
+	UINT64_C(0xb7abc627050305ad), UINT64_C(0xf14a3d9e40000000),	//5e42
+	UINT64_C(0xe596b7b0c643c719), UINT64_C(0x6d9ccd05d0000000),	//5e43
+	UINT64_C(0x8f7e32ce7bea5c6f), UINT64_C(0xe4820023a2000000),	//5e44
+	UINT64_C(0xb35dbf821ae4f38b), UINT64_C(0xdda2802c8a800000),	//5e45
+	UINT64_C(0xe0352f62a19e306e), UINT64_C(0xd50b2037ad200000),	//5e46
+	UINT64_C(0x8c213d9da502de45), UINT64_C(0x4526f422cc340000),	//5e47
+	UINT64_C(0xaf298d050e4395d6), UINT64_C(0x9670b12b7f410000),	//5e48
+	UINT64_C(0xdaf3f04651d47b4c), UINT64_C(0x3c0cdd765f114000),	//5e49
+	UINT64_C(0x88d8762bf324cd0f), UINT64_C(0xa5880a69fb6ac800),	//5e50
+	UINT64_C(0xab0e93b6efee0053), UINT64_C(0x8eea0d047a457a00),	//5e51
+	UINT64_C(0xd5d238a4abe98068), UINT64_C(0x72a4904598d6d880),	//5e52
+	UINT64_C(0x85a36366eb71f041), UINT64_C(0x47a6da2b7f864750),	//5e53
+	UINT64_C(0xa70c3c40a64e6c51), UINT64_C(0x999090b65f67d924),	//5e54
+	UINT64_C(0xd0cf4b50cfe20765), UINT64_C(0xfff4b4e3f741cf6d),	//5e55
+	UINT64_C(0x82818f1281ed449f), UINT64_C(0xbff8f10e7a8921a4),	//5e56
+	UINT64_C(0xa321f2d7226895c7), UINT64_C(0xaff72d52192b6a0d),	//5e57
+	UINT64_C(0xcbea6f8ceb02bb39), UINT64_C(0x9bf4f8a69f764490),	//5e58
+	UINT64_C(0xfee50b7025c36a08), UINT64_C(0x02f236d04753d5b4),	//5e59
+	UINT64_C(0x9f4f2726179a2245), UINT64_C(0x01d762422c946590),	//5e60
+	UINT64_C(0xc722f0ef9d80aad6), UINT64_C(0x424d3ad2b7b97ef5),	//5e61
+	UINT64_C(0xf8ebad2b84e0d58b), UINT64_C(0xd2e0898765a7deb2),	//5e62
+	UINT64_C(0x9b934c3b330c8577), UINT64_C(0x63cc55f49f88eb2f),	//5e63
+	UINT64_C(0xc2781f49ffcfa6d5), UINT64_C(0x3cbf6b71c76b25fb),	//5e64
+	UINT64_C(0xf316271c7fc3908a), UINT64_C(0x8bef464e3945ef7a),	//5e65
+	UINT64_C(0x97edd871cfda3a56), UINT64_C(0x97758bf0e3cbb5ac),	//5e66
+	UINT64_C(0xbde94e8e43d0c8ec), UINT64_C(0x3d52eeed1cbea317),	//5e67
+	UINT64_C(0xed63a231d4c4fb27), UINT64_C(0x4ca7aaa863ee4bdd),	//5e68
+	UINT64_C(0x945e455f24fb1cf8), UINT64_C(0x8fe8caa93e74ef6a),	//5e69
+	UINT64_C(0xb975d6b6ee39e436), UINT64_C(0xb3e2fd538e122b44),	//5e70
+	UINT64_C(0xe7d34c64a9c85d44), UINT64_C(0x60dbbca87196b616),	//5e71
+	UINT64_C(0x90e40fbeea1d3a4a), UINT64_C(0xbc8955e946fe31cd),	//5e72
+	UINT64_C(0xb51d13aea4a488dd), UINT64_C(0x6babab6398bdbe41),	//5e73
+	UINT64_C(0xe264589a4dcdab14), UINT64_C(0xc696963c7eed2dd1),	//5e74
+	UINT64_C(0x8d7eb76070a08aec), UINT64_C(0xfc1e1de5cf543ca2),	//5e75
+	UINT64_C(0xb0de65388cc8ada8), UINT64_C(0x3b25a55f43294bcb),	//5e76
+	UINT64_C(0xdd15fe86affad912), UINT64_C(0x49ef0eb713f39ebe),	//5e77
+	UINT64_C(0x8a2dbf142dfcc7ab), UINT64_C(0x6e3569326c784337),	//5e78
+	UINT64_C(0xacb92ed9397bf996), UINT64_C(0x49c2c37f07965404),	//5e79
+	UINT64_C(0xd7e77a8f87daf7fb), UINT64_C(0xdc33745ec97be906),	//5e80
+	UINT64_C(0x86f0ac99b4e8dafd), UINT64_C(0x69a028bb3ded71a3),	//5e81
+	UINT64_C(0xa8acd7c0222311bc), UINT64_C(0xc40832ea0d68ce0c),	//5e82
+	UINT64_C(0xd2d80db02aabd62b), UINT64_C(0xf50a3fa490c30190),	//5e83
+	UINT64_C(0x83c7088e1aab65db), UINT64_C(0x792667c6da79e0fa),	//5e84
+	UINT64_C(0xa4b8cab1a1563f52), UINT64_C(0x577001b891185938),	//5e85
+	UINT64_C(0xcde6fd5e09abcf26), UINT64_C(0xed4c0226b55e6f86),	//5e86
+	UINT64_C(0x80b05e5ac60b6178), UINT64_C(0x544f8158315b05b4),	//5e87
+	UINT64_C(0xa0dc75f1778e39d6), UINT64_C(0x696361ae3db1c721),	//5e88
+	UINT64_C(0xc913936dd571c84c), UINT64_C(0x03bc3a19cd1e38e9),	//5e89
+	UINT64_C(0xfb5878494ace3a5f), UINT64_C(0x04ab48a04065c723),	//5e90
+	UINT64_C(0x9d174b2dcec0e47b), UINT64_C(0x62eb0d64283f9c76),	//5e91
+	UINT64_C(0xc45d1df942711d9a), UINT64_C(0x3ba5d0bd324f8394),	//5e92
+	UINT64_C(0xf5746577930d6500), UINT64_C(0xca8f44ec7ee36479),	//5e93
+	UINT64_C(0x9968bf6abbe85f20), UINT64_C(0x7e998b13cf4e1ecb),	//5e94
+	UINT64_C(0xbfc2ef456ae276e8), UINT64_C(0x9e3fedd8c321a67e),	//5e95
+	UINT64_C(0xefb3ab16c59b14a2), UINT64_C(0xc5cfe94ef3ea101e),	//5e96
+	UINT64_C(0x95d04aee3b80ece5), UINT64_C(0xbba1f1d158724a12),	//5e97
+	UINT64_C(0xbb445da9ca61281f), UINT64_C(0x2a8a6e45ae8edc97),	//5e98
+	UINT64_C(0xea1575143cf97226), UINT64_C(0xf52d09d71a3293bd),	//5e99
+	UINT64_C(0x924d692ca61be758), UINT64_C(0x593c2626705f9c56),	//5e100
+	UINT64_C(0xb6e0c377cfa2e12e), UINT64_C(0x6f8b2fb00c77836c),	//5e101
+	UINT64_C(0xe498f455c38b997a), UINT64_C(0x0b6dfb9c0f956447),	//5e102
+	UINT64_C(0x8edf98b59a373fec), UINT64_C(0x4724bd4189bd5eac),	//5e103
+	UINT64_C(0xb2977ee300c50fe7), UINT64_C(0x58edec91ec2cb657),	//5e104
+	UINT64_C(0xdf3d5e9bc0f653e1), UINT64_C(0x2f2967b66737e3ed),	//5e105
+	UINT64_C(0x8b865b215899f46c), UINT64_C(0xbd79e0d20082ee74),	//5e106
+	UINT64_C(0xae67f1e9aec07187), UINT64_C(0xecd8590680a3aa11),	//5e107
+	UINT64_C(0xda01ee641a708de9), UINT64_C(0xe80e6f4820cc9495),	//5e108
+	UINT64_C(0x884134fe908658b2), UINT64_C(0x3109058d147fdcdd),	//5e109
+	UINT64_C(0xaa51823e34a7eede), UINT64_C(0xbd4b46f0599fd415),	//5e110
+	UINT64_C(0xd4e5e2cdc1d1ea96), UINT64_C(0x6c9e18ac7007c91a),	//5e111
+	UINT64_C(0x850fadc09923329e), UINT64_C(0x03e2cf6bc604ddb0),	//5e112
+	UINT64_C(0xa6539930bf6bff45), UINT64_C(0x84db8346b786151c),	//5e113
+	UINT64_C(0xcfe87f7cef46ff16), UINT64_C(0xe612641865679a63),	//5e114
+	UINT64_C(0x81f14fae158c5f6e), UINT64_C(0x4fcb7e8f3f60c07e),	//5e115
+	UINT64_C(0xa26da3999aef7749), UINT64_C(0xe3be5e330f38f09d),	//5e116
+	UINT64_C(0xcb090c8001ab551c), UINT64_C(0x5cadf5bfd3072cc5),	//5e117
+	UINT64_C(0xfdcb4fa002162a63), UINT64_C(0x73d9732fc7c8f7f6),	//5e118
+	UINT64_C(0x9e9f11c4014dda7e), UINT64_C(0x2867e7fddcdd9afa),	//5e119
+	UINT64_C(0xc646d63501a1511d), UINT64_C(0xb281e1fd541501b8),	//5e120
+	UINT64_C(0xf7d88bc24209a565), UINT64_C(0x1f225a7ca91a4226),	//5e121
+	UINT64_C(0x9ae757596946075f), UINT64_C(0x3375788de9b06958),	//5e122
+	UINT64_C(0xc1a12d2fc3978937), UINT64_C(0x0052d6b1641c83ae),	//5e123
+	UINT64_C(0xf209787bb47d6b84), UINT64_C(0xc0678c5dbd23a49a),	//5e124
+	UINT64_C(0x9745eb4d50ce6332), UINT64_C(0xf840b7ba963646e0),	//5e125
+	UINT64_C(0xbd176620a501fbff), UINT64_C(0xb650e5a93bc3d898),	//5e126
+	UINT64_C(0xec5d3fa8ce427aff), UINT64_C(0xa3e51f138ab4cebe),	//5e127
+	UINT64_C(0x93ba47c980e98cdf), UINT64_C(0xc66f336c36b10137),	//5e128
+	UINT64_C(0xb8a8d9bbe123f017), UINT64_C(0xb80b0047445d4184),	//5e129
+	UINT64_C(0xe6d3102ad96cec1d), UINT64_C(0xa60dc059157491e5),	//5e130
+	UINT64_C(0x9043ea1ac7e41392), UINT64_C(0x87c89837ad68db2f),	//5e131
+	UINT64_C(0xb454e4a179dd1877), UINT64_C(0x29babe4598c311fb),	//5e132
+	UINT64_C(0xe16a1dc9d8545e94), UINT64_C(0xf4296dd6fef3d67a),	//5e133
+	UINT64_C(0x8ce2529e2734bb1d), UINT64_C(0x1899e4a65f58660c),	//5e134
+	UINT64_C(0xb01ae745b101e9e4), UINT64_C(0x5ec05dcff72e7f8f),	//5e135
+	UINT64_C(0xdc21a1171d42645d), UINT64_C(0x76707543f4fa1f73),	//5e136
+	UINT64_C(0x899504ae72497eba), UINT64_C(0x6a06494a791c53a8),	//5e137
+	UINT64_C(0xabfa45da0edbde69), UINT64_C(0x0487db9d17636892),	//5e138
+	UINT64_C(0xd6f8d7509292d603), UINT64_C(0x45a9d2845d3c42b6),	//5e139
+	UINT64_C(0x865b86925b9bc5c2), UINT64_C(0x0b8a2392ba45a9b2),	//5e140
+	UINT64_C(0xa7f26836f282b732), UINT64_C(0x8e6cac7768d7141e),	//5e141
+	UINT64_C(0xd1ef0244af2364ff), UINT64_C(0x3207d795430cd926),	//5e142
+	UINT64_C(0x8335616aed761f1f), UINT64_C(0x7f44e6bd49e807b8),	//5e143
+	UINT64_C(0xa402b9c5a8d3a6e7), UINT64_C(0x5f16206c9c6209a6),	//5e144
+	UINT64_C(0xcd036837130890a1), UINT64_C(0x36dba887c37a8c0f),	//5e145
+	UINT64_C(0x802221226be55a64), UINT64_C(0xc2494954da2c9789),	//5e146
+	UINT64_C(0xa02aa96b06deb0fd), UINT64_C(0xf2db9baa10b7bd6c),	//5e147
+	UINT64_C(0xc83553c5c8965d3d), UINT64_C(0x6f92829494e5acc7),	//5e148
+	UINT64_C(0xfa42a8b73abbf48c), UINT64_C(0xcb772339ba1f17f9),	//5e149
+	UINT64_C(0x9c69a97284b578d7), UINT64_C(0xff2a760414536efb),	//5e150
+	UINT64_C(0xc38413cf25e2d70d), UINT64_C(0xfef5138519684aba),	//5e151
+	UINT64_C(0xf46518c2ef5b8cd1), UINT64_C(0x7eb258665fc25d69),	//5e152
+	UINT64_C(0x98bf2f79d5993802), UINT64_C(0xef2f773ffbd97a61),	//5e153
+	UINT64_C(0xbeeefb584aff8603), UINT64_C(0xaafb550ffacfd8fa),	//5e154
+	UINT64_C(0xeeaaba2e5dbf6784), UINT64_C(0x95ba2a53f983cf38),	//5e155
+	UINT64_C(0x952ab45cfa97a0b2), UINT64_C(0xdd945a747bf26183),	//5e156
+	UINT64_C(0xba756174393d88df), UINT64_C(0x94f971119aeef9e4),	//5e157
+	UINT64_C(0xe912b9d1478ceb17), UINT64_C(0x7a37cd5601aab85d),	//5e158
+	UINT64_C(0x91abb422ccb812ee), UINT64_C(0xac62e055c10ab33a),	//5e159
+	UINT64_C(0xb616a12b7fe617aa), UINT64_C(0x577b986b314d6009),	//5e160
+	UINT64_C(0xe39c49765fdf9d94), UINT64_C(0xed5a7e85fda0b80b),	//5e161
+	UINT64_C(0x8e41ade9fbebc27d), UINT64_C(0x14588f13be847307),	//5e162
+	UINT64_C(0xb1d219647ae6b31c), UINT64_C(0x596eb2d8ae258fc8),	//5e163
+	UINT64_C(0xde469fbd99a05fe3), UINT64_C(0x6fca5f8ed9aef3bb),	//5e164
+	UINT64_C(0x8aec23d680043bee), UINT64_C(0x25de7bb9480d5854),	//5e165
+	UINT64_C(0xada72ccc20054ae9), UINT64_C(0xaf561aa79a10ae6a),	//5e166
+	UINT64_C(0xd910f7ff28069da4), UINT64_C(0x1b2ba1518094da04),	//5e167
+	UINT64_C(0x87aa9aff79042286), UINT64_C(0x90fb44d2f05d0842),	//5e168
+	UINT64_C(0xa99541bf57452b28), UINT64_C(0x353a1607ac744a53),	//5e169
+	UINT64_C(0xd3fa922f2d1675f2), UINT64_C(0x42889b8997915ce8),	//5e170
+	UINT64_C(0x847c9b5d7c2e09b7), UINT64_C(0x69956135febada11),	//5e171
+	UINT64_C(0xa59bc234db398c25), UINT64_C(0x43fab9837e699095),	//5e172
+	UINT64_C(0xcf02b2c21207ef2e), UINT64_C(0x94f967e45e03f4bb),	//5e173
+	UINT64_C(0x8161afb94b44f57d), UINT64_C(0x1d1be0eebac278f5),	//5e174
+	UINT64_C(0xa1ba1ba79e1632dc), UINT64_C(0x6462d92a69731732),	//5e175
+	UINT64_C(0xca28a291859bbf93), UINT64_C(0x7d7b8f7503cfdcfe),	//5e176
+	UINT64_C(0xfcb2cb35e702af78), UINT64_C(0x5cda735244c3d43e),	//5e177
+	UINT64_C(0x9defbf01b061adab), UINT64_C(0x3a0888136afa64a7),	//5e178
+	UINT64_C(0xc56baec21c7a1916), UINT64_C(0x088aaa1845b8fdd0),	//5e179
+	UINT64_C(0xf6c69a72a3989f5b), UINT64_C(0x8aad549e57273d45),	//5e180
+	UINT64_C(0x9a3c2087a63f6399), UINT64_C(0x36ac54e2f678864b),	//5e181
+	UINT64_C(0xc0cb28a98fcf3c7f), UINT64_C(0x84576a1bb416a7dd),	//5e182
+	UINT64_C(0xf0fdf2d3f3c30b9f), UINT64_C(0x656d44a2a11c51d5),	//5e183
+	UINT64_C(0x969eb7c47859e743), UINT64_C(0x9f644ae5a4b1b325),	//5e184
+	UINT64_C(0xbc4665b596706114), UINT64_C(0x873d5d9f0dde1fee),	//5e185
+	UINT64_C(0xeb57ff22fc0c7959), UINT64_C(0xa90cb506d155a7ea),	//5e186
+	UINT64_C(0x9316ff75dd87cbd8), UINT64_C(0x09a7f12442d588f2),	//5e187
+	UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x0c11ed6d538aeb2f),	//5e188
+	UINT64_C(0xe5d3ef282a242e81), UINT64_C(0x8f1668c8a86da5fa),	//5e189
+	UINT64_C(0x8fa475791a569d10), UINT64_C(0xf96e017d694487bc),	//5e190
+	UINT64_C(0xb38d92d760ec4455), UINT64_C(0x37c981dcc395a9ac),	//5e191
+	UINT64_C(0xe070f78d3927556a), UINT64_C(0x85bbe253f47b1417),	//5e192
+	UINT64_C(0x8c469ab843b89562), UINT64_C(0x93956d7478ccec8e),	//5e193
+	UINT64_C(0xaf58416654a6babb), UINT64_C(0x387ac8d1970027b2),	//5e194
+	UINT64_C(0xdb2e51bfe9d0696a), UINT64_C(0x06997b05fcc0319e),	//5e195
+	UINT64_C(0x88fcf317f22241e2), UINT64_C(0x441fece3bdf81f03),	//5e196
+	UINT64_C(0xab3c2fddeeaad25a), UINT64_C(0xd527e81cad7626c3),	//5e197
+	UINT64_C(0xd60b3bd56a5586f1), UINT64_C(0x8a71e223d8d3b074),	//5e198
+	UINT64_C(0x85c7056562757456), UINT64_C(0xf6872d5667844e49),	//5e199
+	UINT64_C(0xa738c6bebb12d16c), UINT64_C(0xb428f8ac016561db),	//5e200
+	UINT64_C(0xd106f86e69d785c7), UINT64_C(0xe13336d701beba52),	//5e201
+	UINT64_C(0x82a45b450226b39c), UINT64_C(0xecc0024661173473),	//5e202
+	UINT64_C(0xa34d721642b06084), UINT64_C(0x27f002d7f95d0190),	//5e203
+	UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x31ec038df7b441f4),	//5e204
+	UINT64_C(0xff290242c83396ce), UINT64_C(0x7e67047175a15271),	//5e205
+	UINT64_C(0x9f79a169bd203e41), UINT64_C(0x0f0062c6e984d386),	//5e206
+	UINT64_C(0xc75809c42c684dd1), UINT64_C(0x52c07b78a3e60868),	//5e207
+	UINT64_C(0xf92e0c3537826145), UINT64_C(0xa7709a56ccdf8a82),	//5e208
+	UINT64_C(0x9bbcc7a142b17ccb), UINT64_C(0x88a66076400bb691),	//5e209
+	UINT64_C(0xc2abf989935ddbfe), UINT64_C(0x6acff893d00ea435),	//5e210
+	UINT64_C(0xf356f7ebf83552fe), UINT64_C(0x0583f6b8c4124d43),	//5e211
+	UINT64_C(0x98165af37b2153de), UINT64_C(0xc3727a337a8b704a),	//5e212
+	UINT64_C(0xbe1bf1b059e9a8d6), UINT64_C(0x744f18c0592e4c5c),	//5e213
+	UINT64_C(0xeda2ee1c7064130c), UINT64_C(0x1162def06f79df73),	//5e214
+	UINT64_C(0x9485d4d1c63e8be7), UINT64_C(0x8addcb5645ac2ba8),	//5e215
+	UINT64_C(0xb9a74a0637ce2ee1), UINT64_C(0x6d953e2bd7173692),	//5e216
+	UINT64_C(0xe8111c87c5c1ba99), UINT64_C(0xc8fa8db6ccdd0437),	//5e217
+	UINT64_C(0x910ab1d4db9914a0), UINT64_C(0x1d9c9892400a22a2),	//5e218
+	UINT64_C(0xb54d5e4a127f59c8), UINT64_C(0x2503beb6d00cab4b),	//5e219
+	UINT64_C(0xe2a0b5dc971f303a), UINT64_C(0x2e44ae64840fd61d),	//5e220
+	UINT64_C(0x8da471a9de737e24), UINT64_C(0x5ceaecfed289e5d2),	//5e221
+	UINT64_C(0xb10d8e1456105dad), UINT64_C(0x7425a83e872c5f47),	//5e222
+	UINT64_C(0xdd50f1996b947518), UINT64_C(0xd12f124e28f77719),	//5e223
+	UINT64_C(0x8a5296ffe33cc92f), UINT64_C(0x82bd6b70d99aaa6f),	//5e224
+	UINT64_C(0xace73cbfdc0bfb7b), UINT64_C(0x636cc64d1001550b),	//5e225
+	UINT64_C(0xd8210befd30efa5a), UINT64_C(0x3c47f7e05401aa4e),	//5e226
+	UINT64_C(0x8714a775e3e95c78), UINT64_C(0x65acfaec34810a71),	//5e227
+	UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0x7f1839a741a14d0d),	//5e228
+	UINT64_C(0xd31045a8341ca07c), UINT64_C(0x1ede48111209a050),	//5e229
+	UINT64_C(0x83ea2b892091e44d), UINT64_C(0x934aed0aab460432),	//5e230
+	UINT64_C(0xa4e4b66b68b65d60), UINT64_C(0xf81da84d5617853f),	//5e231
+	UINT64_C(0xce1de40642e3f4b9), UINT64_C(0x36251260ab9d668e),	//5e232
+	UINT64_C(0x80d2ae83e9ce78f3), UINT64_C(0xc1d72b7c6b426019),	//5e233
+	UINT64_C(0xa1075a24e4421730), UINT64_C(0xb24cf65b8612f81f),	//5e234
+	UINT64_C(0xc94930ae1d529cfc), UINT64_C(0xdee033f26797b627),	//5e235
+	UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0x169840ef017da3b1),	//5e236
+	UINT64_C(0x9d412e0806e88aa5), UINT64_C(0x8e1f289560ee864e),	//5e237
+	UINT64_C(0xc491798a08a2ad4e), UINT64_C(0xf1a6f2bab92a27e2),	//5e238
+	UINT64_C(0xf5b5d7ec8acb58a2), UINT64_C(0xae10af696774b1db),	//5e239
+	UINT64_C(0x9991a6f3d6bf1765), UINT64_C(0xacca6da1e0a8ef29),	//5e240
+	UINT64_C(0xbff610b0cc6edd3f), UINT64_C(0x17fd090a58d32af3),	//5e241
+	UINT64_C(0xeff394dcff8a948e), UINT64_C(0xddfc4b4cef07f5b0),	//5e242
+	UINT64_C(0x95f83d0a1fb69cd9), UINT64_C(0x4abdaf101564f98e),	//5e243
+	UINT64_C(0xbb764c4ca7a4440f), UINT64_C(0x9d6d1ad41abe37f1),	//5e244
+	UINT64_C(0xea53df5fd18d5513), UINT64_C(0x84c86189216dc5ed),	//5e245
+	UINT64_C(0x92746b9be2f8552c), UINT64_C(0x32fd3cf5b4e49bb4),	//5e246
+	UINT64_C(0xb7118682dbb66a77), UINT64_C(0x3fbc8c33221dc2a1),	//5e247
+	UINT64_C(0xe4d5e82392a40515), UINT64_C(0x0fabaf3feaa5334a),	//5e248
+	UINT64_C(0x8f05b1163ba6832d), UINT64_C(0x29cb4d87f2a7400e),	//5e249
+	UINT64_C(0xb2c71d5bca9023f8), UINT64_C(0x743e20e9ef511012),	//5e250
+	UINT64_C(0xdf78e4b2bd342cf6), UINT64_C(0x914da9246b255416),	//5e251
+	UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0x1ad089b6c2f7548e),	//5e252
+	UINT64_C(0xae9672aba3d0c320), UINT64_C(0xa184ac2473b529b1),	//5e253
+	UINT64_C(0xda3c0f568cc4f3e8), UINT64_C(0xc9e5d72d90a2741e),	//5e254
+	UINT64_C(0x8865899617fb1871), UINT64_C(0x7e2fa67c7a658892),	//5e255
+	UINT64_C(0xaa7eebfb9df9de8d), UINT64_C(0xddbb901b98feeab7),	//5e256
+	UINT64_C(0xd51ea6fa85785631), UINT64_C(0x552a74227f3ea565),	//5e257
+	UINT64_C(0x8533285c936b35de), UINT64_C(0xd53a88958f87275f),	//5e258
+	UINT64_C(0xa67ff273b8460356), UINT64_C(0x8a892abaf368f137),	//5e259
+	UINT64_C(0xd01fef10a657842c), UINT64_C(0x2d2b7569b0432d85),	//5e260
+	UINT64_C(0x8213f56a67f6b29b), UINT64_C(0x9c3b29620e29fc73),	//5e261
+	UINT64_C(0xa298f2c501f45f42), UINT64_C(0x8349f3ba91b47b8f),	//5e262
+	UINT64_C(0xcb3f2f7642717713), UINT64_C(0x241c70a936219a73),	//5e263
+	UINT64_C(0xfe0efb53d30dd4d7), UINT64_C(0xed238cd383aa0110),	//5e264
+	UINT64_C(0x9ec95d1463e8a506), UINT64_C(0xf4363804324a40aa),	//5e265
+	UINT64_C(0xc67bb4597ce2ce48), UINT64_C(0xb143c6053edcd0d5),	//5e266
+	UINT64_C(0xf81aa16fdc1b81da), UINT64_C(0xdd94b7868e94050a),	//5e267
+	UINT64_C(0x9b10a4e5e9913128), UINT64_C(0xca7cf2b4191c8326),	//5e268
+	UINT64_C(0xc1d4ce1f63f57d72), UINT64_C(0xfd1c2f611f63a3f0),	//5e269
+	UINT64_C(0xf24a01a73cf2dccf), UINT64_C(0xbc633b39673c8cec),	//5e270
+	UINT64_C(0x976e41088617ca01), UINT64_C(0xd5be0503e085d813),	//5e271
+	UINT64_C(0xbd49d14aa79dbc82), UINT64_C(0x4b2d8644d8a74e18),	//5e272
+	UINT64_C(0xec9c459d51852ba2), UINT64_C(0xddf8e7d60ed1219e),	//5e273
+	UINT64_C(0x93e1ab8252f33b45), UINT64_C(0xcabb90e5c942b503),	//5e274
+	UINT64_C(0xb8da1662e7b00a17), UINT64_C(0x3d6a751f3b936243),	//5e275
+	UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0x0cc512670a783ad4),	//5e276
+	UINT64_C(0x906a617d450187e2), UINT64_C(0x27fb2b80668b24c5),	//5e277
+	UINT64_C(0xb484f9dc9641e9da), UINT64_C(0xb1f9f660802dedf6),	//5e278
+	UINT64_C(0xe1a63853bbd26451), UINT64_C(0x5e7873f8a0396973),	//5e279
+	UINT64_C(0x8d07e33455637eb2), UINT64_C(0xdb0b487b6423e1e8),	//5e280
+	UINT64_C(0xb049dc016abc5e5f), UINT64_C(0x91ce1a9a3d2cda62),	//5e281
+	UINT64_C(0xdc5c5301c56b75f7), UINT64_C(0x7641a140cc7810fb),	//5e282
+	UINT64_C(0x89b9b3e11b6329ba), UINT64_C(0xa9e904c87fcb0a9d),	//5e283
+	UINT64_C(0xac2820d9623bf429), UINT64_C(0x546345fa9fbdcd44),	//5e284
+	UINT64_C(0xd732290fbacaf133), UINT64_C(0xa97c177947ad4095),	//5e285
+	UINT64_C(0x867f59a9d4bed6c0), UINT64_C(0x49ed8eabcccc485d),	//5e286
+	UINT64_C(0xa81f301449ee8c70), UINT64_C(0x5c68f256bfff5a74),	//5e287
+	UINT64_C(0xd226fc195c6a2f8c), UINT64_C(0x73832eec6fff3111),	//5e288
+	UINT64_C(0x83585d8fd9c25db7), UINT64_C(0xc831fd53c5ff7eab),	//5e289
+	UINT64_C(0xa42e74f3d032f525), UINT64_C(0xba3e7ca8b77f5e55),	//5e290
+	UINT64_C(0xcd3a1230c43fb26f), UINT64_C(0x28ce1bd2e55f35eb),	//5e291
+	UINT64_C(0x80444b5e7aa7cf85), UINT64_C(0x7980d163cf5b81b3),	//5e292
+	UINT64_C(0xa0555e361951c366), UINT64_C(0xd7e105bcc332621f),	//5e293
+	UINT64_C(0xc86ab5c39fa63440), UINT64_C(0x8dd9472bf3fefaa7),	//5e294
+	UINT64_C(0xfa856334878fc150), UINT64_C(0xb14f98f6f0feb951),	//5e295
+	UINT64_C(0x9c935e00d4b9d8d2), UINT64_C(0x6ed1bf9a569f33d3),	//5e296
+	UINT64_C(0xc3b8358109e84f07), UINT64_C(0x0a862f80ec4700c8),	//5e297
+	UINT64_C(0xf4a642e14c6262c8), UINT64_C(0xcd27bb612758c0fa),	//5e298
+	UINT64_C(0x98e7e9cccfbd7dbd), UINT64_C(0x8038d51cb897789c),	//5e299
+	UINT64_C(0xbf21e44003acdd2c), UINT64_C(0xe0470a63e6bd56c3),	//5e300
+	UINT64_C(0xeeea5d5004981478), UINT64_C(0x1858ccfce06cac74),	//5e301
+	UINT64_C(0x95527a5202df0ccb), UINT64_C(0x0f37801e0c43ebc8),	//5e302
+	UINT64_C(0xbaa718e68396cffd), UINT64_C(0xd30560258f54e6ba),	//5e303
+	UINT64_C(0xe950df20247c83fd), UINT64_C(0x47c6b82ef32a2069),	//5e304
+	UINT64_C(0x91d28b7416cdd27e), UINT64_C(0x4cdc331d57fa5441),	//5e305
+	UINT64_C(0xb6472e511c81471d), UINT64_C(0xe0133fe4adf8e952),	//5e306
+	UINT64_C(0xe3d8f9e563a198e5), UINT64_C(0x58180fddd97723a6),	//5e307
+	UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0x570f09eaa7ea7648),	//5e308
+};
+
 #else
 
 #define JSOP_MPN_NUMBER_OF_SMALL_POWERS_OF_FIVE_BITS 3
@@ -1933,6 +2595,683 @@ static const uint16_t JsopNormalizedReciprocalExponentsOf5[] = {
 	858,
 };
 
+//! The reciprocals of the powers of five from 5^0 to 5^341 for jsop_double_to_decimal() (as the high and low parts), which are scaled
+//! to 125 significant bits and rounded up
+static const uint64_t JsopReciprocalsOfFive125[] = {
+	UINT64_C(0x2000000000000000), UINT64_C(0x0000000000000001),	//5e-0
+	UINT64_C(0x1999999999999999), UINT64_C(0x999999999999999a),	//5e-1
+	UINT64_C(0x147ae147ae147ae1), UINT64_C(0x47ae147ae147ae15),	//5e-2
+	UINT64_C(0x10624dd2f1a9fbe7), UINT64_C(0x6c8b4395810624de),	//5e-3
+	UINT64_C(0x1a36e2eb1c432ca5), UINT64_C(0x7a786c226809d496),	//5e-4
+	UINT64_C(0x14f8b588e368f084), UINT64_C(0x61f9f01b866e43ab),	//5e-5
+	UINT64_C(0x10c6f7a0b5ed8d36), UINT64_C(0xb4c7f34938583622),	//5e-6
+	UINT64_C(0x1ad7f29abcaf4857), UINT64_C(0x87a6520ec08d236a),	//5e-7
+	UINT64_C(0x15798ee2308c39df), UINT64_C(0x9fb841a566d74f88),	//5e-8
+	UINT64_C(0x112e0be826d694b2), UINT64_C(0xe62d01511f12a607),	//5e-9
+	UINT64_C(0x1b7cdfd9d7bdbab7), UINT64_C(0xd6ae6881cb5109a4),	//5e-10
+	UINT64_C(0x15fd7fe17964955f), UINT64_C(0xdef1ed34a2a73aea),	//5e-11
+	UINT64_C(0x119799812dea1119), UINT64_C(0x7f27f0f6e885c8bb),	//5e-12
+	UINT64_C(0x1c25c268497681c2), UINT64_C(0x650cb4be40d60df8),	//5e-13
+	UINT64_C(0x16849b86a12b9b01), UINT64_C(0xea70909833de7193),	//5e-14
+	UINT64_C(0x1203af9ee756159b), UINT64_C(0x21f3a6e0297ec143),	//5e-15
+	UINT64_C(0x1cd2b297d889bc2b), UINT64_C(0x6985d7cd0f313537),	//5e-16
+	UINT64_C(0x170ef54646d49689), UINT64_C(0x2137dfd73f5a90f9),	//5e-17
+	UINT64_C(0x12725dd1d243aba0), UINT64_C(0xe75fe645cc4873fa),	//5e-18
+	UINT64_C(0x1d83c94fb6d2ac34), UINT64_C(0xa5663d3c7a0d865d),	//5e-19
+	UINT64_C(0x179ca10c9242235d), UINT64_C(0x511e976394d79eb1),	//5e-20
+	UINT64_C(0x12e3b40a0e9b4f7d), UINT64_C(0xda7edf82dd794bc1),	//5e-21
+	UINT64_C(0x1e392010175ee596), UINT64_C(0x2a6498d1625bac68),	//5e-22
+	UINT64_C(0x182db34012b25144), UINT64_C(0xeeb6e0a781e2f053),	//5e-23
+	UINT64_C(0x1357c299a88ea76a), UINT64_C(0x58924d52ce4f26a9),	//5e-24
+	UINT64_C(0x1ef2d0f5da7dd8aa), UINT64_C(0x27507bb7b07ea441),	//5e-25
+	UINT64_C(0x18c240c4aecb13bb), UINT64_C(0x52a6c95fc0655034),	//5e-26
+	UINT64_C(0x13ce9a36f23c0fc9), UINT64_C(0x0eebd44c99eaa690),	//5e-27
+	UINT64_C(0x1fb0f6be50601941), UINT64_C(0xb17953adc3110a80),	//5e-28
+	UINT64_C(0x195a5efea6b34767), UINT64_C(0xc12ddc8b02740867),	//5e-29
+	UINT64_C(0x14484bfeebc29f86), UINT64_C(0x3424b06f3529a052),	//5e-30
+	UINT64_C(0x1039d66589687f9e), UINT64_C(0x901d59f290ee19db),	//5e-31
+	UINT64_C(0x19f623d5a8a73297), UINT64_C(0x4cfbc31db4b0295f),	//5e-32
+	UINT64_C(0x14c4e977ba1f5bac), UINT64_C(0x3d9635b15d59bab2),	//5e-33
+	UINT64_C(0x109d8792fb4c4956), UINT64_C(0x97ab5e277de16228),	//5e-34
+	UINT64_C(0x1a95a5b7f87a0ef0), UINT64_C(0xf2abc9d8c9689d0d),	//5e-35
+	UINT64_C(0x154484932d2e725a), UINT64_C(0x5bbca17a3aba173e),	//5e-36
+	UINT64_C(0x11039d428a8b8eae), UINT64_C(0xafca1ac82efb45cb),	//5e-37
+	UINT64_C(0x1b38fb9daa78e44a), UINT64_C(0xb2dcf7a6b1920945),	//5e-38
+	UINT64_C(0x15c72fb1552d836e), UINT64_C(0xf57d92ebc141a104),	//5e-39
+	UINT64_C(0x116c262777579c58), UINT64_C(0xc46475896767b403),	//5e-40
+	UINT64_C(0x1be03d0bf225c6f4), UINT64_C(0x6d6d88dbd8a5ecd2),	//5e-41
+	UINT64_C(0x164cfda3281e38c3), UINT64_C(0x8abe071646eb23db),	//5e-42
+	UINT64_C(0x11d7314f534b609c), UINT64_C(0x6efe6c11d255b649),	//5e-43
+	UINT64_C(0x1c8b821885456760), UINT64_C(0xb197134fb6ef8a0e),	//5e-44
+	UINT64_C(0x16d601ad376ab91a), UINT64_C(0x27ac0f72f8bfa1a5),	//5e-45
+	UINT64_C(0x1244ce242c5560e1), UINT64_C(0xb95672c260994e1e),	//5e-46
+	UINT64_C(0x1d3ae36d13bbce35), UINT64_C(0xf5571e03cdc21695),	//5e-47
+	UINT64_C(0x17624f8a762fd82b), UINT64_C(0x2aac18030b01abab),	//5e-48
+	UINT64_C(0x12b50c6ec4f31355), UINT64_C(0xbbbce0026f348956),	//5e-49
+	UINT64_C(0x1dee7a4ad4b81eef), UINT64_C(0x92c7ccd0b1eda889),	//5e-50
+	UINT64_C(0x17f1fb6f10934bf2), UINT64_C(0xdbd30a408e57ba07),	//5e-51
+	UINT64_C(0x1327fc58da0f6ff5), UINT64_C(0x7ca8d50071dfc806),	//5e-52
+	UINT64_C(0x1ea6608e29b24cbb), UINT64_C(0xfaa7bb33e9660cd6),	//5e-53
+	UINT64_C(0x18851a0b548ea3c9), UINT64_C(0x9552fc298784d711),	//5e-54
+	UINT64_C(0x139dae6f76d88307), UINT64_C(0xaaa8c9bad2d0ac0e),	//5e-55
+	UINT64_C(0x1f62b0b257c0d1a5), UINT64_C(0xdddadc5e1e1aace3),	//5e-56
+	UINT64_C(0x191bc08eac9a4151), UINT64_C(0x7e48b04b4b488a4f),	//5e-57
+	UINT64_C(0x141633a556e1cdda), UINT64_C(0xcb6d59d5d5d3a1d9),	//5e-58
+	UINT64_C(0x1011c2eaabe7d7e2), UINT64_C(0x3c577b1177dc817b),	//5e-59
+	UINT64_C(0x19b604aaaca62636), UINT64_C(0xc6f25e825960cf2a),	//5e-60
+	UINT64_C(0x14919d5556eb51c5), UINT64_C(0x6bf518684780a5bb),	//5e-61
+	UINT64_C(0x10747ddddf22a7d1), UINT64_C(0x232a79ed06008496),	//5e-62
+	UINT64_C(0x1a53fc9631d10c81), UINT64_C(0xd1dd8fe1a3340756),	//5e-63
+	UINT64_C(0x150ffd44f4a73d34), UINT64_C(0xa7e4731ae8f66c45),	//5e-64
+	UINT64_C(0x10d9976a5d52975d), UINT64_C(0x531d28e253f8569e),	//5e-65
+	UINT64_C(0x1af5bf109550f22e), UINT64_C(0xeb61db03b98d5762),	//5e-66
+	UINT64_C(0x159165a6ddda5b58), UINT64_C(0xbc4e48cfc7a445e8),	//5e-67
+	UINT64_C(0x11411e1f17e1e2ad), UINT64_C(0x6371d3d96c836b20),	//5e-68
+	UINT64_C(0x1b9b6364f3030448), UINT64_C(0x9f1c8628ad9f11cd),	//5e-69
+	UINT64_C(0x1615e91d8f359d06), UINT64_C(0xe5b06b53be18db0b),	//5e-70
+	UINT64_C(0x11ab20e472914a6b), UINT64_C(0xeaf3890fcb4715a2),	//5e-71
+	UINT64_C(0x1c45016d841baa46), UINT64_C(0x44b8db4c7871bc37),	//5e-72
+	UINT64_C(0x169d9abe03495505), UINT64_C(0x03c715d6c6c1635f),	//5e-73
+	UINT64_C(0x1217aefe69077737), UINT64_C(0x3638de456bcde919),	//5e-74
+	UINT64_C(0x1cf2b1970e725858), UINT64_C(0x56c163a2461641c1),	//5e-75
+	UINT64_C(0x17288e1271f51379), UINT64_C(0xdf011c81d1ab67ce),	//5e-76
+	UINT64_C(0x1286d80ec190dc61), UINT64_C(0x7f3416ce4155eca5),	//5e-77
+	UINT64_C(0x1da48ce468e7c702), UINT64_C(0x6520247d3556476e),	//5e-78
+	UINT64_C(0x17b6d71d20b96c01), UINT64_C(0xea801d30f7783925),	//5e-79
+	UINT64_C(0x12f8ac174d612334), UINT64_C(0xbb99b0f3f92cfa84),	//5e-80
+	UINT64_C(0x1e5aacf215683854), UINT64_C(0x5f5c4e532847f739),	//5e-81
+	UINT64_C(0x18488a5b44536043), UINT64_C(0x7f7d0b75b9d32c2e),	//5e-82
+	UINT64_C(0x136d3b7c36a919cf), UINT64_C(0x9930d5f7c7dc2358),	//5e-83
+	UINT64_C(0x1f152bf9f10e8fb2), UINT64_C(0x8eb4898c72f9d226),	//5e-84
+	UINT64_C(0x18ddbcc7f40ba628), UINT64_C(0x722a07a38f2e41b8),	//5e-85
+	UINT64_C(0x13e497065cd61e86), UINT64_C(0xc1bb394fa5be9afa),	//5e-86
+	UINT64_C(0x1fd424d6faf030d7), UINT64_C(0x9c5ec2190930f7f6),	//5e-87
+	UINT64_C(0x197683df2f268d79), UINT64_C(0x49e56814075a5ff8),	//5e-88
+	UINT64_C(0x145ecfe5bf520ac7), UINT64_C(0x6e51201005e1e660),	//5e-89
+	UINT64_C(0x104bd984990e6f05), UINT64_C(0xf1da800cd181851a),	//5e-90
+	UINT64_C(0x1a12f5a0f4e3e4d6), UINT64_C(0x4fc400148268d4f5),	//5e-91
+	UINT64_C(0x14dbf7b3f71cb711), UINT64_C(0xd96999aa01ed772b),	//5e-92
+	UINT64_C(0x10aff95cc5b09274), UINT64_C(0xadee1488018ac5bc),	//5e-93
+	UINT64_C(0x1ab328946f80ea54), UINT64_C(0x497ceda668de092c),	//5e-94
+	UINT64_C(0x155c2076bf9a5510), UINT64_C(0x3aca57b853e4d424),	//5e-95
+	UINT64_C(0x1116805effaeaa73), UINT64_C(0x623b7960431d7683),	//5e-96
+	UINT64_C(0x1b5733cb32b110b8), UINT64_C(0x9d2bf566d1c8bd9e),	//5e-97
+	UINT64_C(0x15df5ca28ef40d60), UINT64_C(0x7dbcc452416d647f),	//5e-98
+	UINT64_C(0x117f7d4ed8c33de6), UINT64_C(0xcafd69db678ab6cc),	//5e-99
+	UINT64_C(0x1bff2ee48e052fd7), UINT64_C(0xab2f0fc572778adf),	//5e-100
+	UINT64_C(0x1665bf1d3e6a8cac), UINT64_C(0x88f273045b92d580),	//5e-101
+	UINT64_C(0x11eaff4a98553d56), UINT64_C(0xd3f528d049424466),	//5e-102
+	UINT64_C(0x1cab3210f3bb9557), UINT64_C(0xb988414d4203a0a3),	//5e-103
+	UINT64_C(0x16ef5b40c2fc7779), UINT64_C(0x6139cdd76802e6e9),	//5e-104
+	UINT64_C(0x125915cd68c9f92d), UINT64_C(0xe761717920025254),	//5e-105
+	UINT64_C(0x1d5b561574765b7c), UINT64_C(0xa568b58e999d5086),	//5e-106
+	UINT64_C(0x177c44ddf6c515fd), UINT64_C(0x5120913ee14aa6d2),	//5e-107
+	UINT64_C(0x12c9d0b1923744ca), UINT64_C(0xa74d40ff1aa21f0e),	//5e-108
+	UINT64_C(0x1e0fb44f50586e11), UINT64_C(0x0baece64f769cb4a),	//5e-109
+	UINT64_C(0x180c903f7379f1a7), UINT64_C(0x3c8bd850c5ee3c3b),	//5e-110
+	UINT64_C(0x133d4032c2c7f485), UINT64_C(0xca0979da37f1c9c9),	//5e-111
+	UINT64_C(0x1ec866b79e0cba6f), UINT64_C(0xa9a8c2f6bfe942db),	//5e-112
+	UINT64_C(0x18a0522c7e709526), UINT64_C(0x2153cf2bccba9be3),	//5e-113
+	UINT64_C(0x13b374f06526ddb8), UINT64_C(0x1aa9728970954982),	//5e-114
+	UINT64_C(0x1f8587e7083e2f8c), UINT64_C(0xf775840f1a88759d),	//5e-115
+	UINT64_C(0x19379fec0698260a), UINT64_C(0x5f9136727ba05e17),	//5e-116
+	UINT64_C(0x142c7ff0054684d5), UINT64_C(0x1940f85b9619e4df),	//5e-117
+	UINT64_C(0x1023998cd1053710), UINT64_C(0xe100c6afab47ea4c),	//5e-118
+	UINT64_C(0x19d28f47b4d524e7), UINT64_C(0xce67a44c453fdd47),	//5e-119
+	UINT64_C(0x14a8729fc3ddb71f), UINT64_C(0xd852e9d69dccb106),	//5e-120
+	UINT64_C(0x1086c219697e2c19), UINT64_C(0x79dbee454b0a2738),	//5e-121
+	UINT64_C(0x1a71368f0f30468f), UINT64_C(0x295fe3a211a9d859),	//5e-122
+	UINT64_C(0x15275ed8d8f36ba5), UINT64_C(0xbab31c81a7bb137a),	//5e-123
+	UINT64_C(0x10ec4be0ad8f8951), UINT64_C(0x6228e39aec95a92f),	//5e-124
+	UINT64_C(0x1b13ac9aaf4c0ee8), UINT64_C(0x9d0e38f7e0ef7517),	//5e-125
+	UINT64_C(0x15a956e225d67253), UINT64_C(0xb0d82d931a592a79),	//5e-126
+	UINT64_C(0x11544581b7dec1dc), UINT64_C(0x8d79be0f4847552e),	//5e-127
+	UINT64_C(0x1bba08cf8c979c94), UINT64_C(0x158f967eda0bbb7c),	//5e-128
+	UINT64_C(0x162e6d72d6dfb076), UINT64_C(0x77a611ff14d62f97),	//5e-129
+	UINT64_C(0x11bebdf578b2f391), UINT64_C(0xf951a7ff43de8c79),	//5e-130
+	UINT64_C(0x1c6463225ab7ec1c), UINT64_C(0xc21c3ffed2fdad8e),	//5e-131
+	UINT64_C(0x16b6b5b5155ff017), UINT64_C(0x01b0333242648ad8),	//5e-132
+	UINT64_C(0x122bc490dde659ac), UINT64_C(0x0159c28e9b83a246),	//5e-133
+	UINT64_C(0x1d12d41afca3c2ac), UINT64_C(0xcef604175f3903a3),	//5e-134
+	UINT64_C(0x17424348ca1c9bbd), UINT64_C(0x725e69ac4c2d9c83),	//5e-135
+	UINT64_C(0x129b69070816e2fd), UINT64_C(0xf5185489d68ae39c),	//5e-136
+	UINT64_C(0x1dc574d80cf16b2f), UINT64_C(0xee8d540fbdab05c6),	//5e-137
+	UINT64_C(0x17d12a4670c1228c), UINT64_C(0xbed77672fe226b05),	//5e-138
+	UINT64_C(0x130dbb6b8d674ed6), UINT64_C(0xff12c528cb4ebc04),	//5e-139
+	UINT64_C(0x1e7c5f127bd87e24), UINT64_C(0xcb513b74787df9a0),	//5e-140
+	UINT64_C(0x18637f41fcad31b7), UINT64_C(0x090dc929f9fe614d),	//5e-141
+	UINT64_C(0x1382cc34ca2427c5), UINT64_C(0xa0d7d42194cb810a),	//5e-142
+	UINT64_C(0x1f37ad21436d0c6f), UINT64_C(0x67bfb9cf5478ce77),	//5e-143
+	UINT64_C(0x18f9574dcf8a7059), UINT64_C(0x1fcc94a5dd2d71f9),	//5e-144
+	UINT64_C(0x13faac3e3fa1f37a), UINT64_C(0x7fd6dd517dbdf4c7),	//5e-145
+	UINT64_C(0x1ff779fd329cb8c3), UINT64_C(0xffbe2ee8c92fee0b),	//5e-146
+	UINT64_C(0x1992c7fdc216fa36), UINT64_C(0x6631bf20a0f324d6),	//5e-147
+	UINT64_C(0x14756ccb01abfb5e), UINT64_C(0xb827cc1a1a5c1d78),	//5e-148
+	UINT64_C(0x105df0a267bcc918), UINT64_C(0x935309ae7b7ce460),	//5e-149
+	UINT64_C(0x1a2fe76a3f9474f4), UINT64_C(0x1eeb42b0c594a099),	//5e-150
+	UINT64_C(0x14f31f8832dd2a5c), UINT64_C(0xe58902270476e6e1),	//5e-151
+	UINT64_C(0x10c27fa028b0eeb0), UINT64_C(0xb7a0ce859d2bebe7),	//5e-152
+	UINT64_C(0x1ad0cc33744e4ab4), UINT64_C(0x59014a6f61dfdfd8),	//5e-153
+	UINT64_C(0x1573d68f903ea229), UINT64_C(0xe0cdd525e7e64cad),	//5e-154
+	UINT64_C(0x11297872d9cbb4ee), UINT64_C(0x4d7177518651d6f1),	//5e-155
+	UINT64_C(0x1b758d848fac54b0), UINT64_C(0x7be8bee8d6e957e8),	//5e-156
+	UINT64_C(0x15f7a46a0c89dd59), UINT64_C(0xfcba3253df211320),	//5e-157
+	UINT64_C(0x1192e9ee706e4aae), UINT64_C(0x63c8284318e74280),	//5e-158
+	UINT64_C(0x1c1e43171a4a1117), UINT64_C(0x060d0d3827d86a66),	//5e-159
+	UINT64_C(0x167e9c127b6e7412), UINT64_C(0x6b3da42cecad21eb),	//5e-160
+	UINT64_C(0x11fee341fc585cdb), UINT64_C(0x88fe1cf0bd574e56),	//5e-161
+	UINT64_C(0x1ccb0536608d615f), UINT64_C(0x419694b462254a23),	//5e-162
+	UINT64_C(0x1708d0f84d3de77f), UINT64_C(0x67abaa29e81dd4e9),	//5e-163
+	UINT64_C(0x126d73f9d764b932), UINT64_C(0xb95621bb2017dd87),	//5e-164
+	UINT64_C(0x1d7becc2f23ac1ea), UINT64_C(0xc223692b668c95a5),	//5e-165
+	UINT64_C(0x179657025b6234bb), UINT64_C(0xce82ba891ed6de1d),	//5e-166
+	UINT64_C(0x12deac01e2b4f6fc), UINT64_C(0xa53562074bdf1818),	//5e-167
+	UINT64_C(0x1e3113363787f194), UINT64_C(0x3b889cd87964f359),	//5e-168
+	UINT64_C(0x18274291c6065adc), UINT64_C(0xfc6d4a46c783f5e1),	//5e-169
+	UINT64_C(0x13529ba7d19eaf17), UINT64_C(0x30576e9f06032b1a),	//5e-170
+	UINT64_C(0x1eea92a61c311825), UINT64_C(0x1a257dcb3cd1de90),	//5e-171
+	UINT64_C(0x18bba884e35a79b7), UINT64_C(0x481dfe3c30a7e540),	//5e-172
+	UINT64_C(0x13c9539d82aec7c5), UINT64_C(0xd34b31c9c0865100),	//5e-173
+	UINT64_C(0x1fa885c8d117a609), UINT64_C(0x5211e942cda3b4cd),	//5e-174
+	UINT64_C(0x19539e3a40dfb807), UINT64_C(0x74db21023e1c90a4),	//5e-175
+	UINT64_C(0x1442e4fb67196005), UINT64_C(0xf715b401cb4a0d50),	//5e-176
+	UINT64_C(0x103583fc527ab337), UINT64_C(0xf8de299b09080aa7),	//5e-177
+	UINT64_C(0x19ef3993b72ab859), UINT64_C(0x8e304291a80cddd7),	//5e-178
+	UINT64_C(0x14bf6142f8eef9e1), UINT64_C(0x3e8d020e200a4b13),	//5e-179
+	UINT64_C(0x10991a9bfa58c7e7), UINT64_C(0x653d9b3e80083c0f),	//5e-180
+	UINT64_C(0x1a8e90f9908e0ca5), UINT64_C(0x6ec8f864000d2ce4),	//5e-181
+	UINT64_C(0x153eda614071a3b7), UINT64_C(0x8bd3f9e999a423ea),	//5e-182
+	UINT64_C(0x10ff151a99f482f9), UINT64_C(0x3ca994bae1501cbb),	//5e-183
+	UINT64_C(0x1b31bb5dc320d18e), UINT64_C(0xc775bac49bb3612b),	//5e-184
+	UINT64_C(0x15c162b168e70e0b), UINT64_C(0xd2c4956a16291a89),	//5e-185
+	UINT64_C(0x11678227871f3e6f), UINT64_C(0xdbd0778811ba7ba1),	//5e-186
+	UINT64_C(0x1bd8d03f3e9863e6), UINT64_C(0x2c80bf401c5d929b),	//5e-187
+	UINT64_C(0x16470cff6546b651), UINT64_C(0xbd33cc3349e47549),	//5e-188
+	UINT64_C(0x11d270cc51055ea7), UINT64_C(0xca8fd68f6e505dd4),	//5e-189
+	UINT64_C(0x1c83e7ad4e6efdd9), UINT64_C(0x4419574be3b3c953),	//5e-190
+	UINT64_C(0x16cfec8aa52597e1), UINT64_C(0x0347790982f63aa9),	//5e-191
+	UINT64_C(0x123ff06eea847980), UINT64_C(0xcf6c60d468c4fbba),	//5e-192
+	UINT64_C(0x1d331a4b10d3f59a), UINT64_C(0xe57a34870e07f92a),	//5e-193
+	UINT64_C(0x175c1508da432ae2), UINT64_C(0x512e906c0b399422),	//5e-194
+	UINT64_C(0x12b010d3e1cf5581), UINT64_C(0xda8ba6bcd5c7a9b5),	//5e-195
+	UINT64_C(0x1de6815302e5559c), UINT64_C(0x90df712e22d90f87),	//5e-196
+	UINT64_C(0x17eb9aa8cf1dde16), UINT64_C(0xda4c5a8b4f140c6c),	//5e-197
+	UINT64_C(0x1322e220a5b17e78), UINT64_C(0xaea37ba2a5a9a38a),	//5e-198
+	UINT64_C(0x1e9e369aa2b59727), UINT64_C(0x7dd25f6aa2a905a9),	//5e-199
+	UINT64_C(0x187e92154ef7ac1f), UINT64_C(0x97db7f888220d154),	//5e-200
+	UINT64_C(0x139874ddd8c6234c), UINT64_C(0x797c6606ce80a777),	//5e-201
+	UINT64_C(0x1f5a549627a36bad), UINT64_C(0x8f2d700ae4010bf1),	//5e-202
+	UINT64_C(0x191510781fb5efbe), UINT64_C(0x0c2459a25000d65a),	//5e-203
+	UINT64_C(0x1410d9f9b2f7f2fe), UINT64_C(0x701d1481d99a4515),	//5e-204
+	UINT64_C(0x100d7b2e28c65bfe), UINT64_C(0xc017439b147b6a77),	//5e-205
+	UINT64_C(0x19af2b7d0e0a2cca), UINT64_C(0xccf205c4ed9243f2),	//5e-206
+	UINT64_C(0x148c22ca71a1bd6f), UINT64_C(0x0a5b37d0be0e9cc2),	//5e-207
+	UINT64_C(0x10701bd527b4978c), UINT64_C(0x0848f973cb3ee3ce),	//5e-208
+	UINT64_C(0x1a4cf9550c5425ac), UINT64_C(0xda0e5bec78649fb0),	//5e-209
+	UINT64_C(0x150a6110d6a9b7bd), UINT64_C(0x7b3eaff060507fc0),	//5e-210
+	UINT64_C(0x10d51a73deee2c97), UINT64_C(0x95cbbff380406633),	//5e-211
+	UINT64_C(0x1aee90b964b04758), UINT64_C(0xefac665266cd7052),	//5e-212
+	UINT64_C(0x158ba6fab6f36c47), UINT64_C(0x2623850eb8a459db),	//5e-213
+	UINT64_C(0x113c85955f29236c), UINT64_C(0x1e82d0d893b6ae49),	//5e-214
+	UINT64_C(0x1b9408eefea838ac), UINT64_C(0xfd9e1af41f8ab075),	//5e-215
+	UINT64_C(0x16100725988693bd), UINT64_C(0x97b1af29b2d559f7),	//5e-216
+	UINT64_C(0x11a66c1e139edc97), UINT64_C(0xac8e25baf5777b2c),	//5e-217
+	UINT64_C(0x1c3d79c9b8fe2dbf), UINT64_C(0x7a7d092b2258c513),	//5e-218
+	UINT64_C(0x169794a160cb57cc), UINT64_C(0x61fda0ef4ead6a76),	//5e-219
+	UINT64_C(0x1212dd4de7091309), UINT64_C(0xe7fe1a590bbdeec5),	//5e-220
+	UINT64_C(0x1ceafbafd80e84dc), UINT64_C(0xa6635d5b45fcb13a),	//5e-221
+	UINT64_C(0x172262f3133ed0b0), UINT64_C(0x851c4aaf6b308dc8),	//5e-222
+	UINT64_C(0x1281e8c275cbda26), UINT64_C(0xd0e36ef2bc26d7d4),	//5e-223
+	UINT64_C(0x1d9ca79d894629d7), UINT64_C(0xb49f17eac6a48c86),	//5e-224
+	UINT64_C(0x17b08617a104ee46), UINT64_C(0x2a18dfef0550706b),	//5e-225
+	UINT64_C(0x12f39e794d9d8b6b), UINT64_C(0x54e0b3259dd9f389),	//5e-226
+	UINT64_C(0x1e5297287c2f4578), UINT64_C(0x87cdeb6f62f65274),	//5e-227
+	UINT64_C(0x18421286c9bf6ac6), UINT64_C(0xd30b22bf825ea85d),	//5e-228
+	UINT64_C(0x13680ed23aff889f), UINT64_C(0x0f3c1bcc684bb9e4),	//5e-229
+	UINT64_C(0x1f0ce4839198da98), UINT64_C(0x18602c7a4079296d),	//5e-230
+	UINT64_C(0x18d71d360e13e213), UINT64_C(0x46b356c833942124),	//5e-231
+	UINT64_C(0x13df4a91a4dcb4dc), UINT64_C(0x388f78a029434db6),	//5e-232
+	UINT64_C(0x1fcbaa82a1612160), UINT64_C(0x5a7f2766a86baf8a),	//5e-233
+	UINT64_C(0x196fbb9bb44db44d), UINT64_C(0x153285ebb9efbfa2),	//5e-234
+	UINT64_C(0x145962e2f6a4903d), UINT64_C(0xaa8ed189618c994e),	//5e-235
+	UINT64_C(0x1047824f2bb6d9ca), UINT64_C(0xeed8a7a11ad6e10c),	//5e-236
+	UINT64_C(0x1a0c03b1df8af611), UINT64_C(0x7e27729b5e249b45),	//5e-237
+	UINT64_C(0x14d6695b193bf80d), UINT64_C(0xfe85f549181d4904),	//5e-238
+	UINT64_C(0x10ab877c142ff9a4), UINT64_C(0xcb9e5dd4134aa0d0),	//5e-239
+	UINT64_C(0x1aac0bf9b9e65c3a), UINT64_C(0xdf63c9535211014d),	//5e-240
+	UINT64_C(0x15566ffafb1eb02f), UINT64_C(0x191ca10f74da6771),	//5e-241
+	UINT64_C(0x1111f32f2f4bc025), UINT64_C(0xadb080d92a4852c1),	//5e-242
+	UINT64_C(0x1b4feb7eb212cd09), UINT64_C(0x15e7348eaa0d5134),	//5e-243
+	UINT64_C(0x15d98932280f0a6d), UINT64_C(0xab1f5d3eee710dc4),	//5e-244
+	UINT64_C(0x117ad428200c0857), UINT64_C(0xbc1917658b8da49d),	//5e-245
+	UINT64_C(0x1bf7b9d9cce00d59), UINT64_C(0x2cf4f23c127c3a94),	//5e-246
+	UINT64_C(0x165fc7e170b33de0), UINT64_C(0xf0c3f4fcdb969543),	//5e-247
+	UINT64_C(0x11e6398126f5cb1a), UINT64_C(0x5a365d9716121103),	//5e-248
+	UINT64_C(0x1ca38f350b22de90), UINT64_C(0x9056fc24f01ce804),	//5e-249
+	UINT64_C(0x16e93f5da2824ba6), UINT64_C(0xd9df301d8ce3ecd0),	//5e-250
+	UINT64_C(0x125432b14ecea2eb), UINT64_C(0xe17f59b13d8323da),	//5e-251
+	UINT64_C(0x1d53844ee47dd179), UINT64_C(0x68cbc2b52f38395c),	//5e-252
+	UINT64_C(0x177603725064a794), UINT64_C(0x53d6355dbf602de3),	//5e-253
+	UINT64_C(0x12c4cf8ea6b6ec76), UINT64_C(0xa9782ab165e68b1c),	//5e-254
+	UINT64_C(0x1e07b27dd78b13f1), UINT64_C(0x0f26aab56fd744fa),	//5e-255
+	UINT64_C(0x18062864ac6f4327), UINT64_C(0x3f52222abfdf6a62),	//5e-256
+	UINT64_C(0x1338205089f29c1f), UINT64_C(0x65db4e88997f884e),	//5e-257
+	UINT64_C(0x1ec033b40fea9365), UINT64_C(0x6fc54a7428cc0d4a),	//5e-258
+	UINT64_C(0x1899c2f673220f84), UINT64_C(0x596aa1f68709a43b),	//5e-259
+	UINT64_C(0x13ae3591f5b4d936), UINT64_C(0xadeee7f86c07b696),	//5e-260
+	UINT64_C(0x1f7d228322baf524), UINT64_C(0x497e3ff3e00c5756),	//5e-261
+	UINT64_C(0x1930e868e89590e9), UINT64_C(0xd464fff64cd6ac45),	//5e-262
+	UINT64_C(0x14272053ed4473ee), UINT64_C(0x4383fff83d7889d1),	//5e-263
+	UINT64_C(0x101f4d0ff1038ff1), UINT64_C(0xcf9cccc69793a174),	//5e-264
+	UINT64_C(0x19cbae7fe805b31c), UINT64_C(0x7f6147a425b90252),	//5e-265
+	UINT64_C(0x14a2f1ffecd15c16), UINT64_C(0xcc4dd2e9b7c7350f),	//5e-266
+	UINT64_C(0x10825b3323dab012), UINT64_C(0x3d0b0f215fd290d9),	//5e-267
+	UINT64_C(0x1a6a2b85062ab350), UINT64_C(0x61ab4b689950e7c1),	//5e-268
+	UINT64_C(0x1521bc6a6b555c40), UINT64_C(0x4e22a2ba1440b967),	//5e-269
+	UINT64_C(0x10e7c9eebc4449cd), UINT64_C(0x0b4ee894dd009453),	//5e-270
+	UINT64_C(0x1b0c764ac6d3a948), UINT64_C(0x1217da87c800ed51),	//5e-271
+	UINT64_C(0x15a391d56bdc876c), UINT64_C(0xdb46486ca000bdda),	//5e-272
+	UINT64_C(0x114fa7ddefe39f8a), UINT64_C(0x490506bd4ccd64af),	//5e-273
+	UINT64_C(0x1bb2a62fe638ff43), UINT64_C(0xa8080ac87ae23ab1),	//5e-274
+	UINT64_C(0x162884f31e93ff69), UINT64_C(0x5339a239fbe82ef4),	//5e-275
+	UINT64_C(0x11ba03f5b20fff87), UINT64_C(0x75c7b4fb2fecf25d),	//5e-276
+	UINT64_C(0x1c5cd322b67fff3f), UINT64_C(0x22d92191e647ea2e),	//5e-277
+	UINT64_C(0x16b0a8e891ffff65), UINT64_C(0xb57a8141850654f2),	//5e-278
+	UINT64_C(0x1226ed86db3332b7), UINT64_C(0xc4620101373843f5),	//5e-279
+	UINT64_C(0x1d0b15a491eb8459), UINT64_C(0x3a366801f1f39fee),	//5e-280
+	UINT64_C(0x173c115074bc69e0), UINT64_C(0xfb5eb99b27f6198b),	//5e-281
+	UINT64_C(0x129674405d6387e7), UINT64_C(0x2f7efae2865e7ad6),	//5e-282
+	UINT64_C(0x1dbd86cd6238d971), UINT64_C(0xe597f7d0d6fd9156),	//5e-283
+	UINT64_C(0x17cad23de82d7ac1), UINT64_C(0x8479930d78cadaab),	//5e-284
+	UINT64_C(0x1308a831868ac89a), UINT64_C(0xd06142712d6f1556),	//5e-285
+	UINT64_C(0x1e74404f3daada91), UINT64_C(0x4d686a4eaf182222),	//5e-286
+	UINT64_C(0x185d003f6488aeda), UINT64_C(0xa453883ef279b4e8),	//5e-287
+	UINT64_C(0x137d99cc506d58ae), UINT64_C(0xe9dc6cff28615d87),	//5e-288
+	UINT64_C(0x1f2f5c7a1a488de4), UINT64_C(0xa960ae650d6895a4),	//5e-289
+	UINT64_C(0x18f2b061aea07183), UINT64_C(0xbab3beb73ded4483),	//5e-290
+	UINT64_C(0x13f559e7bee6c136), UINT64_C(0x2ef6322c318a9d36),	//5e-291
+	UINT64_C(0x1feef63f97d79b89), UINT64_C(0xe4bd1d13827761f0),	//5e-292
+	UINT64_C(0x198bf832dfdfafa1), UINT64_C(0x83ca7da9352c4e5a),	//5e-293
+	UINT64_C(0x146ff9c24cb2f2e7), UINT64_C(0x9ca1fe20f756a515),	//5e-294
+	UINT64_C(0x1059949b708f28b9), UINT64_C(0x4a1b31b3f9121daa),	//5e-295
+	UINT64_C(0x1a28edc580e50df5), UINT64_C(0x435eb5ecc1b695dd),	//5e-296
+	UINT64_C(0x14ed8b04671da4c4), UINT64_C(0x35e55e57015ede4a),	//5e-297
+	UINT64_C(0x10be08d0527e1d69), UINT64_C(0xc4b77eac0118b1d5),	//5e-298
+	UINT64_C(0x1ac9a7b3b7302f0f), UINT64_C(0xa12597799b5ab622),	//5e-299
+	UINT64_C(0x156e1fc2f8f358d9), UINT64_C(0x4db7ac6149155e81),	//5e-300
+	UINT64_C(0x1124e63593f5e0ad), UINT64_C(0xd7c6238107444b9b),	//5e-301
+	UINT64_C(0x1b6e3d2286563449), UINT64_C(0x593d059b3ed3ac2b),	//5e-302
+	UINT64_C(0x15f1ca820511c36d), UINT64_C(0xe0fd9e15cbdc89bc),	//5e-303
+	UINT64_C(0x118e3b9b37416924), UINT64_C(0xb3fe18116fe3a163),	//5e-304
+	UINT64_C(0x1c16c5c525357507), UINT64_C(0x866359b57fd29bd1),	//5e-305
+	UINT64_C(0x16789e3750f790d2), UINT64_C(0xd1e91491330ee30e),	//5e-306
+	UINT64_C(0x11fa182c40c60d75), UINT64_C(0x74ba76da8f3f1c0b),	//5e-307
+	UINT64_C(0x1cc359e067a348bb), UINT64_C(0xedf72490e531c678),	//5e-308
+	UINT64_C(0x1702ae4d1fb5d3c9), UINT64_C(0x8b2c1d40b75b052d),	//5e-309
+	UINT64_C(0x12688b70e62b0fd4), UINT64_C(0x6f567dcd5f7c0424),	//5e-310
+	UINT64_C(0x1d74124e3d11b2ed), UINT64_C(0x7ef0c94898c66d06),	//5e-311
+	UINT64_C(0x17900ea4fda7c257), UINT64_C(0x98c0a106e09ebd9f),	//5e-312
+	UINT64_C(0x12d9a550caec9b79), UINT64_C(0x470080d24d4bcae6),	//5e-313
+	UINT64_C(0x1e29088144adc58e), UINT64_C(0xd800ce1d487944a2),	//5e-314
+	UINT64_C(0x1820d39a9d57d13f), UINT64_C(0x1333d8176d2dd082),	//5e-315
+	UINT64_C(0x134d76154aaca765), UINT64_C(0xa8f646792424a6ce),	//5e-316
+	UINT64_C(0x1ee25688777aa56f), UINT64_C(0x74bd3d8ea03aa47d),	//5e-317
+	UINT64_C(0x18b51206c5fbb78c), UINT64_C(0x5d64313ee6955064),	//5e-318
+	UINT64_C(0x13c40e6bd1962c70), UINT64_C(0x4ab68dcbebaaa6b7),	//5e-319
+	UINT64_C(0x1fa01712e8f0471a), UINT64_C(0x1124161312aaa457),	//5e-320
+	UINT64_C(0x194cdf4253f36c14), UINT64_C(0xda8344dc0eeee9df),	//5e-321
+	UINT64_C(0x143d7f6843292343), UINT64_C(0xe2029d7cd8bf2180),	//5e-322
+	UINT64_C(0x103132b9cf541c36), UINT64_C(0x4e687dfd7a328133),	//5e-323
+	UINT64_C(0x19e851294bb9c6bd), UINT64_C(0x4a40c9959050ceb8),	//5e-324
+	UINT64_C(0x14b9da876fc7d231), UINT64_C(0x0833d477a6a70bc6),	//5e-325
+	UINT64_C(0x1094aed2bfd30e8d), UINT64_C(0xa02976c61eec096b),	//5e-326
+	UINT64_C(0x1a877e1dffb81749), UINT64_C(0x004257a364acdbdf),	//5e-327
+	UINT64_C(0x153931b1996012a0), UINT64_C(0xcd01dfb5ea23e319),	//5e-328
+	UINT64_C(0x10fa8e27ade6754d), UINT64_C(0x70ce4c91881cb5ae),	//5e-329
+	UINT64_C(0x1b2a7d0c4970bbaf), UINT64_C(0x1ae3adb5a69455e2),	//5e-330
+	UINT64_C(0x15bb973d078d62f2), UINT64_C(0x7be957c4854377e8),	//5e-331
+	UINT64_C(0x1162df64060ab58e), UINT64_C(0xc987796a0435f987),	//5e-332
+	UINT64_C(0x1bd1656cd67788e4), UINT64_C(0x75a58f1006bcc271),	//5e-333
+	UINT64_C(0x16411df0ab92d3e9), UINT64_C(0xf7b7a5a66bca3527),	//5e-334
+	UINT64_C(0x11cdb18d560f0fee), UINT64_C(0x5fc61e1ebca1c41f),	//5e-335
+	UINT64_C(0x1c7c4f4889b1b316), UINT64_C(0xffa363646102d365),	//5e-336
+	UINT64_C(0x16c9d906d48e28df), UINT64_C(0x32e91c504d9bdc51),	//5e-337
+	UINT64_C(0x123b140576d820b2), UINT64_C(0x8f20e37371497d0e),	//5e-338
+	UINT64_C(0x1d2b533bf159cdea), UINT64_C(0x7e9b0585820f2e7c),	//5e-339
+	UINT64_C(0x1755dc2ff447d7ee), UINT64_C(0xcbaf379e01a5beca),	//5e-340
+	UINT64_C(0x12ab168cc36cacbf), UINT64_C(0x0958f94b348498a1),	//5e-341
+};
+
+//! The most significant 125 bits of the powers of five from 5^0 to 5^325 for jsop_double_to_decimal() (as the high and low parts)
+static const uint64_t JsopPowersOfFive125[] = {
+	UINT64_C(0x1000000000000000), UINT64_C(0x0000000000000000),	//5e0
+	UINT64_C(0x1400000000000000), UINT64_C(0x0000000000000000),	//5e1
+	UINT64_C(0x1900000000000000), UINT64_C(0x0000000000000000),	//5e2
+	UINT64_C(0x1f40000000000000), UINT64_C(0x0000000000000000),	//5e3
+	UINT64_C(0x1388000000000000), UINT64_C(0x0000000000000000),	//5e4
+	UINT64_C(0x186a000000000000), UINT64_C(0x0000000000000000),	//5e5
+	UINT64_C(0x1e84800000000000), UINT64_C(0x0000000000000000),	//5e6
+	UINT64_C(0x1312d00000000000), UINT64_C(0x0000000000000000),	//5e7
+	UINT64_C(0x17d7840000000000), UINT64_C(0x0000000000000000),	//5e8
+	UINT64_C(0x1dcd650000000000), UINT64_C(0x0000000000000000),	//5e9
+	UINT64_C(0x12a05f2000000000), UINT64_C(0x0000000000000000),	//5e10
+	UINT64_C(0x174876e800000000), UINT64_C(0x0000000000000000),	//5e11
+	UINT64_C(0x1d1a94a200000000), UINT64_C(0x0000000000000000),	//5e12
+	UINT64_C(0x12309ce540000000), UINT64_C(0x0000000000000000),	//5e13
+	UINT64_C(0x16bcc41e90000000), UINT64_C(0x0000000000000000),	//5e14
+	UINT64_C(0x1c6bf52634000000), UINT64_C(0x0000000000000000),	//5e15
+	UINT64_C(0x11c37937e0800000), UINT64_C(0x0000000000000000),	//5e16
+	UINT64_C(0x16345785d8a00000), UINT64_C(0x0000000000000000),	//5e17
+	UINT64_C(0x1bc16d674ec80000), UINT64_C(0x0000000000000000),	//5e18
+	UINT64_C(0x1158e460913d0000), UINT64_C(0x0000000000000000),	//5e19
+	UINT64_C(0x15af1d78b58c4000), UINT64_C(0x0000000000000000),	//5e20
+	UINT64_C(0x1b1ae4d6e2ef5000), UINT64_C(0x0000000000000000),	//5e21
+	UINT64_C(0x10f0cf064dd59200), UINT64_C(0x0000000000000000),	//5e22
+	UINT64_C(0x152d02c7e14af680), UINT64_C(0x0000000000000000),	//5e23
+	UINT64_C(0x1a784379d99db420), UINT64_C(0x0000000000000000),	//5e24
+	UINT64_C(0x108b2a2c28029094), UINT64_C(0x0000000000000000),	//5e25
+	UINT64_C(0x14adf4b7320334b9), UINT64_C(0x0000000000000000),	//5e26
+	UINT64_C(0x19d971e4fe8401e7), UINT64_C(0x4000000000000000),	//5e27
+	UINT64_C(0x1027e72f1f128130), UINT64_C(0x8800000000000000),	//5e28
+	UINT64_C(0x1431e0fae6d7217c), UINT64_C(0xaa00000000000000),	//5e29
+	UINT64_C(0x193e5939a08ce9db), UINT64_C(0xd480000000000000),	//5e30
+	UINT64_C(0x1f8def8808b02452), UINT64_C(0xc9a0000000000000),	//5e31
+	UINT64_C(0x13b8b5b5056e16b3), UINT64_C(0xbe04000000000000),	//5e32
+	UINT64_C(0x18a6e32246c99c60), UINT64_C(0xad85000000000000),	//5e33
+	UINT64_C(0x1ed09bead87c0378), UINT64_C(0xd8e6400000000000),	//5e34
+	UINT64_C(0x13426172c74d822b), UINT64_C(0x878fe80000000000),	//5e35
+	UINT64_C(0x1812f9cf7920e2b6), UINT64_C(0x6973e20000000000),	//5e36
+	UINT64_C(0x1e17b84357691b64), UINT64_C(0x03d0da8000000000),	//5e37
+	UINT64_C(0x12ced32a16a1b11e), UINT64_C(0x8262889000000000),	//5e38
+	UINT64_C(0x178287f49c4a1d66), UINT64_C(0x22fb2ab400000000),	//5e39
+	UINT64_C(0x1d6329f1c35ca4bf), UINT64_C(0xabb9f56100000000),	//5e40
+	UINT64_C(0x125dfa371a19e6f7), UINT64_C(0xcb54395ca0000000),	//5e41
+	UINT64_C(0x16f578c4e0a060b5), UINT64_C(0xbe2947b3c8000000),	//5e42
+	UINT64_C(0x1cb2d6f618c878e3), UINT64_C(0x2db399a0ba000000),	//5e43
+	UINT64_C(0x11efc659cf7d4b8d), UINT64_C(0xfc90400474400000),	//5e44
+	UINT64_C(0x166bb7f0435c9e71), UINT64_C(0x7bb4500591500000),	//5e45
+	UINT64_C(0x1c06a5ec5433c60d), UINT64_C(0xdaa16406f5a40000),	//5e46
+	UINT64_C(0x118427b3b4a05bc8), UINT64_C(0xa8a4de8459868000),	//5e47
+	UINT64_C(0x15e531a0a1c872ba), UINT64_C(0xd2ce16256fe82000),	//5e48
+	UINT64_C(0x1b5e7e08ca3a8f69), UINT64_C(0x87819baecbe22800),	//5e49
+	UINT64_C(0x111b0ec57e6499a1), UINT64_C(0xf4b1014d3f6d5900),	//5e50
+	UINT64_C(0x1561d276ddfdc00a), UINT64_C(0x71dd41a08f48af40),	//5e51
+	UINT64_C(0x1aba4714957d300d), UINT64_C(0x0e549208b31adb10),	//5e52
+	UINT64_C(0x10b46c6cdd6e3e08), UINT64_C(0x28f4db456ff0c8ea),	//5e53
+	UINT64_C(0x14e1878814c9cd8a), UINT64_C(0x33321216cbecfb24),	//5e54
+	UINT64_C(0x1a19e96a19fc40ec), UINT64_C(0xbffe969c7ee839ed),	//5e55
+	UINT64_C(0x105031e2503da893), UINT64_C(0xf7ff1e21cf512434),	//5e56
+	UINT64_C(0x14643e5ae44d12b8), UINT64_C(0xf5fee5aa43256d41),	//5e57
+	UINT64_C(0x197d4df19d605767), UINT64_C(0x337e9f14d3eec892),	//5e58
+	UINT64_C(0x1fdca16e04b86d41), UINT64_C(0x005e46da08ea7ab6),	//5e59
+	UINT64_C(0x13e9e4e4c2f34448), UINT64_C(0xa03aec4845928cb2),	//5e60
+	UINT64_C(0x18e45e1df3b0155a), UINT64_C(0xc849a75a56f72fde),	//5e61
+	UINT64_C(0x1f1d75a5709c1ab1), UINT64_C(0x7a5c1130ecb4fbd6),	//5e62
+	UINT64_C(0x13726987666190ae), UINT64_C(0xec798abe93f11d65),	//5e63
+	UINT64_C(0x184f03e93ff9f4da), UINT64_C(0xa797ed6e38ed64bf),	//5e64
+	UINT64_C(0x1e62c4e38ff87211), UINT64_C(0x517de8c9c728bdef),	//5e65
+	UINT64_C(0x12fdbb0e39fb474a), UINT64_C(0xd2eeb17e1c7976b5),	//5e66
+	UINT64_C(0x17bd29d1c87a191d), UINT64_C(0x87aa5ddda397d462),	//5e67
+	UINT64_C(0x1dac74463a989f64), UINT64_C(0xe994f5550c7dc97b),	//5e68
+	UINT64_C(0x128bc8abe49f639f), UINT64_C(0x11fd195527ce9ded),	//5e69
+	UINT64_C(0x172ebad6ddc73c86), UINT64_C(0xd67c5faa71c24568),	//5e70
+	UINT64_C(0x1cfa698c95390ba8), UINT64_C(0x8c1b77950e32d6c2),	//5e71
+	UINT64_C(0x121c81f7dd43a749), UINT64_C(0x57912abd28dfc639),	//5e72
+	UINT64_C(0x16a3a275d494911b), UINT64_C(0xad75756c7317b7c8),	//5e73
+	UINT64_C(0x1c4c8b1349b9b562), UINT64_C(0x98d2d2c78fdda5ba),	//5e74
+	UINT64_C(0x11afd6ec0e14115d), UINT64_C(0x9f83c3bcb9ea8794),	//5e75
+	UINT64_C(0x161bcca7119915b5), UINT64_C(0x0764b4abe8652979),	//5e76
+	UINT64_C(0x1ba2bfd0d5ff5b22), UINT64_C(0x493de1d6e27e73d7),	//5e77
+	UINT64_C(0x1145b7e285bf98f5), UINT64_C(0x6dc6ad264d8f0866),	//5e78
+	UINT64_C(0x159725db272f7f32), UINT64_C(0xc938586fe0f2ca80),	//5e79
+	UINT64_C(0x1afcef51f0fb5eff), UINT64_C(0x7b866e8bd92f7d20),	//5e80
+	UINT64_C(0x10de1593369d1b5f), UINT64_C(0xad34051767bdae34),	//5e81
+	UINT64_C(0x15159af804446237), UINT64_C(0x9881065d41ad19c1),	//5e82
+	UINT64_C(0x1a5b01b605557ac5), UINT64_C(0x7ea147f492186032),	//5e83
+	UINT64_C(0x1078e111c3556cbb), UINT64_C(0x6f24ccf8db4f3c1f),	//5e84
+	UINT64_C(0x14971956342ac7ea), UINT64_C(0x4aee003712230b27),	//5e85
+	UINT64_C(0x19bcdfabc13579e4), UINT64_C(0xdda98044d6abcdf0),	//5e86
+	UINT64_C(0x10160bcb58c16c2f), UINT64_C(0x0a89f02b062b60b6),	//5e87
+	UINT64_C(0x141b8ebe2ef1c73a), UINT64_C(0xcd2c6c35c7b638e4),	//5e88
+	UINT64_C(0x1922726dbaae3909), UINT64_C(0x8077874339a3c71d),	//5e89
+	UINT64_C(0x1f6b0f092959c74b), UINT64_C(0xe0956914080cb8e4),	//5e90
+	UINT64_C(0x13a2e965b9d81c8f), UINT64_C(0x6c5d61ac8507f38e),	//5e91
+	UINT64_C(0x188ba3bf284e23b3), UINT64_C(0x4774ba17a649f072),	//5e92
+	UINT64_C(0x1eae8caef261aca0), UINT64_C(0x1951e89d8fdc6c8f),	//5e93
+	UINT64_C(0x132d17ed577d0be4), UINT64_C(0x0fd3316279e9c3d9),	//5e94
+	UINT64_C(0x17f85de8ad5c4edd), UINT64_C(0x13c7fdbb186434cf),	//5e95
+	UINT64_C(0x1df67562d8b36294), UINT64_C(0x58b9fd29de7d4203),	//5e96
+	UINT64_C(0x12ba095dc7701d9c), UINT64_C(0xb7743e3a2b0e4942),	//5e97
+	UINT64_C(0x17688bb5394c2503), UINT64_C(0xe5514dc8b5d1db92),	//5e98
+	UINT64_C(0x1d42aea2879f2e44), UINT64_C(0xdea5a13ae3465277),	//5e99
+	UINT64_C(0x1249ad2594c37ceb), UINT64_C(0x0b2784c4ce0bf38a),	//5e100
+	UINT64_C(0x16dc186ef9f45c25), UINT64_C(0xcdf165f6018ef06d),	//5e101
+	UINT64_C(0x1c931e8ab871732f), UINT64_C(0x416dbf7381f2ac88),	//5e102
+	UINT64_C(0x11dbf316b346e7fd), UINT64_C(0x88e497a83137abd5),	//5e103
+	UINT64_C(0x1652efdc6018a1fc), UINT64_C(0xeb1dbd923d8596ca),	//5e104
+	UINT64_C(0x1be7abd3781eca7c), UINT64_C(0x25e52cf6cce6fc7d),	//5e105
+	UINT64_C(0x1170cb642b133e8d), UINT64_C(0x97af3c1a40105dce),	//5e106
+	UINT64_C(0x15ccfe3d35d80e30), UINT64_C(0xfd9b0b20d0147542),	//5e107
+	UINT64_C(0x1b403dcc834e11bd), UINT64_C(0x3d01cde904199292),	//5e108
+	UINT64_C(0x1108269fd210cb16), UINT64_C(0x462120b1a28ffb9b),	//5e109
+	UINT64_C(0x154a3047c694fddb), UINT64_C(0xd7a968de0b33fa82),	//5e110
+	UINT64_C(0x1a9cbc59b83a3d52), UINT64_C(0xcd93c3158e00f923),	//5e111
+	UINT64_C(0x10a1f5b813246653), UINT64_C(0xc07c59ed78c09bb6),	//5e112
+	UINT64_C(0x14ca732617ed7fe8), UINT64_C(0xb09b7068d6f0c2a3),	//5e113
+	UINT64_C(0x19fd0fef9de8dfe2), UINT64_C(0xdcc24c830cacf34c),	//5e114
+	UINT64_C(0x103e29f5c2b18bed), UINT64_C(0xc9f96fd1e7ec180f),	//5e115
+	UINT64_C(0x144db473335deee9), UINT64_C(0x3c77cbc661e71e13),	//5e116
+	UINT64_C(0x1961219000356aa3), UINT64_C(0x8b95beb7fa60e598),	//5e117
+	UINT64_C(0x1fb969f40042c54c), UINT64_C(0x6e7b2e65f8f91efe),	//5e118
+	UINT64_C(0x13d3e2388029bb4f), UINT64_C(0xc50cfcffbb9bb35f),	//5e119
+	UINT64_C(0x18c8dac6a0342a23), UINT64_C(0xb6503c3faa82a037),	//5e120
+	UINT64_C(0x1efb1178484134ac), UINT64_C(0xa3e44b4f95234844),	//5e121
+	UINT64_C(0x135ceaeb2d28c0eb), UINT64_C(0xe66eaf11bd360d2b),	//5e122
+	UINT64_C(0x183425a5f872f126), UINT64_C(0xe00a5ad62c839075),	//5e123
+	UINT64_C(0x1e412f0f768fad70), UINT64_C(0x980cf18bb7a47493),	//5e124
+	UINT64_C(0x12e8bd69aa19cc66), UINT64_C(0x5f0816f752c6c8dc),	//5e125
+	UINT64_C(0x17a2ecc414a03f7f), UINT64_C(0xf6ca1cb527787b13),	//5e126
+	UINT64_C(0x1d8ba7f519c84f5f), UINT64_C(0xf47ca3e2715699d7),	//5e127
+	UINT64_C(0x127748f9301d319b), UINT64_C(0xf8cde66d86d62026),	//5e128
+	UINT64_C(0x17151b377c247e02), UINT64_C(0xf7016008e88ba830),	//5e129
+	UINT64_C(0x1cda62055b2d9d83), UINT64_C(0xb4c1b80b22ae923c),	//5e130
+	UINT64_C(0x12087d4358fc8272), UINT64_C(0x50f91306f5ad1b65),	//5e131
+	UINT64_C(0x168a9c942f3ba30e), UINT64_C(0xe53757c8b318623f),	//5e132
+	UINT64_C(0x1c2d43b93b0a8bd2), UINT64_C(0x9e852dbadfde7acf),	//5e133
+	UINT64_C(0x119c4a53c4e69763), UINT64_C(0xa3133c94cbeb0cc1),	//5e134
+	UINT64_C(0x16035ce8b6203d3c), UINT64_C(0x8bd80bb9fee5cff1),	//5e135
+	UINT64_C(0x1b843422e3a84c8b), UINT64_C(0xaece0ea87e9f43ee),	//5e136
+	UINT64_C(0x1132a095ce492fd7), UINT64_C(0x4d40c9294f238a75),	//5e137
+	UINT64_C(0x157f48bb41db7bcd), UINT64_C(0x2090fb73a2ec6d12),	//5e138
+	UINT64_C(0x1adf1aea12525ac0), UINT64_C(0x68b53a508ba78856),	//5e139
+	UINT64_C(0x10cb70d24b7378b8), UINT64_C(0x417144725748b536),	//5e140
+	UINT64_C(0x14fe4d06de5056e6), UINT64_C(0x51cd958eed1ae283),	//5e141
+	UINT64_C(0x1a3de04895e46c9f), UINT64_C(0xe640faf2a8619b24),	//5e142
+	UINT64_C(0x1066ac2d5daec3e3), UINT64_C(0xefe89cd7a93d00f7),	//5e143
+	UINT64_C(0x14805738b51a74dc), UINT64_C(0xebe2c40d938c4134),	//5e144
+	UINT64_C(0x19a06d06e2611214), UINT64_C(0x26db7510f86f5181),	//5e145
+	UINT64_C(0x100444244d7cab4c), UINT64_C(0x9849292a9b4592f1),	//5e146
+	UINT64_C(0x1405552d60dbd61f), UINT64_C(0xbe5b73754216f7ad),	//5e147
+	UINT64_C(0x1906aa78b912cba7), UINT64_C(0xadf25052929cb598),	//5e148
+	UINT64_C(0x1f485516e7577e91), UINT64_C(0x996ee4673743e2ff),	//5e149
+	UINT64_C(0x138d352e5096af1a), UINT64_C(0xffe54ec0828a6ddf),	//5e150
+	UINT64_C(0x18708279e4bc5ae1), UINT64_C(0xbfdea270a32d0957),	//5e151
+	UINT64_C(0x1e8ca3185deb719a), UINT64_C(0x2fd64b0ccbf84bad),	//5e152
+	UINT64_C(0x1317e5ef3ab32700), UINT64_C(0x5de5eee7ff7b2f4c),	//5e153
+	UINT64_C(0x17dddf6b095ff0c0), UINT64_C(0x755f6aa1ff59fb1f),	//5e154
+	UINT64_C(0x1dd55745cbb7ecf0), UINT64_C(0x92b7454a7f3079e7),	//5e155
+	UINT64_C(0x12a5568b9f52f416), UINT64_C(0x5bb28b4e8f7e4c30),	//5e156
+	UINT64_C(0x174eac2e8727b11b), UINT64_C(0xf29f2e22335ddf3c),	//5e157
+	UINT64_C(0x1d22573a28f19d62), UINT64_C(0xef46f9aac035570b),	//5e158
+	UINT64_C(0x123576845997025d), UINT64_C(0xd58c5c0ab8215667),	//5e159
+	UINT64_C(0x16c2d4256ffcc2f5), UINT64_C(0x4aef730d6629ac01),	//5e160
+	UINT64_C(0x1c73892ecbfbf3b2), UINT64_C(0x9dab4fd0bfb41701),	//5e161
+	UINT64_C(0x11c835bd3f7d784f), UINT64_C(0xa28b11e277d08e60),	//5e162
+	UINT64_C(0x163a432c8f5cd663), UINT64_C(0x8b2dd65b15c4b1f9),	//5e163
+	UINT64_C(0x1bc8d3f7b3340bfc), UINT64_C(0x6df94bf1db35de77),	//5e164
+	UINT64_C(0x115d847ad000877d), UINT64_C(0xc4bbcf772901ab0a),	//5e165
+	UINT64_C(0x15b4e5998400a95d), UINT64_C(0x35eac354f34215cd),	//5e166
+	UINT64_C(0x1b221effe500d3b4), UINT64_C(0x8365742a30129b40),	//5e167
+	UINT64_C(0x10f5535fef208450), UINT64_C(0xd21f689a5e0ba108),	//5e168
+	UINT64_C(0x1532a837eae8a565), UINT64_C(0x06a742c0f58e894a),	//5e169
+	UINT64_C(0x1a7f5245e5a2cebe), UINT64_C(0x4851137132f22b9d),	//5e170
+	UINT64_C(0x108f936baf85c136), UINT64_C(0xed32ac26bfd75b42),	//5e171
+	UINT64_C(0x14b378469b673184), UINT64_C(0xa87f57306fcd3212),	//5e172
+	UINT64_C(0x19e056584240fde5), UINT64_C(0xd29f2cfc8bc07e97),	//5e173
+	UINT64_C(0x102c35f729689eaf), UINT64_C(0xa3a37c1dd7584f1e),	//5e174
+	UINT64_C(0x14374374f3c2c65b), UINT64_C(0x8c8c5b254d2e62e6),	//5e175
+	UINT64_C(0x1945145230b377f2), UINT64_C(0x6faf71eea079fb9f),	//5e176
+	UINT64_C(0x1f965966bce055ef), UINT64_C(0x0b9b4e6a48987a87),	//5e177
+	UINT64_C(0x13bdf7e0360c35b5), UINT64_C(0x674111026d5f4c94),	//5e178
+	UINT64_C(0x18ad75d8438f4322), UINT64_C(0xc111554308b71fba),	//5e179
+	UINT64_C(0x1ed8d34e547313eb), UINT64_C(0x7155aa93cae4e7a8),	//5e180
+	UINT64_C(0x13478410f4c7ec73), UINT64_C(0x26d58a9c5ecf10c9),	//5e181
+	UINT64_C(0x1819651531f9e78f), UINT64_C(0xf08aed437682d4fb),	//5e182
+	UINT64_C(0x1e1fbe5a7e786173), UINT64_C(0xecada89454238a3a),	//5e183
+	UINT64_C(0x12d3d6f88f0b3ce8), UINT64_C(0x73ec895cb4963664),	//5e184
+	UINT64_C(0x1788ccb6b2ce0c22), UINT64_C(0x90e7abb3e1bbc3fd),	//5e185
+	UINT64_C(0x1d6affe45f818f2b), UINT64_C(0x352196a0da2ab4fd),	//5e186
+	UINT64_C(0x1262dfeebbb0f97b), UINT64_C(0x0134fe24885ab11e),	//5e187
+	UINT64_C(0x16fb97ea6a9d37d9), UINT64_C(0xc1823dadaa715d65),	//5e188
+	UINT64_C(0x1cba7de5054485d0), UINT64_C(0x31e2cd19150db4bf),	//5e189
+	UINT64_C(0x11f48eaf234ad3a2), UINT64_C(0x1f2dc02fad2890f7),	//5e190
+	UINT64_C(0x1671b25aec1d888a), UINT64_C(0xa6f9303b9872b535),	//5e191
+	UINT64_C(0x1c0e1ef1a724eaad), UINT64_C(0x50b77c4a7e8f6282),	//5e192
+	UINT64_C(0x1188d357087712ac), UINT64_C(0x5272adae8f199d91),	//5e193
+	UINT64_C(0x15eb082cca94d757), UINT64_C(0x670f591a32e004f6),	//5e194
+	UINT64_C(0x1b65ca37fd3a0d2d), UINT64_C(0x40d32f60bf980633),	//5e195
+	UINT64_C(0x111f9e62fe44483c), UINT64_C(0x4883fd9c77bf03e0),	//5e196
+	UINT64_C(0x156785fbbdd55a4b), UINT64_C(0x5aa4fd0395aec4d8),	//5e197
+	UINT64_C(0x1ac1677aad4ab0de), UINT64_C(0x314e3c447b1a760e),	//5e198
+	UINT64_C(0x10b8e0acac4eae8a), UINT64_C(0xded0e5aaccf089c9),	//5e199
+	UINT64_C(0x14e718d7d7625a2d), UINT64_C(0x96851f15802cac3b),	//5e200
+	UINT64_C(0x1a20df0dcd3af0b8), UINT64_C(0xfc2666dae037d74a),	//5e201
+	UINT64_C(0x10548b68a044d673), UINT64_C(0x9d980048cc22e68e),	//5e202
+	UINT64_C(0x1469ae42c8560c10), UINT64_C(0x84fe005aff2ba032),	//5e203
+	UINT64_C(0x198419d37a6b8f14), UINT64_C(0xa63d8071bef6883e),	//5e204
+	UINT64_C(0x1fe52048590672d9), UINT64_C(0xcfcce08e2eb42a4e),	//5e205
+	UINT64_C(0x13ef342d37a407c8), UINT64_C(0x21e00c58dd309a70),	//5e206
+	UINT64_C(0x18eb0138858d09ba), UINT64_C(0x2a580f6f147cc10d),	//5e207
+	UINT64_C(0x1f25c186a6f04c28), UINT64_C(0xb4ee134ad99bf150),	//5e208
+	UINT64_C(0x137798f428562f99), UINT64_C(0x7114cc0ec80176d2),	//5e209
+	UINT64_C(0x18557f31326bbb7f), UINT64_C(0xcd59ff127a01d486),	//5e210
+	UINT64_C(0x1e6adefd7f06aa5f), UINT64_C(0xc0b07ed7188249a8),	//5e211
+	UINT64_C(0x1302cb5e6f642a7b), UINT64_C(0xd86e4f466f516e09),	//5e212
+	UINT64_C(0x17c37e360b3d351a), UINT64_C(0xce89e3180b25c98b),	//5e213
+	UINT64_C(0x1db45dc38e0c8261), UINT64_C(0x822c5bde0def3bee),	//5e214
+	UINT64_C(0x1290ba9a38c7d17c), UINT64_C(0xf15bb96ac8b58575),	//5e215
+	UINT64_C(0x1734e940c6f9c5dc), UINT64_C(0x2db2a7c57ae2e6d2),	//5e216
+	UINT64_C(0x1d022390f8b83753), UINT64_C(0x391f51b6d99ba086),	//5e217
+	UINT64_C(0x1221563a9b732294), UINT64_C(0x03b3931248014454),	//5e218
+	UINT64_C(0x16a9abc9424feb39), UINT64_C(0x04a077d6da019569),	//5e219
+	UINT64_C(0x1c5416bb92e3e607), UINT64_C(0x45c895cc9081fac3),	//5e220
+	UINT64_C(0x11b48e353bce6fc4), UINT64_C(0x8b9d5d9fda513cba),	//5e221
+	UINT64_C(0x1621b1c28ac20bb5), UINT64_C(0xae84b507d0e58be8),	//5e222
+	UINT64_C(0x1baa1e332d728ea3), UINT64_C(0x1a25e249c51eeee3),	//5e223
+	UINT64_C(0x114a52dffc679925), UINT64_C(0xf057ad6e1b33554d),	//5e224
+	UINT64_C(0x159ce797fb817f6f), UINT64_C(0x6c6d98c9a2002aa1),	//5e225
+	UINT64_C(0x1b04217dfa61df4b), UINT64_C(0x4788fefc0a803549),	//5e226
+	UINT64_C(0x10e294eebc7d2b8f), UINT64_C(0x0cb59f5d8690214e),	//5e227
+	UINT64_C(0x151b3a2a6b9c7672), UINT64_C(0xcfe30734e83429a1),	//5e228
+	UINT64_C(0x1a6208b50683940f), UINT64_C(0x83dbc9022241340a),	//5e229
+	UINT64_C(0x107d457124123c89), UINT64_C(0xb2695da15568c086),	//5e230
+	UINT64_C(0x149c96cd6d16cbac), UINT64_C(0x1f03b509aac2f0a7),	//5e231
+	UINT64_C(0x19c3bc80c85c7e97), UINT64_C(0x26c4a24c1573acd1),	//5e232
+	UINT64_C(0x101a55d07d39cf1e), UINT64_C(0x783ae56f8d684c03),	//5e233
+	UINT64_C(0x1420eb449c8842e6), UINT64_C(0x16499ecb70c25f03),	//5e234
+	UINT64_C(0x19292615c3aa539f), UINT64_C(0x9bdc067e4cf2f6c4),	//5e235
+	UINT64_C(0x1f736f9b3494e887), UINT64_C(0x82d3081de02fb476),	//5e236
+	UINT64_C(0x13a825c100dd1154), UINT64_C(0xb1c3e512ac1dd0c9),	//5e237
+	UINT64_C(0x18922f31411455a9), UINT64_C(0xde34de57572544fc),	//5e238
+	UINT64_C(0x1eb6bafd91596b14), UINT64_C(0x55c215ed2cee963b),	//5e239
+	UINT64_C(0x133234de7ad7e2ec), UINT64_C(0xb5994db43c151de5),	//5e240
+	UINT64_C(0x17fec216198ddba7), UINT64_C(0xe2ffa1214b1a655e),	//5e241
+	UINT64_C(0x1dfe729b9ff15291), UINT64_C(0xdbbf89699de0feb6),	//5e242
+	UINT64_C(0x12bf07a143f6d39b), UINT64_C(0x2957b5e202ac9f31),	//5e243
+	UINT64_C(0x176ec98994f48881), UINT64_C(0xf3ada35a8357c6fe),	//5e244
+	UINT64_C(0x1d4a7bebfa31aaa2), UINT64_C(0x70990c31242db8bd),	//5e245
+	UINT64_C(0x124e8d737c5f0aa5), UINT64_C(0x865fa79eb69c9376),	//5e246
+	UINT64_C(0x16e230d05b76cd4e), UINT64_C(0xe7f791866443b854),	//5e247
+	UINT64_C(0x1c9abd04725480a2), UINT64_C(0xa1f575e7fd54a669),	//5e248
+	UINT64_C(0x11e0b622c774d065), UINT64_C(0xa53969b0fe54e801),	//5e249
+	UINT64_C(0x1658e3ab7952047f), UINT64_C(0x0e87c41d3dea2202),	//5e250
+	UINT64_C(0x1bef1c9657a6859e), UINT64_C(0xd229b5248d64aa82),	//5e251
+	UINT64_C(0x117571ddf6c81383), UINT64_C(0x435a1136d85eea91),	//5e252
+	UINT64_C(0x15d2ce55747a1864), UINT64_C(0x143095848e76a536),	//5e253
+	UINT64_C(0x1b4781ead1989e7d), UINT64_C(0x193cbae5b2144e83),	//5e254
+	UINT64_C(0x110cb132c2ff630e), UINT64_C(0x2fc5f4cf8f4cb112),	//5e255
+	UINT64_C(0x154fdd7f73bf3bd1), UINT64_C(0xbbb77203731fdd56),	//5e256
+	UINT64_C(0x1aa3d4df50af0ac6), UINT64_C(0x2aa54e844fe7d4ac),	//5e257
+	UINT64_C(0x10a6650b926d66bb), UINT64_C(0xdaa75112b1f0e4eb),	//5e258
+	UINT64_C(0x14cffe4e7708c06a), UINT64_C(0xd15125575e6d1e26),	//5e259
+	UINT64_C(0x1a03fde214caf085), UINT64_C(0x85a56ead360865b0),	//5e260
+	UINT64_C(0x10427ead4cfed653), UINT64_C(0x7387652c41c53f8e),	//5e261
+	UINT64_C(0x14531e58a03e8be8), UINT64_C(0x50693e7752368f71),	//5e262
+	UINT64_C(0x1967e5eec84e2ee2), UINT64_C(0x64838e1526c4334e),	//5e263
+	UINT64_C(0x1fc1df6a7a61ba9a), UINT64_C(0xfda4719a70754022),	//5e264
+	UINT64_C(0x13d92ba28c7d14a0), UINT64_C(0xde86c70086494815),	//5e265
+	UINT64_C(0x18cf768b2f9c59c9), UINT64_C(0x162878c0a7db9a1a),	//5e266
+	UINT64_C(0x1f03542dfb83703b), UINT64_C(0x5bb296f0d1d280a1),	//5e267
+	UINT64_C(0x1362149cbd322625), UINT64_C(0x194f9e5683239064),	//5e268
+	UINT64_C(0x183a99c3ec7eafae), UINT64_C(0x5fa385ec23ec747e),	//5e269
+	UINT64_C(0x1e494034e79e5b99), UINT64_C(0xf78c67672ce7919d),	//5e270
+	UINT64_C(0x12edc82110c2f940), UINT64_C(0x3ab7c0a07c10bb02),	//5e271
+	UINT64_C(0x17a93a2954f3b790), UINT64_C(0x4965b0c89b14e9c3),	//5e272
+	UINT64_C(0x1d9388b3aa30a574), UINT64_C(0x5bbf1cfac1da2433),	//5e273
+	UINT64_C(0x127c35704a5e6768), UINT64_C(0xb957721cb92856a0),	//5e274
+	UINT64_C(0x171b42cc5cf60142), UINT64_C(0xe7ad4ea3e7726c48),	//5e275
+	UINT64_C(0x1ce2137f74338193), UINT64_C(0xa198a24ce14f075a),	//5e276
+	UINT64_C(0x120d4c2fa8a030fc), UINT64_C(0x44ff65700cd16498),	//5e277
+	UINT64_C(0x16909f3b92c83d3b), UINT64_C(0x563f3ecc1005bdbe),	//5e278
+	UINT64_C(0x1c34c70a777a4c8a), UINT64_C(0x2bcf0e7f14072d2e),	//5e279
+	UINT64_C(0x11a0fc668aac6fd6), UINT64_C(0x5b61690f6c847c3d),	//5e280
+	UINT64_C(0x16093b802d578bcb), UINT64_C(0xf239c35347a59b4c),	//5e281
+	UINT64_C(0x1b8b8a6038ad6ebe), UINT64_C(0xeec83428198f021f),	//5e282
+	UINT64_C(0x1137367c236c6537), UINT64_C(0x553d20990ff96153),	//5e283
+	UINT64_C(0x1585041b2c477e85), UINT64_C(0x2a8c68bf53f7b9a8),	//5e284
+	UINT64_C(0x1ae64521f7595e26), UINT64_C(0x752f82ef28f5a812),	//5e285
+	UINT64_C(0x10cfeb353a97dad8), UINT64_C(0x093db1d57999890b),	//5e286
+	UINT64_C(0x1503e602893dd18e), UINT64_C(0x0b8d1e4ad7ffeb4e),	//5e287
+	UINT64_C(0x1a44df832b8d45f1), UINT64_C(0x8e7065dd8dffe622),	//5e288
+	UINT64_C(0x106b0bb1fb384bb6), UINT64_C(0xf9063faa78bfefd5),	//5e289
+	UINT64_C(0x1485ce9e7a065ea4), UINT64_C(0xb747cf9516efebca),	//5e290
+	UINT64_C(0x19a742461887f64d), UINT64_C(0xe519c37a5cabe6bd),	//5e291
+	UINT64_C(0x1008896bcf54f9f0), UINT64_C(0xaf301a2c79eb7036),	//5e292
+	UINT64_C(0x140aabc6c32a386c), UINT64_C(0xdafc20b798664c43),	//5e293
+	UINT64_C(0x190d56b873f4c688), UINT64_C(0x11bb28e57e7fdf54),	//5e294
+	UINT64_C(0x1f50ac6690f1f82a), UINT64_C(0x1629f31ede1fd72a),	//5e295
+	UINT64_C(0x13926bc01a973b1a), UINT64_C(0x4dda37f34ad3e67a),	//5e296
+	UINT64_C(0x187706b0213d09e0), UINT64_C(0xe150c5f01d88e019),	//5e297
+	UINT64_C(0x1e94c85c298c4c59), UINT64_C(0x19a4f76c24eb181f),	//5e298
+	UINT64_C(0x131cfd3999f7afb7), UINT64_C(0xb0071aa39712ef13),	//5e299
+	UINT64_C(0x17e43c8800759ba5), UINT64_C(0x9c08e14c7cd7aad8),	//5e300
+	UINT64_C(0x1ddd4baa0093028f), UINT64_C(0x030b199f9c0d958e),	//5e301
+	UINT64_C(0x12aa4f4a405be199), UINT64_C(0x61e6f003c1887d79),	//5e302
+	UINT64_C(0x1754e31cd072d9ff), UINT64_C(0xba60ac04b1ea9cd7),	//5e303
+	UINT64_C(0x1d2a1be4048f907f), UINT64_C(0xa8f8d705de65440d),	//5e304
+	UINT64_C(0x123a516e82d9ba4f), UINT64_C(0xc99b8663aaff4a88),	//5e305
+	UINT64_C(0x16c8e5ca239028e3), UINT64_C(0xbc0267fc95bf1d2a),	//5e306
+	UINT64_C(0x1c7b1f3cac74331c), UINT64_C(0xab0301fbbb2ee474),	//5e307
+	UINT64_C(0x11ccf385ebc89ff1), UINT64_C(0xeae1e13d54fd4ec9),	//5e308
+	UINT64_C(0x1640306766bac7ee), UINT64_C(0x659a598caa3ca27b),	//5e309
+	UINT64_C(0x1bd03c81406979e9), UINT64_C(0xff00efefd4cbcb1a),	//5e310
+	UINT64_C(0x116225d0c841ec32), UINT64_C(0x3f6095f5e4ff5ef0),	//5e311
+	UINT64_C(0x15baaf44fa52673e), UINT64_C(0xcf38bb735e3f36ac),	//5e312
+	UINT64_C(0x1b295b1638e7010e), UINT64_C(0x8306ea5035cf0457),	//5e313
+	UINT64_C(0x10f9d8ede39060a9), UINT64_C(0x11e4527221a162b6),	//5e314
+	UINT64_C(0x15384f295c7478d3), UINT64_C(0x565d670eaa09bb64),	//5e315
+	UINT64_C(0x1a8662f3b3919708), UINT64_C(0x2bf4c0d2548c2a3d),	//5e316
+	UINT64_C(0x1093fdd8503afe65), UINT64_C(0x1b78f88374d79a66),	//5e317
+	UINT64_C(0x14b8fd4e6449bdfe), UINT64_C(0x625736a4520d8100),	//5e318
+	UINT64_C(0x19e73ca1fd5c2d7d), UINT64_C(0xfaed044d6690e140),	//5e319
+	UINT64_C(0x103085e53e599c6e), UINT64_C(0xbcd422b0601a8cc8),	//5e320
+	UINT64_C(0x143ca75e8df0038a), UINT64_C(0x6c092b5c78212ffa),	//5e321
+	UINT64_C(0x194bd136316c046d), UINT64_C(0x070b763396297bf8),	//5e322
+	UINT64_C(0x1f9ec583bdc70588), UINT64_C(0x48ce53c07bb3daf6),	//5e323
+	UINT64_C(0x13c33b72569c6375), UINT64_C(0x2d80f4584d5068da),	//5e324
+	UINT64_C(0x18b40a4eec437c52), UINT64_C(0x78e1316e60a48310),	//5e325
+};
+
 //! Gets the size of the given array
 template <typename T, size_t N>
 JSOP_INLINE constexpr size_t jsop_get_array_size(const T (&a)[N]) noexcept {
@@ -2361,6 +3700,63 @@ int jsop_mp_uint_compare(const T *a, const T *a_end, const T *b, const T *b_end)
 	return 0;
 }
 
+//! Multiplies the given multi-precision unsigned integer by b and adds c in place, and returns the new end of the integer
+template <typename T>
+T *jsop_mp_uint_multiply_add_assign_x1(T *a, T *a_end, T b, T c) noexcept {
+	for (auto a_i = a; a_i != a_end; ++a_i) {
+		jsop_uint_multiply_add_1x1(a_i, &c, *a_i, b, c);
+	}
+	if (c != 0) {
+		*a_end = c;
+		++a_end;
+	}
+	return a_end;
+}
+
+//! Shifts the given multi-precision unsigned integer left by n bits in place, and returns the new end of the integer
+template <typename T>
+T *jsop_mp_uint_shift_left_assign(T *a, T *a_end, unsigned n) noexcept {
+	const unsigned uint_bits = sizeof(T) * CHAR_BIT;
+	size_t size, n_uints;
+	T high;
+
+	size = a_end - a;
+	n_uints = n / uint_bits;
+	n %= uint_bits;
+	if (n != 0) {
+		high = a[size - 1] >> (uint_bits - n);
+		for (size_t i = size - 1; i > 0; --i) {
+			a[i + n_uints] = (a[i] << n) | (a[i - 1] >> (uint_bits - n));
+		}
+		a[n_uints] = a[0] << n;
+	} else {
+		high = 0;
+		for (size_t i = size; i > 0; --i) {
+			a[i - 1 + n_uints] = a[i - 1];
+		}
+	}
+	for (size_t i = 0; i < n_uints; ++i) {
+		a[i] = 0;
+	}
+
+	a_end = a + size + n_uints;
+	if (high != 0) {
+		*a_end = high;
+		++a_end;
+	}
+	return a_end;
+}
+
+//! Compares the given multi-precision unsigned integers, which do not need to have the same number of uints
+template <typename T>
+int jsop_mp_uint_compare_any(const T *a, const T *a_end, const T *b, const T *b_end) noexcept {
+	if ((a_end - a) >= (b_end - b)) {
+		return jsop_mp_uint_compare(a, a_end, b, b_end);
+	} else {
+		return -jsop_mp_uint_compare(b, b_end, a, a_end);
+	}
+}
+
 #if JSOP_WORD_SIZE == 64
 //! Rounds a 55 bit mantissa to 53 bits using round to nearest even, and updates the exponent if necessary
 //! The remainder should be computed by oring all bits beyond the mantissa together
@@ -2413,6 +3809,80 @@ JSOP_INLINE double jsop_make_subnormal_double(uint64_t mantissa, int exponent, u
 	}
 }
 
+//! Converts the specified integer significand (which cannot be zero) and exponent (of 10) to a double precision number with the
+//! Eisel-Lemire algorithm, which multiplies the normalized significand by the most significant 128 bits of the power of 5
+//! Returns false if the exponent is out of the range of the table, or the truncated product is too close to the halfway point between
+//! 2 numbers to round it correctly
+static bool jsop_decimal_to_double_eisel_lemire(uint64_t significand, int exponent, bool negative, double *value) noexcept {
+	union {
+		uint64_t u;
+		double d;
+	} ud;
+	uint64_t low, high, second_low, second_high, mantissa;
+	int leading_zeros, upper_bit, final_exponent;
+
+	assert(significand != 0);
+	if (exponent < JSOP_MIN_EXPONENT_OF_FIVE_128 || exponent > JSOP_MAX_EXPONENT_OF_FIVE) {
+		return false;
+	}
+
+	leading_zeros = 64 - jsop_uint_count_significant_bits(significand);
+	significand <<= leading_zeros;
+	auto power_of_five = JsopPowersOfFive128 + (exponent - JSOP_MIN_EXPONENT_OF_FIVE_128) * 2;
+	jsop_uint_multiply_1x1(&low, &high, significand, power_of_five[0]);
+	//Only the bits after the mantissa and the rounding bit can be affected by the low part of the power of 5
+	if ((high & (UINT64_MAX >> (DBL_MANT_DIG + 2))) == (UINT64_MAX >> (DBL_MANT_DIG + 2))) {
+		jsop_uint_multiply_1x1(&second_low, &second_high, significand, power_of_five[1]);
+		low += second_high;
+		if (second_high > low) {
+			++high;
+		}
+	}
+	//The powers of 5 are exact within this range, and otherwise the product may be one less than the exact value in its last bit
+	if (low == UINT64_MAX && (exponent < -27 || exponent > 55)) {
+		return false;
+	}
+
+	//Keep 1 more bit than the mantissa for rounding, and compute the biased exponent from log2(10^exponent)
+	upper_bit = static_cast<int>(high >> 63);
+	mantissa = high >> (upper_bit + 64 - (DBL_MANT_DIG + 2));
+	final_exponent = (((152170 + 65536) * exponent) >> 16) + 63 + upper_bit - leading_zeros + (DBL_MAX_EXP - 1);
+	if (final_exponent <= 0) {
+		if (1 - final_exponent >= 64) {
+			*value = negative ? -0. : 0.;
+			return true;
+		}
+
+		//A subnormal number can round up to the smallest normal number, which is indicated by the carry into the exponent bit
+		mantissa >>= 1 - final_exponent;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		final_exponent = mantissa < (UINT64_C(1) << (DBL_MANT_DIG - 1)) ? 0 : 1;
+	} else {
+		//The product is exactly halfway between 2 numbers only if there are no other bits after the rounding bit, which can only happen
+		//for small exponents
+		if (low <= 1 && exponent >= -4 && exponent <= 23 && (mantissa & 3) == 1 && (mantissa << (upper_bit + 64 - (DBL_MANT_DIG + 2))) == high) {
+			mantissa &= ~UINT64_C(1);
+		}
+
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		if (mantissa >= (UINT64_C(2) << (DBL_MANT_DIG - 1))) {
+			mantissa = UINT64_C(1) << (DBL_MANT_DIG - 1);
+			++final_exponent;
+		}
+		mantissa &= ~(UINT64_C(1) << (DBL_MANT_DIG - 1));
+		if (final_exponent >= 2 * DBL_MAX_EXP - 1) {
+			*value = negative ? -HUGE_VAL : HUGE_VAL;
+			return true;
+		}
+	}
+
+	ud.u = (static_cast<uint64_t>(negative) << 63) | (static_cast<uint64_t>(final_exponent) << (DBL_MANT_DIG - 1)) | mantissa;
+	*value = ud.d;
+	return true;
+}
+
 #else
 
 //! Rounds a 55 bit mantissa to 53 bits using round to nearest even, and updates the exponent if necessary
@@ -2495,6 +3965,11 @@ double jsop_decimal_to_double(uint64_t significand, int exponent, bool negative)
 			}
 #endif
 
+			double value;
+			if (jsop_decimal_to_double_eisel_lemire(significand, exponent, negative, &value)) {
+				return value;
+			}
+
 			if (static_cast<unsigned>(exponent) < jsop_get_array_size(JsopSmallPowersOfFive)) {
 				jsop_uint_multiply_1x1(&remainder, &mantissa, significand, JsopSmallPowersOfFive[exponent]);
 				if (mantissa != 0) {
@@ -2590,6 +4065,11 @@ double jsop_decimal_to_double(uint64_t significand, int exponent, bool negative)
 			}
 #endif
 
+			double value;
+			if (jsop_decimal_to_double_eisel_lemire(significand, exponent, negative, &value)) {
+				return value;
+			}
+
 			if (abs_exponent <= jsop_get_array_size(JsopNormalizedReciprocalExponentsOf5)) {
 				if (significand != 1) {
 					jsop_uint_multiply_1x1(&remainder, &mantissa, significand, JsopNormalizedReciprocalsOf5[abs_exponent - 1]);
@@ -2981,6 +4461,149 @@ double jsop_decimal_to_double(uint64_t significand, int exponent, bool negative)
 #endif
 }
 
+//! Multiplies the given multi-precision unsigned integer by 5^n in place, and returns the new end of the integer
+static uint32_t *jsop_mp_uint_multiply_power_of_five_assign(uint32_t *a, uint32_t *a_end, unsigned n) noexcept {
+	uint32_t power_of_five;
+
+	//5^13 is the largest power of 5 that fits in 32 bits
+	for (; n >= 13; n -= 13) {
+		a_end = jsop_mp_uint_multiply_add_assign_x1(a, a_end, UINT32_C(1220703125), UINT32_C(0));
+	}
+	power_of_five = 1;
+	for (; n > 0; --n) {
+		power_of_five *= 5;
+	}
+	return jsop_mp_uint_multiply_add_assign_x1(a, a_end, power_of_five, UINT32_C(0));
+}
+
+double jsop_long_decimal_to_double(uint64_t significand, const char *digits, size_t n, int exponent, bool negative) noexcept {
+	//The integers are at most about 4900 bits when the value is compared with the halfway point between 2 double precision numbers
+	uint32_t digits_uints[JSOP_LONG_DECIMAL_MAX_UINTS];
+	uint32_t value_uints[JSOP_LONG_DECIMAL_MAX_UINTS];
+	uint32_t power_of_five_uints[JSOP_LONG_DECIMAL_MAX_UINTS];
+	uint32_t halfway_uints[JSOP_LONG_DECIMAL_MAX_UINTS];
+	union {
+		uint64_t u;
+		double d;
+	} ud;
+	uint32_t *digits_end;
+	uint32_t *power_of_five_end;
+	double lower, upper;
+	int digits_exponent;
+	bool sticky;
+
+	//Trailing zeros do not change the value
+	while (n != 0 && digits[n - 1] == '0') {
+		--n;
+	}
+	if (n == 0) {
+		return jsop_decimal_to_double(significand, exponent, negative);
+	}
+
+	//The value is less than (significand + 1) * 10^exponent, which is less than half of the smallest subnormal number
+	if (exponent < -(JSOP_MIN_EXPONENT_OF_SUBNORMAL + 20)) {
+		return negative ? -0. : 0.;
+	}
+
+	//The value is between the significand and the next integer (scaled by the power of 10), so the result is already known if both of them
+	//round to the same number
+	lower = jsop_decimal_to_double(significand, exponent, false);
+	if (significand != UINT64_MAX) {
+		upper = jsop_decimal_to_double(significand + 1, exponent, false);
+		if (lower == upper) {
+			return negative ? -lower : lower;
+		}
+	}
+	if (isinf(lower)) {
+		return negative ? -HUGE_VAL : HUGE_VAL;
+	}
+
+	//The digits after the maximum only matter when the rest of the digits are exactly at the halfway point, so they are replaced by a
+	//single non-zero digit (as there is at least one non-zero digit after the trailing zeros are removed)
+	sticky = false;
+	if (n > JSOP_LONG_DECIMAL_MAX_DIGITS) {
+		n = JSOP_LONG_DECIMAL_MAX_DIGITS;
+		sticky = true;
+	}
+
+	//Compute all the digits as an integer, so the value is digits * 10^digits_exponent
+	digits_uints[0] = static_cast<uint32_t>(significand);
+	digits_uints[1] = static_cast<uint32_t>(significand >> 32);
+	digits_end = digits_uints + (digits_uints[1] != 0 ? 2 : 1);
+	for (size_t i = 0; i < n;) {
+		uint32_t chunk = 0, scale = 1;
+		//Add up to 9 digits at a time
+		for (size_t chunk_end = i + 9 < n ? i + 9 : n; i < chunk_end; ++i) {
+			chunk = chunk * 10 + static_cast<uint32_t>(digits[i] - '0');
+			scale *= 10;
+		}
+		digits_end = jsop_mp_uint_multiply_add_assign_x1(digits_uints, digits_end, scale, chunk);
+	}
+	digits_exponent = exponent - static_cast<int>(n);
+	if (sticky) {
+		digits_end = jsop_mp_uint_multiply_add_assign_x1(digits_uints, digits_end, UINT32_C(10), UINT32_C(1));
+		--digits_exponent;
+	}
+
+	//Move the power of 5 to the side of the comparison where it is positive, so only the powers of 2 differ
+	if (digits_exponent > 0) {
+		digits_end = jsop_mp_uint_multiply_power_of_five_assign(digits_uints, digits_end, static_cast<unsigned>(digits_exponent));
+	}
+	power_of_five_uints[0] = 1;
+	power_of_five_end = power_of_five_uints + 1;
+	if (digits_exponent < 0) {
+		power_of_five_end = jsop_mp_uint_multiply_power_of_five_assign(power_of_five_uints, power_of_five_end, static_cast<unsigned>(-digits_exponent));
+	}
+
+	ud.d = lower;
+	for (;;) {
+		uint64_t mantissa, halfway_mantissa;
+		uint32_t *value_end;
+		uint32_t *halfway_end;
+		int biased_exponent, halfway_exponent;
+
+		//The halfway point between the candidate and the next larger number is (2 * mantissa + 1) * 2^(halfway_exponent)
+		biased_exponent = static_cast<int>(ud.u >> (DBL_MANT_DIG - 1));
+		if (biased_exponent >= 2 * DBL_MAX_EXP - 1) {
+			return negative ? -HUGE_VAL : HUGE_VAL;
+		}
+		mantissa = ud.u & ((UINT64_C(1) << (DBL_MANT_DIG - 1)) - 1);
+		if (biased_exponent != 0) {
+			mantissa |= UINT64_C(1) << (DBL_MANT_DIG - 1);
+		} else {
+			//Subnormal numbers have the same exponent as the smallest normal numbers
+			biased_exponent = 1;
+		}
+		halfway_exponent = biased_exponent - (DBL_MAX_EXP - 1) - (DBL_MANT_DIG - 1) - 1;
+		halfway_mantissa = mantissa * 2 + 1;
+
+		//Compare digits * 5^digits_exponent * 2^digits_exponent with halfway_mantissa * 2^halfway_exponent
+		for (auto i = digits_uints; i != digits_end; ++i) {
+			value_uints[i - digits_uints] = *i;
+		}
+		value_end = value_uints + (digits_end - digits_uints);
+		halfway_end = jsop_mp_uint_multiply_x2(halfway_uints, power_of_five_uints, power_of_five_end,
+			static_cast<uint32_t>(halfway_mantissa), static_cast<uint32_t>(halfway_mantissa >> 32));
+		if (digits_exponent > halfway_exponent) {
+			value_end = jsop_mp_uint_shift_left_assign(value_uints, value_end, static_cast<unsigned>(digits_exponent - halfway_exponent));
+		} else if (digits_exponent < halfway_exponent) {
+			halfway_end = jsop_mp_uint_shift_left_assign(halfway_uints, halfway_end, static_cast<unsigned>(halfway_exponent - digits_exponent));
+		}
+
+		auto compare_result = jsop_mp_uint_compare_any(value_uints, value_end, halfway_uints, halfway_end);
+		if (compare_result < 0 || (compare_result == 0 && (mantissa & 1) == 0)) {
+			break;
+		}
+		//The value rounds to the next larger number, which is found by incrementing the representation
+		++ud.u;
+	}
+
+	if ((ud.u >> (DBL_MANT_DIG - 1)) >= 2 * DBL_MAX_EXP - 1) {
+		return negative ? -HUGE_VAL : HUGE_VAL;
+	}
+	return negative ? -ud.d : ud.d;
+}
+
 double jsop_hexadecimal_to_double(uint64_t significand, int exponent, bool negative) noexcept {
 #if JSOP_WORD_SIZE == 64
 	uint64_t mantissa, remainder;
@@ -3094,3 +4717,198 @@ double jsop_hexadecimal_to_double(uint64_t significand, int exponent, bool negat
 	}
 #endif
 }
+
+//! Multiplies the given integer by the given 125-bit value (as the high and low parts), and returns the product shifted right by n bits
+//! (which is greater than 64)
+JSOP_INLINE uint64_t jsop_uint_multiply_shift_right_1x2(uint64_t a, const uint64_t *b, int n) noexcept {
+	uint64_t low_low, low_high, high_low, high_high;
+
+	assert(n > 64);
+
+#if JSOP_WORD_SIZE == 64
+	jsop_uint_multiply_1x1(&low_low, &low_high, a, b[1]);
+	jsop_uint_multiply_1x1(&high_low, &high_high, a, b[0]);
+#else
+	uint32_t d0, d1, d2, d3;
+
+	jsop_uint_multiply_2x2(&d0, &d1, &d2, &d3, static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32), static_cast<uint32_t>(b[1]), static_cast<uint32_t>(b[1] >> 32));
+	low_low = (static_cast<uint64_t>(d1) << 32) | d0;
+	low_high = (static_cast<uint64_t>(d3) << 32) | d2;
+	jsop_uint_multiply_2x2(&d0, &d1, &d2, &d3, static_cast<uint32_t>(a), static_cast<uint32_t>(a >> 32), static_cast<uint32_t>(b[0]), static_cast<uint32_t>(b[0] >> 32));
+	high_low = (static_cast<uint64_t>(d1) << 32) | d0;
+	high_high = (static_cast<uint64_t>(d3) << 32) | d2;
+#endif
+	(void)low_low;
+
+	//Only the bits from 64 onwards are needed, where the product of the low part only contributes its high part
+	high_low += low_high;
+	high_high += high_low < low_high;
+	n -= 64;
+	return (high_high << (64 - n)) | (high_low >> n);
+}
+
+//! Computes floor(log10(2^e)) for e in [0, 1650]
+JSOP_INLINE int jsop_log10_pow2(int e) noexcept {
+	return static_cast<int>((static_cast<uint32_t>(e) * 78913) >> 18);
+}
+
+//! Computes floor(log10(5^e)) for e in [0, 2620]
+JSOP_INLINE int jsop_log10_pow5(int e) noexcept {
+	return static_cast<int>((static_cast<uint32_t>(e) * 732923) >> 20);
+}
+
+//! Computes the number of bits of 5^e (ceil(log2(5^e)) for e > 0, or 1 for e = 0) for e in [0, 3528]
+JSOP_INLINE int jsop_pow5_bits(int e) noexcept {
+	return static_cast<int>(((static_cast<uint32_t>(e) * 1217359) >> 19) + 1);
+}
+
+//! Checks if the given value is divisible by 5^p
+JSOP_INLINE bool jsop_uint_is_multiple_of_power_of_5(uint64_t value, int p) noexcept {
+	int count = 0;
+
+	assert(value != 0);
+	while (value % 5 == 0) {
+		value /= 5;
+		++count;
+	}
+	return count >= p;
+}
+
+//! Checks if the given value is divisible by 2^p (for p < 64)
+JSOP_INLINE bool jsop_uint_is_multiple_of_power_of_2(uint64_t value, int p) noexcept {
+	assert(p < 64);
+	return (value & ((UINT64_C(1) << p) - 1)) == 0;
+}
+
+uint64_t jsop_double_to_decimal(double value, int *exponent) noexcept {
+	union {
+		uint64_t u;
+		double d;
+	} ud;
+	uint64_t ieee_mantissa, m2, mv, vr, vp, vm, output;
+	int ieee_exponent, e2, e10, q, i, k, removed;
+	unsigned mm_shift;
+	bool accept_bounds, vm_is_trailing_zeros, vr_is_trailing_zeros;
+	unsigned last_removed_digit;
+
+	//This is the Ryu algorithm by Ulf Adams, which computes the decimal interval of the numbers that are read back as the given number
+	//and removes as many digits as possible while the interval still contains a decimal number
+	ud.d = value;
+	ieee_mantissa = ud.u & ((UINT64_C(1) << (DBL_MANT_DIG - 1)) - 1);
+	ieee_exponent = static_cast<int>((ud.u >> (DBL_MANT_DIG - 1)) & (2 * DBL_MAX_EXP - 1));
+	assert(ieee_exponent != 2 * DBL_MAX_EXP - 1);
+
+	if (ieee_exponent == 0 && ieee_mantissa == 0) {
+		*exponent = 0;
+		return 0;
+	}
+
+	//The number is m2 * 2^e2, where 2 extra bits are used for the halfway points between the neighbouring numbers
+	if (ieee_exponent == 0) {
+		e2 = 1 - (DBL_MAX_EXP - 1) - (DBL_MANT_DIG - 1) - 2;
+		m2 = ieee_mantissa;
+	} else {
+		e2 = ieee_exponent - (DBL_MAX_EXP - 1) - (DBL_MANT_DIG - 1) - 2;
+		m2 = (UINT64_C(1) << (DBL_MANT_DIG - 1)) | ieee_mantissa;
+	}
+	//The bounds are included when the mantissa is even, since they are rounded to even when read back
+	accept_bounds = (m2 & 1) == 0;
+
+	//The lower bound is closer when the mantissa is a power of 2 (except for the smallest normal numbers)
+	mv = 4 * m2;
+	mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+	//Compute the bounds and the number itself multiplied by a power of 10, so they are integers with a few more digits than needed
+	vm_is_trailing_zeros = false;
+	vr_is_trailing_zeros = false;
+	if (e2 >= 0) {
+		q = jsop_log10_pow2(e2) - (e2 > 3);
+		e10 = q;
+		k = 125 + jsop_pow5_bits(q) - 1;
+		i = -e2 + q + k;
+		vr = jsop_uint_multiply_shift_right_1x2(4 * m2, JsopReciprocalsOfFive125 + q * 2, i);
+		vp = jsop_uint_multiply_shift_right_1x2(4 * m2 + 2, JsopReciprocalsOfFive125 + q * 2, i);
+		vm = jsop_uint_multiply_shift_right_1x2(4 * m2 - 1 - mm_shift, JsopReciprocalsOfFive125 + q * 2, i);
+		if (q <= 21) {
+			//Only one of mp, mv and mm can be a multiple of 5 if any
+			if (mv % 5 == 0) {
+				vr_is_trailing_zeros = jsop_uint_is_multiple_of_power_of_5(mv, q);
+			} else if (accept_bounds) {
+				vm_is_trailing_zeros = jsop_uint_is_multiple_of_power_of_5(mv - 1 - mm_shift, q);
+			} else {
+				vp -= jsop_uint_is_multiple_of_power_of_5(mv + 2, q);
+			}
+		}
+	} else {
+		q = jsop_log10_pow5(-e2) - (-e2 > 1);
+		e10 = q + e2;
+		i = -e2 - q;
+		k = jsop_pow5_bits(i) - 125;
+		vr = jsop_uint_multiply_shift_right_1x2(4 * m2, JsopPowersOfFive125 + i * 2, q - k);
+		vp = jsop_uint_multiply_shift_right_1x2(4 * m2 + 2, JsopPowersOfFive125 + i * 2, q - k);
+		vm = jsop_uint_multiply_shift_right_1x2(4 * m2 - 1 - mm_shift, JsopPowersOfFive125 + i * 2, q - k);
+		if (q <= 1) {
+			//mv has at least q trailing zero bits, and so do mp and mm if they are divisible by 2 (which only mm may not be)
+			vr_is_trailing_zeros = true;
+			if (accept_bounds) {
+				vm_is_trailing_zeros = mm_shift == 1;
+			} else {
+				--vp;
+			}
+		} else if (q < 63) {
+			vr_is_trailing_zeros = jsop_uint_is_multiple_of_power_of_2(mv, q);
+		}
+	}
+
+	//Remove the digits while the bounds still differ
+	removed = 0;
+	last_removed_digit = 0;
+	if (JSOP_UNLIKELY(vm_is_trailing_zeros || vr_is_trailing_zeros)) {
+		while (vp / 10 > vm / 10) {
+			vm_is_trailing_zeros &= vm % 10 == 0;
+			vr_is_trailing_zeros &= last_removed_digit == 0;
+			last_removed_digit = static_cast<unsigned>(vr % 10);
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		if (vm_is_trailing_zeros) {
+			while (vm % 10 == 0) {
+				vr_is_trailing_zeros &= last_removed_digit == 0;
+				last_removed_digit = static_cast<unsigned>(vr % 10);
+				vr /= 10;
+				vp /= 10;
+				vm /= 10;
+				++removed;
+			}
+		}
+		if (vr_is_trailing_zeros && last_removed_digit == 5 && vr % 2 == 0) {
+			//Round to even when the number is exactly halfway
+			last_removed_digit = 4;
+		}
+		output = vr + ((vr == vm && (!accept_bounds || !vm_is_trailing_zeros)) || last_removed_digit >= 5);
+	} else {
+		//The common case, where the bounds are never included
+		bool round_up = false;
+
+		if (vp / 100 > vm / 100) {
+			round_up = vr % 100 >= 50;
+			vr /= 100;
+			vp /= 100;
+			vm /= 100;
+			removed += 2;
+		}
+		while (vp / 10 > vm / 10) {
+			round_up = vr % 10 >= 5;
+			vr /= 10;
+			vp /= 10;
+			vm /= 10;
+			++removed;
+		}
+		output = vr + (vr == vm || round_up);
+	}
+
+	*exponent = e10 + removed;
+	return output;
+}
@@ -13,8 +13,8 @@ JsopValue *JsopDocumentHandler::resizeStack() noexcept {
 
 	capacity = StackAllocEnd - StackStart;
 	if (capacity <= SIZE_MAX / (sizeof(JsopValue) * 2)) {
+		new_start = static_cast<JsopValue *>(jsop_reallocate(Pools.getAllocator(), StackStart, capacity * sizeof(JsopValue), capacity * 2 * sizeof(JsopValue)));
 		capacity *= 2;
-		new_start = static_cast<JsopValue *>(realloc(StackStart, capacity * sizeof(JsopValue)));
 		if (new_start != nullptr) {
 			n = StackEnd - StackStart;
 			StackStart = new_start;
@@ -26,10 +26,106 @@ JsopValue *JsopDocumentHandler::resizeStack() noexcept {
 	return nullptr;
 }
 
+JsopValue *JsopDocumentHandler::makeIndexedObject(const JsopValue *values, size_t n) noexcept {
+	auto new_values = Pools.alloc<JsopValue>(n * 2 + JsopObjectView::getIndexSize(n));
+	if (new_values != nullptr) {
+		memcpy(new_values, values, sizeof(JsopValue) * n * 2);
+		jsop_object_make_index(new_values, n);
+	}
+	return new_values;
+}
+
+//! Checks if the key of the first pair is less than the key of the second pair, comparing the bytes of the keys
+JSOP_INLINE bool jsop_key_less(const JsopValue *values, uint32_t i, uint32_t j) noexcept {
+	auto a = values[static_cast<size_t>(i) * 2].getStringView();
+	auto b = values[static_cast<size_t>(j) * 2].getStringView();
+	auto rv = memcmp(a.data(), b.data(), a.size() < b.size() ? a.size() : b.size());
+	return rv < 0 || (rv == 0 && a.size() < b.size());
+}
+
+JsopValue *JsopDocumentHandler::makeSortedObject(const JsopValue *values, size_t n) noexcept {
+	uint32_t *order;
+	uint32_t *temp;
+	size_t i, j, k, width, middle, end;
+
+	//Sort the positions of the pairs, which needs twice their number of integers
+	if (SortCapacity < n * 2) {
+		auto new_start = static_cast<uint32_t *>(jsop_reallocate(Pools.getAllocator(), SortStart, sizeof(uint32_t) * SortCapacity, sizeof(uint32_t) * n * 2));
+		if (new_start == nullptr) {
+			return nullptr;
+		}
+		SortStart = new_start;
+		SortCapacity = n * 2;
+	}
+	order = SortStart;
+	temp = SortStart + n;
+	for (i = 0; i < n; ++i) {
+		order[i] = static_cast<uint32_t>(i);
+	}
+
+	//Merge runs of increasing width, which keeps pairs with the same key in the order that they were parsed
+	for (width = 1; width < n; width *= 2) {
+		for (i = 0; i < n; i += width * 2) {
+			middle = i + width < n ? i + width : n;
+			end = middle + width < n ? middle + width : n;
+			j = i;
+			k = middle;
+			for (size_t l = i; l < end; ++l) {
+				if (k == end || (j != middle && !jsop_key_less(values, order[k], order[j]))) {
+					temp[l] = order[j];
+					++j;
+				} else {
+					temp[l] = order[k];
+					++k;
+				}
+			}
+		}
+		auto swap = order;
+		order = temp;
+		temp = swap;
+	}
+
+	auto new_values = Pools.alloc<JsopValue>(n * 2 + JsopObjectView::getInsertionOrderSize(n));
+	if (new_values != nullptr) {
+		auto insertion_order = reinterpret_cast<uint32_t *>(new_values + n * 2);
+		for (i = 0; i < n; ++i) {
+			memcpy(new_values + i * 2, values + static_cast<size_t>(order[i]) * 2, sizeof(JsopValue) * 2);
+			insertion_order[order[i]] = static_cast<uint32_t>(i);
+		}
+	}
+	return new_values;
+}
+
+bool JsopDocumentHandler::makeInternedString(JsopValue *new_value, const char *start, size_t n) noexcept {
+	char *new_string;
+
+	auto hash = jsop_hash_string(start, n);
+	auto value = Strings.find(start, n, hash);
+	if (value != nullptr) {
+		*new_value = *value;
+		return true;
+	}
+
+	if (JSOP_LIKELY(n <= JsopValue::MAX_SIZE)) {
+		new_string = Pools.alloc<char>(n + 1);
+		if (new_string != nullptr) {
+			new_value->setString(n, new_string);
+			memcpy(new_string, start, n);
+			new_string[n] = '\0';
+			//The copy stays in the pools until the document is destroyed, so the table refers to it, and the string is still made if it
+			//cannot be added
+			Strings.insert(new_string, n, hash, *new_value, false);
+			return true;
+		}
+	}
+	new_value->setNull();
+	return false;
+}
+
 bool JsopDocumentHandler::start() noexcept {
 	if (StackStart == nullptr) {
 		static_assert(JSOP_VALUE_STACK_MIN_SIZE % sizeof(JsopValue) == 0, "JSOP_VALUE_STACK_MIN_SIZE % sizeof(JsopValue) == 0");
-		StackStart = static_cast<JsopValue *>(malloc(JSOP_VALUE_STACK_MIN_SIZE));
+		StackStart = static_cast<JsopValue *>(jsop_allocate(Pools.getAllocator(), JSOP_VALUE_STACK_MIN_SIZE));
 		if (StackStart == nullptr) {
 			return false;
 		}
@@ -37,32 +133,82 @@ bool JsopDocumentHandler::start() noexcept {
 	}
 	StackEnd = StackStart;
 	PrevStackSize = 0;
+	//The strings in the table belong to the previous document
+	Strings.clear();
 	return true;
 }
 
 bool JsopDocumentHandler::finish(JsopDocument *doc) noexcept {
+	auto allocator = Pools.getAllocator();
+	if (ReuseDocument) {
+		//The memory of the document is only exchanged when it was allocated by the same allocator
+		if (doc->Pools.getAllocator() != allocator) {
+			jsop_release(doc->Pools.getAllocator(), doc->Value, doc->Capacity);
+			doc->Value = nullptr;
+			doc->Capacity = 0;
+			doc->Pools.setAllocator(allocator);
+		}
+
+		//The previous values of the document are no longer used, so their memory is kept for the next parse
+		doc->Pools.swap(&Pools);
+		Pools.reset();
+
+		auto values = doc->Value;
+		auto capacity = doc->Capacity;
+		doc->Value = StackStart;
+		doc->Capacity = (StackAllocEnd - StackStart) * sizeof(JsopValue);
+		if (capacity >= JSOP_VALUE_STACK_MIN_SIZE) {
+			StackStart = values;
+			StackAllocEnd = values + capacity / sizeof(JsopValue);
+		} else {
+			jsop_release(allocator, values, capacity);
+			StackStart = nullptr;
+		}
+		return true;
+	}
+
+	jsop_release(doc->Pools.getAllocator(), doc->Value, doc->Capacity);
 	doc->Pools.move(&Pools);
 
-	free(doc->Value);
-	//Resize the stack to hold only the exact number of items
+	//Resize the stack to hold only the exact number of items, unless the allocator would have to copy them
 	auto stack_start = StackStart;
-	if (StackAllocEnd > StackEnd) {
-		stack_start = static_cast<JsopValue *>(realloc(StackStart, (StackEnd - StackStart) * sizeof(JsopValue)));
-		if (stack_start != nullptr && stack_start != StackStart) {
-			auto type = stack_start->getType();
-			if ((type == JsopValue::ArrayType ||
-				type == JsopValue::ObjectType) &&
-				stack_start->getValues() != nullptr) {
-				assert(stack_start->getValues() == StackStart + 1);
-				stack_start->setValues(stack_start + 1);
+	auto capacity = StackAllocEnd - StackStart;
+	if (StackAllocEnd > StackEnd && allocator->Reallocate != nullptr) {
+		stack_start = static_cast<JsopValue *>(jsop_reallocate(allocator, StackStart, capacity * sizeof(JsopValue), (StackEnd - StackStart) * sizeof(JsopValue)));
+		if (stack_start == nullptr) {
+			stack_start = StackStart;
+		} else {
+			capacity = StackEnd - StackStart;
+			if (stack_start != StackStart) {
+				auto type = stack_start->getType();
+				//Objects with a hash index are never left on the stack, sorted objects only when they are empty, and indexed objects only
+				//when they are too small for an index
+				if ((type == JsopValue::ArrayType ||
+					type == JsopValue::ObjectType ||
+					type == JsopValue::SortedObjectType ||
+					type == JsopValue::IndexedObjectType) &&
+					stack_start->getValues() == StackStart + 1) {
+					stack_start->setValues(stack_start + 1);
+				}
 			}
 		}
 	}
 	doc->Value = stack_start;
+	doc->Capacity = capacity * sizeof(JsopValue);
 	StackStart = nullptr;
 	return true;
 }
 
+void JsopDocumentHandler::setAllocator(const JsopAllocator *allocator) noexcept {
+	auto old_allocator = Pools.getAllocator();
+	jsop_release(old_allocator, StackStart, (StackAllocEnd - StackStart) * sizeof(JsopValue));
+	StackStart = nullptr;
+	jsop_release(old_allocator, SortStart, SortCapacity * sizeof(uint32_t));
+	SortStart = nullptr;
+	SortCapacity = 0;
+	Pools.setAllocator(allocator);
+}
+
 #if JSOP_WORD_SIZE != 64
 bool JsopDocumentHandler::makeInteger(uint64_t value, bool negative) noexcept {
 	auto new_value = makeValue();
@@ -10,8 +10,8 @@ size_t *JsopEventHandler::resize() noexcept {
 
 	capacity = (AllocEnd - Start) * sizeof(*Start);
 	if (capacity <= SIZE_MAX / 2) {
+		new_start = static_cast<size_t *>(jsop_reallocate(Allocator, Start, capacity, capacity * 2));
 		capacity *= 2;
-		new_start = static_cast<size_t *>(realloc(Start, capacity));
 		if (new_start != nullptr) {
 			n = End - Start;
 			Start = new_start;
@@ -4,15 +4,58 @@
 
 #include <limits.h>
 #include <stddef.h>
-#include <stdlib.h>
 
 #include "JsopMemoryPools.h"
 
 void JsopMemoryPools::destroy(Pool *pool) noexcept {
 	Pool *next;
 
+	//Memory that is released all at once by the owner of the allocator does not need to be walked
+	if (Allocator->Release == nullptr) {
+		return;
+	}
 	for (; pool != nullptr; pool = next) {
 		next = pool->Next;
-		free(pool);
+		jsop_release(Allocator, pool, pool->Capacity + offsetof(Pool, Data));
+	}
+}
+
+JsopMemoryPools::Pool *JsopMemoryPools::takeLarge(size_t size) noexcept {
+	Pool **prev;
+	Pool **best;
+
+	//Use the smallest pool that fits, so the larger ones are left for larger allocations
+	best = nullptr;
+	for (prev = &Large; *prev != nullptr; prev = &(*prev)->Next) {
+		if ((*prev)->Capacity >= size && (best == nullptr || (*prev)->Capacity < (*best)->Capacity)) {
+			best = prev;
+		}
+	}
+	if (best != nullptr) {
+		auto pool = *best;
+		*best = pool->Next;
+		return pool;
+	}
+	return nullptr;
+}
+
+void JsopMemoryPools::reset() noexcept {
+	Pool *pool;
+	Pool *next;
+
+	//Only keep the large pools that the allocations since the previous reset() needed, so they do not accumulate
+	destroy(Large);
+	Large = nullptr;
+	for (pool = Head; pool != nullptr; pool = next) {
+		next = pool->Next;
+		pool->Size = 0;
+		if (pool->Capacity == JSOP_MEMORY_POOL_MIN_SIZE - offsetof(Pool, Data)) {
+			pool->Next = Free;
+			Free = pool;
+		} else {
+			pool->Next = Large;
+			Large = pool;
+		}
 	}
+	Head = nullptr;
 }
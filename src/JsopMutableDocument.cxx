@@ -0,0 +1,490 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <assert.h>
+#include <string.h>
+
+#include "JsopMutableDocument.h"
+#include "JsopStack.h"
+
+//! Gets the slot of the hash table of the blocks where the search for the given values starts
+JSOP_INLINE size_t jsop_block_hash(const JsopValue *values, size_t capacity) noexcept {
+	return static_cast<size_t>((static_cast<uint64_t>(reinterpret_cast<uintptr_t>(values)) * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (capacity - 1);
+}
+
+size_t JsopMutableDocument::getCapacity(const JsopValue &value) const noexcept {
+	auto values = value.getValues();
+	if (BlocksCount != 0 && values != nullptr) {
+		for (auto i = jsop_block_hash(values, BlocksCapacity); BlocksStart[i].Values != nullptr; i = (i + 1) & (BlocksCapacity - 1)) {
+			if (BlocksStart[i].Values == values) {
+				return BlocksStart[i].Capacity;
+			}
+		}
+	}
+	//The values of a parsed array or object have no spare capacity
+	return value.size();
+}
+
+bool JsopMutableDocument::addBlock(const JsopValue *values, size_t capacity) noexcept {
+	if (BlocksCount >= BlocksCapacity / 2) {
+		size_t new_capacity;
+
+		if (BlocksCapacity == 0) {
+			new_capacity = JSOP_MUTABLE_DOCUMENT_TABLE_MIN_SIZE;
+		} else if (BlocksCapacity <= SIZE_MAX / (2 * sizeof(Block))) {
+			new_capacity = BlocksCapacity * 2;
+		} else {
+			return false;
+		}
+		auto new_start = static_cast<Block *>(jsop_allocate(Pools.getAllocator(), new_capacity * sizeof(Block)));
+		if (new_start == nullptr) {
+			return false;
+		}
+		memset(static_cast<void *>(new_start), 0, new_capacity * sizeof(Block));
+		for (auto block = BlocksStart, end = BlocksStart + BlocksCapacity; block != end; ++block) {
+			if (block->Values != nullptr) {
+				auto i = jsop_block_hash(block->Values, new_capacity);
+				while (new_start[i].Values != nullptr) {
+					i = (i + 1) & (new_capacity - 1);
+				}
+				new_start[i] = *block;
+			}
+		}
+		jsop_release(Pools.getAllocator(), BlocksStart, BlocksCapacity * sizeof(Block));
+		BlocksStart = new_start;
+		BlocksCapacity = new_capacity;
+	}
+
+	//Blocks are never reused until compact() clears the table, so the values cannot be in the table already
+	auto i = jsop_block_hash(values, BlocksCapacity);
+	while (BlocksStart[i].Values != nullptr) {
+		i = (i + 1) & (BlocksCapacity - 1);
+	}
+	BlocksStart[i].Values = values;
+	BlocksStart[i].Capacity = capacity;
+	++BlocksCount;
+	return true;
+}
+
+JsopValue *JsopMutableDocument::reserve(JsopValue *value) noexcept {
+	size_t n, new_capacity, max_size, new_size, old_size;
+	bool object;
+
+	n = value->size();
+	auto values = const_cast<JsopValue *>(value->getValues());
+	if (n < getCapacity(*value)) {
+		return values;
+	}
+
+	//Objects are limited to the number of keys that can have a hash index, and their positions must fit in the insertion order
+	object = value->isObject();
+	auto type = value->getType();
+	max_size = object ? static_cast<size_t>(UINT32_MAX >> 2) : static_cast<size_t>(JsopValue::MAX_SIZE);
+	if (n >= max_size) {
+		return nullptr;
+	}
+	new_capacity = n < JSOP_MUTABLE_DOCUMENT_BLOCK_MIN_SIZE ? JSOP_MUTABLE_DOCUMENT_BLOCK_MIN_SIZE : n * 2;
+	if (new_capacity > max_size) {
+		new_capacity = max_size;
+	}
+	if (object) {
+		new_size = new_capacity * 2 + getTrailerSize(new_capacity, type);
+		old_size = n * 2 + getTrailerSize(n, type);
+	} else {
+		new_size = new_capacity;
+		old_size = n;
+	}
+
+	auto new_values = Pools.alloc<JsopValue>(new_size);
+	if (new_values == nullptr || !addBlock(new_values, new_capacity)) {
+		return nullptr;
+	}
+	if (n != 0) {
+		memcpy(new_values, values, sizeof(JsopValue) * old_size);
+	}
+	value->setValues(new_values);
+	return new_values;
+}
+
+bool JsopMutableDocument::makeString(JsopValue *value, const char *s, size_t n) noexcept {
+	if (n < (sizeof(JsopValue) - sizeof(JsopValue::SmallString::size_type))) {
+		//setSmallString() reads whole words, which may be beyond the end of the given string
+		char data[sizeof(JsopValue)];
+		memcpy(data, s, n);
+		value->setSmallString(n, data);
+		return true;
+	} else if (JSOP_LIKELY(n <= JsopValue::MAX_SIZE)) {
+		auto new_string = Pools.alloc<char>(n + 1);
+		if (new_string != nullptr) {
+			memcpy(new_string, s, n);
+			new_string[n] = '\0';
+			value->setString(n, new_string);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool JsopMutableDocument::copyValue(JsopMemoryPools *pools, JsopValue *value) noexcept {
+	size_t n;
+
+	switch (value->getType()) {
+	case JsopValue::StringType: {
+		n = value->size();
+		auto new_string = pools->alloc<char>(n + 1);
+		if (new_string == nullptr) {
+			return false;
+		}
+		memcpy(new_string, value->getStringView().data(), n);
+		new_string[n] = '\0';
+		value->setString(n, new_string);
+		return true;
+	}
+
+	case JsopValue::ArrayType:
+	case JsopValue::ObjectType:
+	case JsopValue::SortedObjectType:
+	case JsopValue::IndexedObjectType:
+		n = value->size();
+		if (n != 0) {
+			if (value->isObject()) {
+				n = n * 2 + getTrailerSize(n, value->getType());
+			}
+			auto new_values = pools->alloc<JsopValue>(n);
+			if (new_values == nullptr) {
+				return false;
+			}
+			//The hash index or insertion order of an object refers to the positions of its pairs, so it is copied as is
+			memcpy(new_values, value->getValues(), sizeof(JsopValue) * n);
+			value->setValues(new_values);
+		} else {
+			value->setValues(nullptr);
+		}
+		return true;
+
+#if JSOP_WORD_SIZE != 64
+	case JsopValue::Int64Type: {
+		auto new_int64 = pools->alloc<int64_t>();
+		if (new_int64 == nullptr) {
+			return false;
+		}
+		*new_int64 = value->toInt64();
+		value->setInt64(new_int64);
+		return true;
+	}
+
+	case JsopValue::Uint64Type: {
+		auto new_uint64 = pools->alloc<uint64_t>();
+		if (new_uint64 == nullptr) {
+			return false;
+		}
+		*new_uint64 = value->toUint64();
+		value->setUint64(new_uint64);
+		return true;
+	}
+
+	case JsopValue::DoubleType: {
+		auto new_double = pools->alloc<double>();
+		if (new_double == nullptr) {
+			return false;
+		}
+		*new_double = value->getDouble();
+		value->setDouble(new_double);
+		return true;
+	}
+
+	case JsopValue::DecimalType: {
+		auto new_decimal = pools->alloc<JsopValue::DecimalNumber>();
+		if (new_decimal == nullptr) {
+			return false;
+		}
+		new_decimal->Significand = value->getDecimalSignificand();
+		new_decimal->Exponent = value->getDecimalExponent();
+		new_decimal->Negative = value->getDecimalNegative();
+		value->setDecimal(new_decimal);
+		return true;
+	}
+#endif
+
+	default:
+		return true;
+	}
+}
+
+void JsopMutableDocument::adopt(JsopDocument *doc) noexcept {
+	//The values and the table of the blocks are released before the pools, which may change the allocator
+	releaseValues();
+	if (Pools.getAllocator() != doc->Pools.getAllocator()) {
+		jsop_release(Pools.getAllocator(), BlocksStart, BlocksCapacity * sizeof(Block));
+		BlocksStart = nullptr;
+		BlocksCapacity = 0;
+	}
+	Pools.move(&doc->Pools);
+	if (doc->Value != nullptr) {
+		Root = *doc->Value;
+		RootValues = doc->Value;
+		RootCapacity = doc->Capacity;
+		doc->Value = nullptr;
+		doc->Capacity = 0;
+	} else {
+		Root.setNull();
+	}
+	adoptInput(doc->Input, doc->ReleaseInput);
+	doc->Input = nullptr;
+	doc->ReleaseInput = nullptr;
+}
+
+bool JsopMutableDocument::setInt64(JsopValue *value, int64_t integer) noexcept {
+#if JSOP_WORD_SIZE == 64
+	value->setInt64(integer);
+	return true;
+#else
+	if (integer >= INT32_MIN && integer <= INT32_MAX) {
+		value->setInt32(static_cast<int32_t>(integer));
+		return true;
+	} else if (integer > 0) {
+		return setUint64(value, static_cast<uint64_t>(integer));
+	}
+	auto new_int64 = Pools.alloc<int64_t>();
+	if (new_int64 != nullptr) {
+		*new_int64 = integer;
+		value->setInt64(new_int64);
+		return true;
+	}
+	return false;
+#endif
+}
+
+bool JsopMutableDocument::setUint64(JsopValue *value, uint64_t integer) noexcept {
+#if JSOP_WORD_SIZE == 64
+	if (integer <= INT64_MAX) {
+		value->setInt64(static_cast<int64_t>(integer));
+	} else {
+		value->setUint64(integer);
+	}
+	return true;
+#else
+	if (integer <= INT32_MAX) {
+		value->setInt32(static_cast<int32_t>(integer));
+		return true;
+	} else if (integer <= UINT32_MAX) {
+		value->setUint32(static_cast<uint32_t>(integer));
+		return true;
+	} else if (integer <= INT64_MAX) {
+		auto new_int64 = Pools.alloc<int64_t>();
+		if (new_int64 != nullptr) {
+			*new_int64 = static_cast<int64_t>(integer);
+			value->setInt64(new_int64);
+			return true;
+		}
+	} else {
+		auto new_uint64 = Pools.alloc<uint64_t>();
+		if (new_uint64 != nullptr) {
+			*new_uint64 = integer;
+			value->setUint64(new_uint64);
+			return true;
+		}
+	}
+	return false;
+#endif
+}
+
+bool JsopMutableDocument::setDouble(JsopValue *value, double number) noexcept {
+#if JSOP_WORD_SIZE == 64
+	value->setDouble(number);
+	return true;
+#else
+	auto new_double = Pools.alloc<double>();
+	if (new_double != nullptr) {
+		*new_double = number;
+		value->setDouble(new_double);
+		return true;
+	}
+	return false;
+#endif
+}
+
+JsopValue *JsopMutableDocument::insert(JsopValue *array, size_t i) noexcept {
+	if (!array->isArray()) {
+		return nullptr;
+	}
+	auto n = array->size();
+	if (i > n) {
+		return nullptr;
+	}
+	auto values = reserve(array);
+	if (values == nullptr) {
+		return nullptr;
+	}
+	memmove(values + i + 1, values + i, sizeof(JsopValue) * (n - i));
+	values[i].setNull();
+	array->setArray(values, n + 1);
+	return values + i;
+}
+
+bool JsopMutableDocument::erase(JsopValue *array, size_t i) noexcept {
+	if (!array->isArray()) {
+		return false;
+	}
+	auto n = array->size();
+	if (i >= n) {
+		return false;
+	}
+	auto values = const_cast<JsopValue *>(array->getValues());
+	memmove(values + i, values + i + 1, sizeof(JsopValue) * (n - i - 1));
+	array->setArray(values, n - 1);
+	return true;
+}
+
+JsopValue *JsopMutableDocument::set(JsopValue *object, const char *key, size_t n) noexcept {
+	JsopValue new_key;
+	size_t i, object_size;
+
+	if (!object->isObject()) {
+		return nullptr;
+	}
+	auto value = find(object, key, n);
+	if (value != nullptr) {
+		return value;
+	}
+
+	object_size = object->size();
+	if (!makeString(&new_key, key, n)) {
+		return nullptr;
+	}
+	auto values = reserve(object);
+	if (values == nullptr) {
+		return nullptr;
+	}
+	auto key_values = reinterpret_cast<JsopKeyValue *>(values);
+	if (object->getType() == JsopValue::SortedObjectType) {
+		i = object->getObjectView().lowerBound(key, n) - key_values;
+
+		//Move the insertion order after the new pair, and shift the positions of the pairs after the new pair
+		auto insertion_order = reinterpret_cast<uint32_t *>(values + object_size * 2);
+		auto new_insertion_order = reinterpret_cast<uint32_t *>(values + (object_size + 1) * 2);
+		memmove(new_insertion_order, insertion_order, sizeof(uint32_t) * object_size);
+		for (size_t j = 0; j < object_size; ++j) {
+			if (new_insertion_order[j] >= i) {
+				++new_insertion_order[j];
+			}
+		}
+		new_insertion_order[object_size] = static_cast<uint32_t>(i);
+
+		memmove(key_values + i + 1, key_values + i, sizeof(JsopKeyValue) * (object_size - i));
+		key_values[i].Key = new_key;
+		key_values[i].Value.setNull();
+		object->setSortedObject(values, object_size + 1);
+		assert(object->getObjectView().lowerBound(key, n) == key_values + i);
+	} else {
+		i = object_size;
+		key_values[i].Key = new_key;
+		key_values[i].Value.setNull();
+		if (object->getType() == JsopValue::IndexedObjectType) {
+			object->setIndexedObject(values, object_size + 1);
+			if (JsopObjectView::hasIndex(object_size + 1)) {
+				jsop_object_make_index(values, object_size + 1);
+			}
+		} else {
+			object->setObject(values, object_size + 1);
+		}
+	}
+	return &key_values[i].Value;
+}
+
+bool JsopMutableDocument::eraseKey(JsopValue *object, const char *key, size_t n) noexcept {
+	size_t i, object_size;
+
+	if (!object->isObject()) {
+		return false;
+	}
+	auto view = object->getObjectView();
+	auto key_value = view.find(key, n);
+	if (key_value == nullptr) {
+		return false;
+	}
+
+	object_size = view.size();
+	i = key_value - view.begin();
+	auto values = const_cast<JsopValue *>(object->getValues());
+	auto key_values = reinterpret_cast<JsopKeyValue *>(values);
+	memmove(key_values + i, key_values + i + 1, sizeof(JsopKeyValue) * (object_size - i - 1));
+	if (object->getType() == JsopValue::SortedObjectType) {
+		//Move the insertion order before the remaining pairs, which never overwrites the positions that have not been read yet
+		auto insertion_order = reinterpret_cast<const uint32_t *>(values + object_size * 2);
+		auto new_insertion_order = reinterpret_cast<uint32_t *>(values + (object_size - 1) * 2);
+		size_t k = 0;
+		for (size_t j = 0; j < object_size; ++j) {
+			auto position = insertion_order[j];
+			if (position != i) {
+				new_insertion_order[k] = position > i ? position - 1 : position;
+				++k;
+			}
+		}
+		object->setSortedObject(values, object_size - 1);
+	} else if (object->getType() == JsopValue::IndexedObjectType) {
+		object->setIndexedObject(values, object_size - 1);
+		if (JsopObjectView::hasIndex(object_size - 1)) {
+			jsop_object_make_index(values, object_size - 1);
+		}
+	} else {
+		object->setObject(values, object_size - 1);
+	}
+	return true;
+}
+
+bool JsopMutableDocument::compact() noexcept {
+	struct Context {
+		JsopValue *Next;
+		JsopValue *End;
+	};
+
+	JsopMemoryPools pools;
+	Context *stack_start;
+	Context *stack_end;
+	Context *stack_alloc_end;
+	JsopValue root;
+	bool ok;
+
+	pools.setAllocator(Pools.getAllocator());
+	root = Root;
+	stack_start = nullptr;
+	stack_end = nullptr;
+	stack_alloc_end = nullptr;
+	auto value = &root;
+	for (;;) {
+		ok = copyValue(&pools, value);
+		if (!ok) {
+			break;
+		}
+
+		//Copy the children of the values that have just been copied, where the keys and values of an object are consecutive values
+		if ((value->isArray() || value->isObject()) && value->size() != 0) {
+			if (JSOP_UNLIKELY(stack_end == stack_alloc_end) && !jsop_stack_grow(Pools.getAllocator(), &stack_start, &stack_end, &stack_alloc_end, JSOP_MUTABLE_DOCUMENT_STACK_MIN_SIZE)) {
+				ok = false;
+				break;
+			}
+			stack_end->Next = const_cast<JsopValue *>(value->getValues());
+			stack_end->End = stack_end->Next + (value->isObject() ? value->size() * 2 : value->size());
+			++stack_end;
+		}
+
+		while (stack_end != stack_start && stack_end[-1].Next == stack_end[-1].End) {
+			--stack_end;
+		}
+		if (stack_end == stack_start) {
+			break;
+		}
+		value = stack_end[-1].Next;
+		++stack_end[-1].Next;
+	}
+	jsop_release(Pools.getAllocator(), stack_start, (stack_alloc_end - stack_start) * sizeof(Context));
+
+	if (ok) {
+		Pools.move(&pools);
+		releaseValues();
+		Root = root;
+	}
+	return ok;
+}
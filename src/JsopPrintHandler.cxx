@@ -0,0 +1,45 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <string.h>
+
+#include "JsopPrintHandler.h"
+
+bool JsopPrintHandler::writeLineBreak() noexcept {
+	size_t n;
+
+	if (Depth > (SIZE_MAX - 1) / Indent) {
+		return false;
+	}
+	n = Depth * Indent;
+	auto dest = Writer.reserve(n + 1);
+	if (dest != nullptr) {
+		*dest = '\n';
+		memset(dest + 1, ' ', n);
+		Writer.End = dest + 1 + n;
+		return true;
+	}
+	return false;
+}
+
+bool JsopPrintHandler::endContainer(char ch) noexcept {
+	--Depth;
+	//Empty arrays and objects are written on a single line
+	if (!First && Indent != 0 && !writeLineBreak()) {
+		return false;
+	}
+	First = false;
+	return Writer.append(ch);
+}
+
+bool JsopPrintHandler::makeString(const char *start, const char *end, bool key) noexcept {
+	if (startValue() && Writer.writeString(start, end)) {
+		if (key) {
+			AfterKey = true;
+			return Indent == 0 ? Writer.append(':') : Writer.append(": ", 2);
+		}
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,564 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <stdint.h>
+
+#include "JsopCodePoint.h"
+#include "JsopSimd.h"
+
+#if defined(__GNUC__) && (defined(__amd64__) || defined(__i386__))
+#define JSOP_SIMD_X86
+#endif
+
+#ifdef JSOP_SIMD_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+static_assert(JSOP_INPUT_PADDING >= 64, "JSOP_INPUT_PADDING >= 64");
+
+static size_t jsop_copy_string_chars_scalar(char *dest, const char *src, size_t n) noexcept {
+	size_t i;
+
+	for (i = 0; i < n && jsop_code_point_is_normal_ascii_string_char(src[i]); ++i) {
+		dest[i] = src[i];
+	}
+	return i;
+}
+
+static const char *jsop_skip_string_chars_scalar(const char *start, const char *end) noexcept {
+	while (start != end && jsop_code_point_is_normal_ascii_string_char(*start)) {
+		++start;
+	}
+	return start;
+}
+
+JSOP_INLINE bool jsop_is_whitespace(char ch) noexcept {
+	return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+static const char *jsop_skip_whitespace_scalar(const char *start, const char *end) noexcept {
+	while (start != end && jsop_is_whitespace(*start)) {
+		++start;
+	}
+	return start;
+}
+
+static void jsop_classify_block_scalar(const char *block, JsopSimdBlockMasks *masks) noexcept {
+	uint64_t quote_mask = 0, backslash_mask = 0, structural_mask = 0;
+
+	for (unsigned i = 0; i < 64; ++i) {
+		switch (block[i]) {
+		case '"':
+			quote_mask |= UINT64_C(1) << i;
+			break;
+
+		case '\\':
+			backslash_mask |= UINT64_C(1) << i;
+			break;
+
+		case '{':
+		case '}':
+		case '[':
+		case ']':
+		case ':':
+		case ',':
+			structural_mask |= UINT64_C(1) << i;
+			break;
+
+		default:
+			break;
+		}
+	}
+	masks->Quote = quote_mask;
+	masks->Backslash = backslash_mask;
+	masks->Structural = structural_mask;
+}
+
+#ifdef JSOP_SIMD_X86
+
+__attribute__((target("sse2")))
+static size_t jsop_copy_string_chars_sse2(char *dest, const char *src, size_t n) noexcept {
+	const auto backslash_x16 = _mm_set1_epi8('\\'), quote_x16 = _mm_set1_epi8('"'), space_x16 = _mm_set1_epi8(0x20);
+	size_t i;
+
+	for (i = 0; n - i >= 16; i += 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+
+		//Signed comparison with space also matches bytes >= 0x80
+		unsigned special_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(fragment, backslash_x16),
+			_mm_cmpeq_epi8(fragment, quote_x16)),
+			_mm_cmplt_epi8(fragment, space_x16)));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + i), fragment);
+		if (special_mask != 0) {
+			return i + __builtin_ctz(special_mask);
+		}
+	}
+	return i + jsop_copy_string_chars_scalar(dest + i, src + i, n - i);
+}
+
+__attribute__((target("sse2")))
+static const char *jsop_skip_string_chars_sse2(const char *start, const char *end) noexcept {
+	const auto backslash_x16 = _mm_set1_epi8('\\'), quote_x16 = _mm_set1_epi8('"'), space_x16 = _mm_set1_epi8(0x20);
+
+	while (static_cast<size_t>(end - start) >= 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+
+		//Signed comparison with space also matches bytes >= 0x80
+		unsigned special_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(fragment, backslash_x16),
+			_mm_cmpeq_epi8(fragment, quote_x16)),
+			_mm_cmplt_epi8(fragment, space_x16)));
+
+		if (special_mask != 0) {
+			return start + __builtin_ctz(special_mask);
+		}
+		start += 16;
+	}
+	return jsop_skip_string_chars_scalar(start, end);
+}
+
+__attribute__((target("sse2")))
+static const char *jsop_skip_string_chars_padded_sse2(const char *start, const char *end) noexcept {
+	const auto backslash_x16 = _mm_set1_epi8('\\'), quote_x16 = _mm_set1_epi8('"'), space_x16 = _mm_set1_epi8(0x20);
+
+	for (; start < end; start += 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+
+		//Signed comparison with space also matches bytes >= 0x80
+		unsigned special_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(fragment, backslash_x16),
+			_mm_cmpeq_epi8(fragment, quote_x16)),
+			_mm_cmplt_epi8(fragment, space_x16)));
+
+		if (special_mask != 0) {
+			start += __builtin_ctz(special_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("sse2")))
+static const char *jsop_skip_whitespace_sse2(const char *start, const char *end) noexcept {
+	const auto space_x16 = _mm_set1_epi8(' '), tab_x16 = _mm_set1_epi8('\t'), line_feed_x16 = _mm_set1_epi8('\n'), carriage_return_x16 = _mm_set1_epi8('\r');
+
+	while (static_cast<size_t>(end - start) >= 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+
+		unsigned whitespace_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(fragment, space_x16),
+			_mm_cmpeq_epi8(fragment, tab_x16)),
+			_mm_or_si128(_mm_cmpeq_epi8(fragment, line_feed_x16),
+			_mm_cmpeq_epi8(fragment, carriage_return_x16))));
+
+		if (whitespace_mask != 0xFFFF) {
+			return start + __builtin_ctz(~whitespace_mask);
+		}
+		start += 16;
+	}
+	return jsop_skip_whitespace_scalar(start, end);
+}
+
+__attribute__((target("sse2")))
+static const char *jsop_skip_whitespace_padded_sse2(const char *start, const char *end) noexcept {
+	const auto space_x16 = _mm_set1_epi8(' '), tab_x16 = _mm_set1_epi8('\t'), line_feed_x16 = _mm_set1_epi8('\n'), carriage_return_x16 = _mm_set1_epi8('\r');
+
+	for (; start < end; start += 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(start));
+
+		unsigned whitespace_mask = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(fragment, space_x16),
+			_mm_cmpeq_epi8(fragment, tab_x16)),
+			_mm_or_si128(_mm_cmpeq_epi8(fragment, line_feed_x16),
+			_mm_cmpeq_epi8(fragment, carriage_return_x16))));
+
+		if (whitespace_mask != 0xFFFF) {
+			start += __builtin_ctz(~whitespace_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("sse2")))
+static void jsop_classify_block_sse2(const char *block, JsopSimdBlockMasks *masks) noexcept {
+	//'[' and '{' (and similarly ']' and '}') only differ by 0x20
+	const auto quote_x16 = _mm_set1_epi8('"'), backslash_x16 = _mm_set1_epi8('\\'), case_x16 = _mm_set1_epi8(0x20),
+		left_brace_x16 = _mm_set1_epi8('{'), right_brace_x16 = _mm_set1_epi8('}'), colon_x16 = _mm_set1_epi8(':'), comma_x16 = _mm_set1_epi8(',');
+	uint64_t quote_mask = 0, backslash_mask = 0, structural_mask = 0;
+
+	for (unsigned i = 0; i < 64; i += 16) {
+		auto fragment = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + i));
+		auto lower_case_fragment = _mm_or_si128(fragment, case_x16);
+
+		quote_mask |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(fragment, quote_x16))) << i;
+		backslash_mask |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(fragment, backslash_x16))) << i;
+		structural_mask |= static_cast<uint64_t>(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(lower_case_fragment, left_brace_x16),
+			_mm_cmpeq_epi8(lower_case_fragment, right_brace_x16)),
+			_mm_or_si128(_mm_cmpeq_epi8(fragment, colon_x16),
+			_mm_cmpeq_epi8(fragment, comma_x16))))) << i;
+	}
+	masks->Quote = quote_mask;
+	masks->Backslash = backslash_mask;
+	masks->Structural = structural_mask;
+}
+
+__attribute__((target("avx2")))
+static size_t jsop_copy_string_chars_avx2(char *dest, const char *src, size_t n) noexcept {
+	const auto backslash_x32 = _mm256_set1_epi8('\\'), quote_x32 = _mm256_set1_epi8('"'), space_x32 = _mm256_set1_epi8(0x20);
+	size_t i;
+
+	for (i = 0; n - i >= 32; i += 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+
+		uint32_t special_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, backslash_x32),
+			_mm256_cmpeq_epi8(fragment, quote_x32)),
+			_mm256_cmpgt_epi8(space_x32, fragment)));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), fragment);
+		if (special_mask != 0) {
+			return i + __builtin_ctz(special_mask);
+		}
+	}
+	return i + jsop_copy_string_chars_sse2(dest + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static const char *jsop_skip_string_chars_avx2(const char *start, const char *end) noexcept {
+	const auto backslash_x32 = _mm256_set1_epi8('\\'), quote_x32 = _mm256_set1_epi8('"'), space_x32 = _mm256_set1_epi8(0x20);
+
+	while (static_cast<size_t>(end - start) >= 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start));
+
+		uint32_t special_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, backslash_x32),
+			_mm256_cmpeq_epi8(fragment, quote_x32)),
+			_mm256_cmpgt_epi8(space_x32, fragment)));
+
+		if (special_mask != 0) {
+			return start + __builtin_ctz(special_mask);
+		}
+		start += 32;
+	}
+	return jsop_skip_string_chars_sse2(start, end);
+}
+
+__attribute__((target("avx2")))
+static const char *jsop_skip_string_chars_padded_avx2(const char *start, const char *end) noexcept {
+	const auto backslash_x32 = _mm256_set1_epi8('\\'), quote_x32 = _mm256_set1_epi8('"'), space_x32 = _mm256_set1_epi8(0x20);
+
+	for (; start < end; start += 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start));
+
+		uint32_t special_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, backslash_x32),
+			_mm256_cmpeq_epi8(fragment, quote_x32)),
+			_mm256_cmpgt_epi8(space_x32, fragment)));
+
+		if (special_mask != 0) {
+			start += __builtin_ctz(special_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("avx2")))
+static const char *jsop_skip_whitespace_avx2(const char *start, const char *end) noexcept {
+	const auto space_x32 = _mm256_set1_epi8(' '), tab_x32 = _mm256_set1_epi8('\t'), line_feed_x32 = _mm256_set1_epi8('\n'), carriage_return_x32 = _mm256_set1_epi8('\r');
+
+	while (static_cast<size_t>(end - start) >= 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start));
+
+		uint32_t whitespace_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, space_x32),
+			_mm256_cmpeq_epi8(fragment, tab_x32)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(fragment, line_feed_x32),
+			_mm256_cmpeq_epi8(fragment, carriage_return_x32))));
+
+		if (whitespace_mask != UINT32_MAX) {
+			return start + __builtin_ctz(~whitespace_mask);
+		}
+		start += 32;
+	}
+	return jsop_skip_whitespace_sse2(start, end);
+}
+
+__attribute__((target("avx2")))
+static const char *jsop_skip_whitespace_padded_avx2(const char *start, const char *end) noexcept {
+	const auto space_x32 = _mm256_set1_epi8(' '), tab_x32 = _mm256_set1_epi8('\t'), line_feed_x32 = _mm256_set1_epi8('\n'), carriage_return_x32 = _mm256_set1_epi8('\r');
+
+	for (; start < end; start += 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(start));
+
+		uint32_t whitespace_mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(fragment, space_x32),
+			_mm256_cmpeq_epi8(fragment, tab_x32)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(fragment, line_feed_x32),
+			_mm256_cmpeq_epi8(fragment, carriage_return_x32))));
+
+		if (whitespace_mask != UINT32_MAX) {
+			start += __builtin_ctz(~whitespace_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("avx2")))
+static void jsop_classify_block_avx2(const char *block, JsopSimdBlockMasks *masks) noexcept {
+	const auto quote_x32 = _mm256_set1_epi8('"'), backslash_x32 = _mm256_set1_epi8('\\'), case_x32 = _mm256_set1_epi8(0x20),
+		left_brace_x32 = _mm256_set1_epi8('{'), right_brace_x32 = _mm256_set1_epi8('}'), colon_x32 = _mm256_set1_epi8(':'), comma_x32 = _mm256_set1_epi8(',');
+	uint64_t quote_mask = 0, backslash_mask = 0, structural_mask = 0;
+
+	for (unsigned i = 0; i < 64; i += 32) {
+		auto fragment = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + i));
+		auto lower_case_fragment = _mm256_or_si256(fragment, case_x32);
+
+		quote_mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(fragment, quote_x32)))) << i;
+		backslash_mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(fragment, backslash_x32)))) << i;
+		structural_mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lower_case_fragment, left_brace_x32),
+			_mm256_cmpeq_epi8(lower_case_fragment, right_brace_x32)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(fragment, colon_x32),
+			_mm256_cmpeq_epi8(fragment, comma_x32)))))) << i;
+	}
+	masks->Quote = quote_mask;
+	masks->Backslash = backslash_mask;
+	masks->Structural = structural_mask;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static size_t jsop_copy_string_chars_avx512bw(char *dest, const char *src, size_t n) noexcept {
+	const auto backslash_x64 = _mm512_set1_epi8('\\'), quote_x64 = _mm512_set1_epi8('"'), space_x64 = _mm512_set1_epi8(0x20);
+	size_t i;
+
+	for (i = 0; n - i >= 64; i += 64) {
+		auto fragment = _mm512_loadu_si512(src + i);
+
+		uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, backslash_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+			_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+		_mm512_storeu_si512(dest + i, fragment);
+		if (special_mask != 0) {
+			return i + __builtin_ctzll(special_mask);
+		}
+	}
+
+	if (i != n) {
+		//Handle the remaining characters with masked loads and stores, where the characters that are not loaded are zero and
+		//therefore treated as special characters
+		uint64_t load_mask = (UINT64_C(1) << (n - i)) - 1;
+		auto fragment = _mm512_maskz_loadu_epi8(load_mask, src + i);
+
+		uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, backslash_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+			_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+		_mm512_mask_storeu_epi8(dest + i, load_mask, fragment);
+		i += __builtin_ctzll(special_mask);
+	}
+	return i;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static const char *jsop_skip_string_chars_avx512bw(const char *start, const char *end) noexcept {
+	const auto backslash_x64 = _mm512_set1_epi8('\\'), quote_x64 = _mm512_set1_epi8('"'), space_x64 = _mm512_set1_epi8(0x20);
+
+	while (static_cast<size_t>(end - start) >= 64) {
+		auto fragment = _mm512_loadu_si512(start);
+
+		uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, backslash_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+			_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+		if (special_mask != 0) {
+			return start + __builtin_ctzll(special_mask);
+		}
+		start += 64;
+	}
+
+	if (start != end) {
+		//The characters that are not loaded are zero and therefore treated as special characters
+		auto fragment = _mm512_maskz_loadu_epi8((UINT64_C(1) << (end - start)) - 1, start);
+
+		uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, backslash_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+			_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+		start += __builtin_ctzll(special_mask);
+	}
+	return start;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static const char *jsop_skip_string_chars_padded_avx512bw(const char *start, const char *end) noexcept {
+	const auto backslash_x64 = _mm512_set1_epi8('\\'), quote_x64 = _mm512_set1_epi8('"'), space_x64 = _mm512_set1_epi8(0x20);
+
+	for (; start < end; start += 64) {
+		auto fragment = _mm512_loadu_si512(start);
+
+		uint64_t special_mask = _mm512_cmpeq_epi8_mask(fragment, backslash_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, quote_x64) |
+			_mm512_cmplt_epi8_mask(fragment, space_x64);
+
+		if (special_mask != 0) {
+			start += __builtin_ctzll(special_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static const char *jsop_skip_whitespace_avx512bw(const char *start, const char *end) noexcept {
+	const auto space_x64 = _mm512_set1_epi8(' '), tab_x64 = _mm512_set1_epi8('\t'), line_feed_x64 = _mm512_set1_epi8('\n'), carriage_return_x64 = _mm512_set1_epi8('\r');
+
+	while (static_cast<size_t>(end - start) >= 64) {
+		auto fragment = _mm512_loadu_si512(start);
+
+		uint64_t whitespace_mask = _mm512_cmpeq_epi8_mask(fragment, space_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, tab_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, line_feed_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, carriage_return_x64);
+
+		if (whitespace_mask != UINT64_MAX) {
+			return start + __builtin_ctzll(~whitespace_mask);
+		}
+		start += 64;
+	}
+	return jsop_skip_whitespace_avx2(start, end);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static const char *jsop_skip_whitespace_padded_avx512bw(const char *start, const char *end) noexcept {
+	const auto space_x64 = _mm512_set1_epi8(' '), tab_x64 = _mm512_set1_epi8('\t'), line_feed_x64 = _mm512_set1_epi8('\n'), carriage_return_x64 = _mm512_set1_epi8('\r');
+
+	for (; start < end; start += 64) {
+		auto fragment = _mm512_loadu_si512(start);
+
+		uint64_t whitespace_mask = _mm512_cmpeq_epi8_mask(fragment, space_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, tab_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, line_feed_x64) |
+			_mm512_cmpeq_epi8_mask(fragment, carriage_return_x64);
+
+		if (whitespace_mask != UINT64_MAX) {
+			start += __builtin_ctzll(~whitespace_mask);
+			return start < end ? start : end;
+		}
+	}
+	return end;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void jsop_classify_block_avx512bw(const char *block, JsopSimdBlockMasks *masks) noexcept {
+	const auto quote_x64 = _mm512_set1_epi8('"'), backslash_x64 = _mm512_set1_epi8('\\'), case_x64 = _mm512_set1_epi8(0x20),
+		left_brace_x64 = _mm512_set1_epi8('{'), right_brace_x64 = _mm512_set1_epi8('}'), colon_x64 = _mm512_set1_epi8(':'), comma_x64 = _mm512_set1_epi8(',');
+
+	auto fragment = _mm512_loadu_si512(block);
+	auto lower_case_fragment = _mm512_or_si512(fragment, case_x64);
+
+	masks->Quote = _mm512_cmpeq_epi8_mask(fragment, quote_x64);
+	masks->Backslash = _mm512_cmpeq_epi8_mask(fragment, backslash_x64);
+	masks->Structural = _mm512_cmpeq_epi8_mask(lower_case_fragment, left_brace_x64) |
+		_mm512_cmpeq_epi8_mask(lower_case_fragment, right_brace_x64) |
+		_mm512_cmpeq_epi8_mask(fragment, colon_x64) |
+		_mm512_cmpeq_epi8_mask(fragment, comma_x64);
+}
+
+//! Gets the highest level of instruction set extensions supported by both the processor and the operating system
+static JsopSimdLevel jsop_simd_get_processor_level() noexcept {
+	unsigned eax, ebx, ecx, edx;
+	JsopSimdLevel level;
+
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (edx & bit_SSE2) == 0) {
+		return JsopSimdLevel::Scalar;
+	}
+	level = JsopSimdLevel::SSE2;
+
+	//AVX2 and AVX-512 also require AVX and the operating system to save the extended registers, which is checked with xgetbv (only
+	//available if OSXSAVE is set), otherwise the vector instructions fault even if leaf 7 reports them
+	if ((ecx & bit_OSXSAVE) != 0 && (ecx & bit_AVX) != 0) {
+		uint32_t xcr0_low, xcr0_high;
+
+		asm ("xgetbv"
+				: "=a" (xcr0_low), "=d" (xcr0_high)
+				: "c" (0)
+				: );
+		//XMM and YMM state
+		if ((xcr0_low & 0x6) == 0x6 && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+			if ((ebx & bit_AVX2) != 0) {
+				level = JsopSimdLevel::AVX2;
+				//Opmask, ZMM_Hi256 and Hi16_ZMM state
+				if ((xcr0_low & 0xE0) == 0xE0 && (ebx & bit_AVX512F) != 0 && (ebx & bit_AVX512BW) != 0) {
+					level = JsopSimdLevel::AVX512BW;
+				}
+			}
+		}
+	}
+	return level;
+}
+
+#endif
+
+JsopSimdFunctions JsopSimd = {
+	jsop_copy_string_chars_scalar,
+	jsop_skip_string_chars_scalar,
+	jsop_skip_string_chars_scalar,
+	jsop_skip_whitespace_scalar,
+	jsop_skip_whitespace_scalar,
+	jsop_classify_block_scalar,
+	JsopSimdLevel::Scalar
+};
+
+void jsop_simd_init(JsopSimdLevel max_level) noexcept {
+#ifdef JSOP_SIMD_X86
+	auto level = jsop_simd_get_processor_level();
+	if (level > max_level) {
+		level = max_level;
+	}
+
+	switch (level) {
+	case JsopSimdLevel::AVX512BW:
+		JsopSimd.CopyStringChars = jsop_copy_string_chars_avx512bw;
+		JsopSimd.SkipStringChars = jsop_skip_string_chars_avx512bw;
+		JsopSimd.SkipStringCharsPadded = jsop_skip_string_chars_padded_avx512bw;
+		JsopSimd.SkipWhitespace = jsop_skip_whitespace_avx512bw;
+		JsopSimd.SkipWhitespacePadded = jsop_skip_whitespace_padded_avx512bw;
+		JsopSimd.ClassifyBlock = jsop_classify_block_avx512bw;
+		break;
+
+	case JsopSimdLevel::AVX2:
+		JsopSimd.CopyStringChars = jsop_copy_string_chars_avx2;
+		JsopSimd.SkipStringChars = jsop_skip_string_chars_avx2;
+		JsopSimd.SkipStringCharsPadded = jsop_skip_string_chars_padded_avx2;
+		JsopSimd.SkipWhitespace = jsop_skip_whitespace_avx2;
+		JsopSimd.SkipWhitespacePadded = jsop_skip_whitespace_padded_avx2;
+		JsopSimd.ClassifyBlock = jsop_classify_block_avx2;
+		break;
+
+	case JsopSimdLevel::SSE2:
+		JsopSimd.CopyStringChars = jsop_copy_string_chars_sse2;
+		JsopSimd.SkipStringChars = jsop_skip_string_chars_sse2;
+		JsopSimd.SkipStringCharsPadded = jsop_skip_string_chars_padded_sse2;
+		JsopSimd.SkipWhitespace = jsop_skip_whitespace_sse2;
+		JsopSimd.SkipWhitespacePadded = jsop_skip_whitespace_padded_sse2;
+		JsopSimd.ClassifyBlock = jsop_classify_block_sse2;
+		break;
+
+	default:
+		JsopSimd.CopyStringChars = jsop_copy_string_chars_scalar;
+		JsopSimd.SkipStringChars = jsop_skip_string_chars_scalar;
+		JsopSimd.SkipStringCharsPadded = jsop_skip_string_chars_scalar;
+		JsopSimd.SkipWhitespace = jsop_skip_whitespace_scalar;
+		JsopSimd.SkipWhitespacePadded = jsop_skip_whitespace_scalar;
+		JsopSimd.ClassifyBlock = jsop_classify_block_scalar;
+		break;
+	}
+	JsopSimd.Level = level;
+#else
+	(void)max_level;
+#endif
+}
+
+#ifdef JSOP_SIMD_X86
+//The functions are statically initialized to the scalar versions, so parsing in other static constructors is still safe
+__attribute__((constructor)) static void jsop_simd_init_at_startup() noexcept {
+	jsop_simd_init();
+}
+#endif
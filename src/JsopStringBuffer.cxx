@@ -8,7 +8,7 @@
 
 char *JsopStringBuffer::resize() noexcept {
 	char *new_start;
-	size_t n, new_capacity;
+	size_t n, new_capacity, size;
 
 	n = AllocEnd - Start;
 	assert(n >= 16);
@@ -16,10 +16,12 @@ char *JsopStringBuffer::resize() noexcept {
 	if (n <= (SIZE_MAX / (2 * sizeof(char)))) {
 		new_capacity = n * 2;
 
-		new_start = static_cast<char *>(realloc(Start, new_capacity * sizeof(char)));
+		//The buffer is not necessarily full when called from resize_if()
+		size = End - Start;
+		new_start = static_cast<char *>(jsop_reallocate(Allocator, Start, n * sizeof(char), new_capacity * sizeof(char)));
 		if (new_start != nullptr) {
 			Start = new_start;
-			End = new_start + n;
+			End = new_start + size;
 			AllocEnd = new_start + new_capacity;
 		}
 		return new_start;
@@ -0,0 +1,136 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "JsopSimd.h"
+#include "JsopStructuralIndex.h"
+
+//! Computes the exclusive or of all the bits up to and including each bit of the given value
+JSOP_INLINE uint64_t jsop_prefix_xor(uint64_t value) noexcept {
+	value ^= value << 1;
+	value ^= value << 2;
+	value ^= value << 4;
+	value ^= value << 8;
+	value ^= value << 16;
+	value ^= value << 32;
+	return value;
+}
+
+uint32_t *JsopStructuralIndex::resize() noexcept {
+	uint32_t *new_start;
+	size_t n, new_capacity, size;
+
+	n = AllocEnd - Start;
+	if (n == 0) {
+		new_capacity = JSOP_STRUCTURAL_INDEX_MIN_SIZE;
+	} else if (n <= (SIZE_MAX / (2 * sizeof(uint32_t)))) {
+		new_capacity = n * 2;
+	} else {
+		return nullptr;
+	}
+
+	size = End - Start;
+	new_start = static_cast<uint32_t *>(jsop_reallocate(Allocator, Start, n * sizeof(uint32_t), new_capacity * sizeof(uint32_t)));
+	if (new_start != nullptr) {
+		Start = new_start;
+		End = new_start + size;
+		AllocEnd = new_start + new_capacity;
+	}
+	return new_start;
+}
+
+bool JsopStructuralIndex::build(const char *start, const char *end, bool padded) noexcept {
+	static_assert(JSOP_STRUCTURAL_INDEX_MIN_SIZE >= 65, "JSOP_STRUCTURAL_INDEX_MIN_SIZE >= 65");
+	static_assert(JSOP_INPUT_PADDING >= 64, "JSOP_INPUT_PADDING >= 64");
+
+	JsopSimdBlockMasks masks;
+	char last_block[64];
+	size_t n, offset;
+	uint64_t escaped, backslash, quote, in_string, structural;
+	uint32_t *index_end;
+	bool escape_carry, in_string_carry;
+
+	End = Start;
+	n = end - start;
+	//The positions and the sentinel are stored as 32-bit integers
+	if (n >= UINT32_MAX) {
+		return false;
+	}
+
+	escape_carry = false;
+	in_string_carry = false;
+	for (offset = 0; offset < n; offset += 64) {
+		//Each block adds at most 64 positions, and there must be room for the sentinel after the last block
+		if (static_cast<size_t>(AllocEnd - End) < 65) {
+			if (resize() == nullptr) {
+				return false;
+			}
+		}
+
+		if (n - offset >= 64) {
+			JsopSimd.ClassifyBlock(start + offset, &masks);
+		} else if (padded) {
+			//Classify the last block directly from the input, and ignore the characters in the padding
+			uint64_t valid_mask = (UINT64_C(1) << (n - offset)) - 1;
+			JsopSimd.ClassifyBlock(start + offset, &masks);
+			masks.Quote &= valid_mask;
+			masks.Backslash &= valid_mask;
+			masks.Structural &= valid_mask;
+		} else {
+			//Pad the last block with NUL characters, which are not classified as anything
+			memset(last_block, 0, sizeof(last_block));
+			memcpy(last_block, start + offset, n - offset);
+			JsopSimd.ClassifyBlock(last_block, &masks);
+		}
+
+		//Find the characters that are escaped by an odd number of backslashes
+		escaped = 0;
+		backslash = masks.Backslash;
+		if (escape_carry) {
+			escaped = 1;
+			backslash &= ~UINT64_C(1);
+		}
+		escape_carry = false;
+		while (backslash != 0) {
+			auto i = jsop_count_trailing_zeros(backslash);
+			if (i == 63) {
+				escape_carry = true;
+				break;
+			}
+			escaped |= UINT64_C(1) << (i + 1);
+			backslash &= ~(UINT64_C(3) << i);
+		}
+
+		quote = masks.Quote & ~escaped;
+		in_string = jsop_prefix_xor(quote);
+		if (in_string_carry) {
+			in_string = ~in_string;
+		}
+		in_string_carry = (in_string >> 63) != 0;
+
+		structural = (masks.Structural & ~in_string) | quote;
+		index_end = End;
+		while (structural != 0) {
+			*index_end = static_cast<uint32_t>(offset + jsop_count_trailing_zeros(structural));
+			++index_end;
+			structural &= structural - 1;
+		}
+		End = index_end;
+	}
+
+	if (in_string_carry) {
+		return false;
+	}
+
+	if (End == AllocEnd) {
+		if (resize() == nullptr) {
+			return false;
+		}
+	}
+	*End = static_cast<uint32_t>(n);
+	++End;
+	return true;
+}
@@ -0,0 +1,223 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "JsopCodePoint.h"
+#include "JsopSimd.h"
+#include "JsopUnescape.h"
+
+//! Parses the hexadecimal digits of a \u escape sequence (after the u), and returns the character after the escape sequence or nullptr if it is not valid
+static const char *jsop_unescape_utf16(const char *start, const char *end, uint32_t *code) noexcept {
+	uint32_t value;
+	unsigned digit;
+
+#ifdef JSOP_PARSE_BRACKET_ESCAPE
+	if (start != end && *start == '{') {
+		++start;
+		if (start == end || (digit = JsopCodePointHexDigitValue[static_cast<unsigned char>(*start)]) >= 16) {
+			return nullptr;
+		}
+		value = digit;
+		for (++start; start != end; ++start) {
+			digit = JsopCodePointHexDigitValue[static_cast<unsigned char>(*start)];
+			if (digit < 16) {
+				value = value * 16 + digit;
+				if (value >= 0x110000) {
+					return nullptr;
+				}
+			} else if (*start == '}') {
+				*code = value;
+				return start + 1;
+			} else {
+				return nullptr;
+			}
+		}
+		return nullptr;
+	}
+#endif
+
+	if (end - start < 4) {
+		return nullptr;
+	}
+	value = 0;
+	for (unsigned i = 0; i < 4; ++i) {
+		digit = JsopCodePointHexDigitValue[static_cast<unsigned char>(start[i])];
+		if (digit >= 16) {
+			return nullptr;
+		}
+		value = value * 16 + digit;
+	}
+	*code = value;
+	return start + 4;
+}
+
+//! Stores the UTF-8 encoding of the given code point, and returns the end of the encoded characters
+JSOP_INLINE char *jsop_unescape_utf32(char *dest, uint32_t code) noexcept {
+	if (code <= 0x7F) {
+		dest[0] = code;
+		return dest + 1;
+	} else if (code <= 0x7FF) {
+		dest[0] = (code >> 6) + 0xC0;
+		dest[1] = (code & 0x3F) + 0x80;
+		return dest + 2;
+	} else if (code <= 0xFFFF) {
+		dest[0] = (code >> 12) + 0xE0;
+		dest[1] = ((code & 0xFFF) >> 6) + 0x80;
+		dest[2] = (code & 0x3F) + 0x80;
+		return dest + 3;
+	} else {
+		assert(code <= 0x10FFFF);
+
+		dest[0] = (code >> 18) + 0xF0;
+		dest[1] = ((code & 0x3FFFF) >> 12) + 0x80;
+		dest[2] = ((code & 0xFFF) >> 6) + 0x80;
+		dest[3] = (code & 0x3F) + 0x80;
+		return dest + 4;
+	}
+}
+
+char *jsop_unescape_string(char *dest, const char *start, const char *end) noexcept {
+	size_t n;
+	uint32_t code, low_surrogate;
+	unsigned char ch;
+
+	for (;;) {
+		//The characters are moved rather than copied with CopyStringChars(), which may store past the first special character and
+		//overwrite characters that have not been read yet when the string is unescaped in place
+		n = JsopSimd.SkipStringChars(start, end) - start;
+		if (dest != start) {
+			memmove(dest, start, n);
+		}
+		dest += n;
+		start += n;
+		if (start == end) {
+			return dest;
+		}
+
+		ch = *start;
+		if (ch == '\\') {
+			if (end - start < 2) {
+				return nullptr;
+			}
+			ch = start[1];
+			start += 2;
+			switch (ch) {
+#ifdef JSOP_PARSE_SINGLE_QUOTE_ESCAPE
+			case '\'':
+#endif
+			case '"':
+			case '\\':
+			case '/':
+				break;
+
+			case 'b':
+				ch = '\b';
+				break;
+
+			case 'f':
+				ch = '\f';
+				break;
+
+			case 'n':
+				ch = '\n';
+				break;
+
+			case 'r':
+				ch = '\r';
+				break;
+
+			case 't':
+				ch = '\t';
+				break;
+
+#ifdef JSOP_PARSE_VERTICAL_TAB_ESCAPE
+			case 'v':
+				ch = '\v';
+				break;
+#endif
+
+			case 'u':
+				start = jsop_unescape_utf16(start, end, &code);
+				if (start == nullptr) {
+					return nullptr;
+				}
+				if (code >= 0xD800 && code < 0xE000) {
+					//A high surrogate must be followed by an escaped low surrogate
+					if (code >= 0xDC00 || end - start < 2 || start[0] != '\\' || start[1] != 'u') {
+						return nullptr;
+					}
+					start = jsop_unescape_utf16(start + 2, end, &low_surrogate);
+					if (start == nullptr || low_surrogate < 0xDC00 || low_surrogate >= 0xE000) {
+						return nullptr;
+					}
+					code = (code - 0xD800) * 1024 + (low_surrogate - 0xDC00) + 0x10000;
+				}
+				dest = jsop_unescape_utf32(dest, code);
+				continue;
+
+			default:
+				return nullptr;
+			}
+			*dest = ch;
+			++dest;
+		} else if (ch >= 0x80) {
+			n = jsop_code_point_utf8_sequence_length(reinterpret_cast<const unsigned char *>(start), reinterpret_cast<const unsigned char *>(end));
+			if (n == 0) {
+				return nullptr;
+			}
+			//Copy one character at a time since the string may be unescaped in place
+			for (size_t i = 0; i < n; ++i) {
+				dest[i] = start[i];
+			}
+			dest += n;
+			start += n;
+		} else {
+			//Control characters and quotes
+			return nullptr;
+		}
+	}
+}
+
+const char *jsop_skip_unescaped_string_chars(const char *start, const char *end, bool padded) noexcept {
+	auto skip_string_chars = !padded ? JsopSimd.SkipStringChars : JsopSimd.SkipStringCharsPadded;
+	size_t n;
+
+	for (;;) {
+		start = skip_string_chars(start, end);
+		if (start == end || static_cast<unsigned char>(*start) < 0x80) {
+			return start;
+		}
+		n = jsop_code_point_utf8_sequence_length(reinterpret_cast<const unsigned char *>(start), reinterpret_cast<const unsigned char *>(end));
+		if (n == 0) {
+			return start;
+		}
+		start += n;
+	}
+}
+
+const char *jsop_find_string_end(const char *start, const char *end, bool padded) noexcept {
+	auto skip_string_chars = !padded ? JsopSimd.SkipStringChars : JsopSimd.SkipStringCharsPadded;
+
+	for (;;) {
+		start = skip_string_chars(start, end);
+		if (start == end) {
+			return nullptr;
+		}
+		if (*start == '"') {
+			return start;
+		} else if (*start == '\\') {
+			//Skip the escaped character, which is checked when the string is unescaped
+			if (end - start < 2) {
+				return nullptr;
+			}
+			start += 2;
+		} else {
+			++start;
+		}
+	}
+}
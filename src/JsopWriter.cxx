@@ -0,0 +1,465 @@
+//This Source Code Form is subject to the terms of the Mozilla Public
+//License, v. 2.0. If a copy of the MPL was not distributed with this
+//file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "JsopDecimal.h"
+#include "JsopSimd.h"
+#include "JsopStack.h"
+#include "JsopWriter.h"
+
+//! The decimal digits of 0 to 99 as pairs of characters
+static const char JsopWriterDigitPairs[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char JsopWriterHexDigits[] = "0123456789ABCDEF";
+
+//! Formats the given integer with the digits ending at dest_end, 2 digits at a time, and returns the first digit
+JSOP_INLINE char *jsop_writer_format_uint64(char *dest_end, uint64_t value) noexcept {
+	auto dest = dest_end;
+	while (value >= 100) {
+		auto i = static_cast<unsigned>(value % 100) * 2;
+		value /= 100;
+		dest -= 2;
+		memcpy(dest, JsopWriterDigitPairs + i, 2);
+	}
+	if (value >= 10) {
+		dest -= 2;
+		memcpy(dest, JsopWriterDigitPairs + static_cast<unsigned>(value) * 2, 2);
+	} else {
+		dest -= 1;
+		*dest = static_cast<char>('0' + value);
+	}
+	return dest;
+}
+
+char *JsopWriter::reserveSlow(size_t n) noexcept {
+	char *new_start;
+	size_t size, new_capacity;
+
+	//Write the buffer to the file instead of resizing it if it is enough
+	if (Fd >= 0 && End != Start) {
+		if (!flush()) {
+			return nullptr;
+		}
+		if (static_cast<size_t>(AllocEnd - End) >= n) {
+			return End;
+		}
+	}
+
+	size = End - Start;
+	new_capacity = AllocEnd - Start;
+	if (new_capacity == 0) {
+		new_capacity = JSOP_WRITER_BUFFER_MIN_SIZE;
+	}
+	while (new_capacity - size < n) {
+		if (new_capacity > SIZE_MAX / 2) {
+			return nullptr;
+		}
+		new_capacity *= 2;
+	}
+
+	new_start = static_cast<char *>(jsop_reallocate(Allocator, Start, AllocEnd - Start, new_capacity));
+	if (new_start != nullptr) {
+		Start = new_start;
+		End = new_start + size;
+		AllocEnd = new_start + new_capacity;
+		return End;
+	}
+	return nullptr;
+}
+
+bool JsopWriter::push(const JsopValue *next, const JsopValue *end, bool object) noexcept {
+	if (JSOP_UNLIKELY(StackEnd == StackAllocEnd) && !jsop_stack_grow(Allocator, &StackStart, &StackEnd, &StackAllocEnd, JSOP_WRITER_STACK_MIN_SIZE)) {
+		return false;
+	}
+	StackEnd->Next = next;
+	StackEnd->End = end;
+	StackEnd->Object = object;
+	++StackEnd;
+	return true;
+}
+
+static_assert(JSOP_WRITER_BUFFER_MIN_SIZE > 6, "JSOP_WRITER_BUFFER_MIN_SIZE > 6");
+
+bool JsopWriter::writeString(const char *start, const char *end) noexcept {
+	size_t n;
+
+	if (!append('"')) {
+		return false;
+	}
+	while (start != end) {
+		//Each step copies a run of characters followed by at most one escape sequence of up to 6 characters into the room left in the
+		//buffer, which is only written to the file or resized once it is nearly full, so long strings do not grow the buffer of a file
+		n = end - start;
+		auto dest = End;
+		if (static_cast<size_t>(AllocEnd - dest) < n + 6) {
+			if (AllocEnd - dest > 6) {
+				n = AllocEnd - dest - 6;
+			} else {
+				if (n > JSOP_WRITER_BUFFER_MIN_SIZE - 6) {
+					n = JSOP_WRITER_BUFFER_MIN_SIZE - 6;
+				}
+				dest = reserveSlow(n + 6);
+				if (dest == nullptr) {
+					return false;
+				}
+			}
+		}
+		auto chunk_end = start + n;
+
+		n = JsopSimd.CopyStringChars(dest, start, chunk_end - start);
+		dest += n;
+		start += n;
+		if (start == chunk_end) {
+			End = dest;
+			continue;
+		}
+
+		unsigned char ch = *start;
+		++start;
+		if (ch >= 0x80) {
+			//Multi-byte UTF-8 sequences are copied unchanged
+			*dest = ch;
+			++dest;
+			while (start != chunk_end && static_cast<unsigned char>(*start) >= 0x80) {
+				*dest = *start;
+				++dest;
+				++start;
+			}
+			End = dest;
+			continue;
+		}
+
+		dest[0] = '\\';
+		switch (ch) {
+		case '"':
+		case '\\':
+			dest[1] = ch;
+			dest += 2;
+			break;
+
+		case '\b':
+			dest[1] = 'b';
+			dest += 2;
+			break;
+
+		case '\f':
+			dest[1] = 'f';
+			dest += 2;
+			break;
+
+		case '\n':
+			dest[1] = 'n';
+			dest += 2;
+			break;
+
+		case '\r':
+			dest[1] = 'r';
+			dest += 2;
+			break;
+
+		case '\t':
+			dest[1] = 't';
+			dest += 2;
+			break;
+
+		default:
+			//Other control characters
+			dest[1] = 'u';
+			dest[2] = '0';
+			dest[3] = '0';
+			dest[4] = JsopWriterHexDigits[ch >> 4];
+			dest[5] = JsopWriterHexDigits[ch & 0xF];
+			dest += 6;
+			break;
+		}
+		End = dest;
+	}
+	return append('"');
+}
+
+bool JsopWriter::writeInteger(uint64_t value, bool negative) noexcept {
+	char digits[20];
+
+	auto dest = reserve(sizeof(digits) + 1);
+	if (dest != nullptr) {
+		*dest = '-';
+		dest += negative;
+		auto digits_start = jsop_writer_format_uint64(digits + sizeof(digits), value);
+		size_t n = digits + sizeof(digits) - digits_start;
+		memcpy(dest, digits_start, n);
+		End = dest + n;
+		return true;
+	}
+	return false;
+}
+
+bool JsopWriter::writeDouble(double value) noexcept {
+	char digits[20];
+	int exponent, point;
+	size_t n;
+
+	if (!isfinite(value)) {
+		auto dest = reserve(4);
+		if (dest != nullptr) {
+			memcpy(dest, "null", 4);
+			End = dest + 4;
+			return true;
+		}
+		return false;
+	}
+
+	//The longest forms are 17 digits with a point and an exponent of 3 digits, or 21 digits followed by ".0"
+	auto dest = reserve(sizeof(digits) + 8);
+	if (dest == nullptr) {
+		return false;
+	}
+
+	*dest = '-';
+	dest += signbit(value) != 0;
+
+	//Write the shortest digits that are read back as the same number
+	auto digits_start = jsop_writer_format_uint64(digits + sizeof(digits), jsop_double_to_decimal(value, &exponent));
+	n = digits + sizeof(digits) - digits_start;
+	point = static_cast<int>(n) + exponent;
+
+	if (exponent >= 0 && point <= 21) {
+		//Integers are followed by a fractional part, so they are read back as double precision numbers instead of integers
+		memcpy(dest, digits_start, n);
+		dest += n;
+		memset(dest, '0', exponent);
+		dest += exponent;
+		dest[0] = '.';
+		dest[1] = '0';
+		End = dest + 2;
+	} else if (point > 0 && point <= 21) {
+		memcpy(dest, digits_start, point);
+		dest += point;
+		*dest = '.';
+		memcpy(dest + 1, digits_start + point, n - point);
+		End = dest + 1 + (n - point);
+	} else if (point > -6 && point <= 0) {
+		dest[0] = '0';
+		dest[1] = '.';
+		dest += 2;
+		memset(dest, '0', -point);
+		dest += -point;
+		memcpy(dest, digits_start, n);
+		End = dest + n;
+	} else {
+		//Use an exponent with a single digit before the point otherwise
+		*dest = digits_start[0];
+		++dest;
+		if (n > 1) {
+			*dest = '.';
+			memcpy(dest + 1, digits_start + 1, n - 1);
+			dest += n;
+		}
+		exponent = point - 1;
+		dest[0] = 'e';
+		dest[1] = '-';
+		dest += 1 + (exponent < 0);
+		auto exponent_digits_start = jsop_writer_format_uint64(digits + sizeof(digits),
+			exponent < 0 ? -static_cast<unsigned>(exponent) : static_cast<unsigned>(exponent));
+		n = digits + sizeof(digits) - exponent_digits_start;
+		memcpy(dest, exponent_digits_start, n);
+		End = dest + n;
+	}
+	return true;
+}
+
+bool JsopWriter::writeDecimal(uint64_t significand, int exponent, bool negative) noexcept {
+	char digits[20];
+	char exponent_digits[10];
+
+	auto dest = reserve(sizeof(digits) + sizeof(exponent_digits) + 3);
+	if (dest != nullptr) {
+		//The significand and exponent are written as they were read, which is exact and avoids converting them to a double
+		//precision number
+		*dest = '-';
+		dest += negative;
+		auto digits_start = jsop_writer_format_uint64(digits + sizeof(digits), significand);
+		size_t n = digits + sizeof(digits) - digits_start;
+		memcpy(dest, digits_start, n);
+		dest += n;
+
+		*dest = 'e';
+		dest[1] = '-';
+		dest += 1 + (exponent < 0);
+		auto exponent_digits_start = jsop_writer_format_uint64(exponent_digits + sizeof(exponent_digits),
+			exponent < 0 ? -static_cast<uint64_t>(exponent) : static_cast<uint64_t>(exponent));
+		n = exponent_digits + sizeof(exponent_digits) - exponent_digits_start;
+		memcpy(dest, exponent_digits_start, n);
+		End = dest + n;
+		return true;
+	}
+	return false;
+}
+
+bool JsopWriter::write(const JsopValue &value) noexcept {
+	const JsopValue *current;
+	const JsopValue *values;
+	char *dest;
+	size_t n;
+	bool ok;
+
+	current = &value;
+	StackEnd = StackStart;
+	for (;;) {
+		switch (current->getType()) {
+		case JsopValue::NullType:
+			dest = reserve(4);
+			if (dest != nullptr) {
+				memcpy(dest, "null", 4);
+				End = dest + 4;
+			}
+			ok = dest != nullptr;
+			break;
+
+		case JsopValue::BoolType:
+			dest = reserve(5);
+			if (dest != nullptr) {
+				if (current->getBool()) {
+					memcpy(dest, "true", 4);
+					End = dest + 4;
+				} else {
+					memcpy(dest, "false", 5);
+					End = dest + 5;
+				}
+			}
+			ok = dest != nullptr;
+			break;
+
+		case JsopValue::Int32Type:
+		case JsopValue::Int64Type: {
+			auto integer = current->toInt64();
+			ok = writeInteger(integer < 0 ? -static_cast<uint64_t>(integer) : static_cast<uint64_t>(integer), integer < 0);
+			break;
+		}
+
+		case JsopValue::Uint32Type:
+		case JsopValue::Uint64Type:
+			ok = writeInteger(current->toUint64(), false);
+			break;
+
+		case JsopValue::DoubleType:
+			ok = writeDouble(current->getDouble());
+			break;
+
+		case JsopValue::DecimalType:
+			ok = writeDecimal(current->getDecimalSignificand(), current->getDecimalExponent(), current->getDecimalNegative());
+			break;
+
+		case JsopValue::SmallStringType:
+		case JsopValue::StringType:
+		case JsopValue::BorrowedStringType: {
+			auto view = current->getStringView();
+			ok = writeString(view.begin(), view.end());
+			break;
+		}
+
+		case JsopValue::ArrayType:
+			n = current->size();
+			if (n != 0) {
+				values = current->getValues();
+				if (!append('[') || !push(values + 1, values + n, false)) {
+					return false;
+				}
+				current = values;
+				continue;
+			}
+			dest = reserve(2);
+			if (dest != nullptr) {
+				dest[0] = '[';
+				dest[1] = ']';
+				End = dest + 2;
+			}
+			ok = dest != nullptr;
+			break;
+
+		case JsopValue::ObjectType:
+		case JsopValue::SortedObjectType:
+		case JsopValue::IndexedObjectType:
+			n = current->size();
+			if (n != 0) {
+				//The keys and values of an object are stored as consecutive values
+				values = current->getValues();
+				if (!append('{') || !push(values + 1, values + n * 2, true)) {
+					return false;
+				}
+				current = values;
+				continue;
+			}
+			dest = reserve(2);
+			if (dest != nullptr) {
+				dest[0] = '{';
+				dest[1] = '}';
+				End = dest + 2;
+			}
+			ok = dest != nullptr;
+			break;
+
+		default:
+			ok = false;
+			break;
+		}
+		if (!ok) {
+			return false;
+		}
+
+		//Move to the next value, closing the arrays and objects that have no values left
+		for (;;) {
+			if (StackEnd == StackStart) {
+				return true;
+			}
+			auto context = StackEnd - 1;
+			if (context->Next != context->End) {
+				//An odd number of values left in an object means that the next one is the value of a key
+				if (!append(context->Object && ((context->End - context->Next) & 1) != 0 ? ':' : ',')) {
+					return false;
+				}
+				current = context->Next;
+				context->Next = current + 1;
+				break;
+			}
+			if (!append(context->Object ? '}' : ']')) {
+				return false;
+			}
+			StackEnd = context;
+		}
+	}
+}
+
+bool JsopWriter::flush() noexcept {
+	if (Fd >= 0) {
+		auto start = Start;
+		while (start != End) {
+			auto n = ::write(Fd, start, End - start);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			start += n;
+		}
+		End = Start;
+	}
+	return true;
+}